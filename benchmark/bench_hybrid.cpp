@@ -81,7 +81,6 @@ static void BM_Hybrid_ModExp(benchmark::State& state) {
   ipcl::setHybridOff();
 
   int64_t dsize = state.range(0);
-  float qat_ratio = state.range(1) * 0.01;  // scale it back
 
   BigNumber n = P_BN * Q_BN;
   int n_length = n.BitSize();
@@ -106,6 +105,7 @@ static void BM_Hybrid_ModExp(benchmark::State& state) {
   std::vector<BigNumber> res(dsize);
 
 #if BENCH_HYBRID_DETAIL
+  float qat_ratio = state.range(1) * 0.01;  // scale it back
   ipcl::setHybridRatio(qat_ratio);
 #else
   ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
@@ -121,7 +121,6 @@ static void BM_Hybrid_Encrypt(benchmark::State& state) {
   ipcl::setHybridOff();
 
   int64_t dsize = state.range(0);
-  float qat_ratio = state.range(1) * 0.01;  // scale it back
 
   BigNumber n = P_BN * Q_BN;
   int n_length = n.BitSize();
@@ -139,6 +138,7 @@ static void BM_Hybrid_Encrypt(benchmark::State& state) {
   ipcl::CipherText ct;
 
 #if BENCH_HYBRID_DETAIL
+  float qat_ratio = state.range(1) * 0.01;  // scale it back
   ipcl::setHybridRatio(qat_ratio);
 #else
   ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
@@ -154,7 +154,6 @@ static void BM_Hybrid_Decrypt(benchmark::State& state) {
   ipcl::setHybridOff();
 
   int64_t dsize = state.range(0);
-  float qat_ratio = state.range(1) * 0.01;  // scale it back
 
   BigNumber n = P_BN * Q_BN;
   int n_length = n.BitSize();
@@ -173,6 +172,7 @@ static void BM_Hybrid_Decrypt(benchmark::State& state) {
   ipcl::CipherText ct = pk.encrypt(pt);
 
 #if BENCH_HYBRID_DETAIL
+  float qat_ratio = state.range(1) * 0.01;  // scale it back
   ipcl::setHybridRatio(qat_ratio);
 #else
   ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
@@ -188,7 +188,6 @@ static void BM_Hybrid_MulCTPT(benchmark::State& state) {
   ipcl::setHybridOff();
 
   int64_t dsize = state.range(0);
-  float qat_ratio = state.range(1) * 0.01;  // scale it back
 
   BigNumber n = P_BN * Q_BN;
   int n_length = n.BitSize();
@@ -212,6 +211,7 @@ static void BM_Hybrid_MulCTPT(benchmark::State& state) {
   ipcl::CipherText product;
 
 #if BENCH_HYBRID_DETAIL
+  float qat_ratio = state.range(1) * 0.01;  // scale it back
   ipcl::setHybridRatio(qat_ratio);
 #else
   ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
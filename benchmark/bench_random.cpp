@@ -0,0 +1,106 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "ipcl/ipcl.hpp"
+
+// Random bits per value, the sizes drawn by obfuscation and key generation
+#define ADD_SAMPLE_RANDOM_BITS_ARGS Args({1024})->Args({2048})->Args({4096})
+
+constexpr int RANDOM_BATCH_SIZE = 1024;
+
+static void setRandomThroughput(benchmark::State& state, int bits) {
+  state.SetBytesProcessed(state.iterations() * RANDOM_BATCH_SIZE * bits / 8);
+}
+
+static void BM_Random_RDSEED(benchmark::State& state) {
+  int bits = state.range(0);
+  std::vector<Ipp32u> buf(BITSIZE_WORD(bits));
+  for (auto _ : state) {
+    for (int i = 0; i < RANDOM_BATCH_SIZE; i++) {
+      if (ippsTRNGenRDSEED(buf.data(), bits, nullptr) != ippStsNoErr) {
+        state.SkipWithError("RDSEED failed");
+        return;
+      }
+    }
+  }
+  setRandomThroughput(state, bits);
+}
+BENCHMARK(BM_Random_RDSEED)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_RANDOM_BITS_ARGS;
+
+static void BM_Random_RDRAND(benchmark::State& state) {
+  int bits = state.range(0);
+  std::vector<Ipp32u> buf(BITSIZE_WORD(bits));
+  for (auto _ : state) {
+    for (int i = 0; i < RANDOM_BATCH_SIZE; i++) {
+      if (ippsPRNGenRDRAND(buf.data(), bits, nullptr) != ippStsNoErr) {
+        state.SkipWithError("RDRAND failed");
+        return;
+      }
+    }
+  }
+  setRandomThroughput(state, bits);
+}
+BENCHMARK(BM_Random_RDRAND)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_RANDOM_BITS_ARGS;
+
+static void BM_Random_IPP_PRNG(benchmark::State& state) {
+  int bits = state.range(0);
+  constexpr int seed_size = 160;
+  int size;
+  ippsPRNGGetSize(&size);
+  std::vector<Ipp8u> prng(size);
+  auto ctx = reinterpret_cast<IppsPRNGState*>(prng.data());
+  ippsPRNGInit(seed_size, ctx);
+  std::vector<Ipp32u> seed(BITSIZE_WORD(seed_size));
+  ipcl::rand32u(seed);
+  BigNumber seed_bn(seed.data(), seed.size(), IppsBigNumPOS);
+  ippsPRNGSetSeed(BN(seed_bn), ctx);
+
+  std::vector<Ipp32u> buf(BITSIZE_WORD(bits));
+  for (auto _ : state) {
+    for (int i = 0; i < RANDOM_BATCH_SIZE; i++)
+      ippsPRNGen(buf.data(), bits, ctx);
+  }
+  setRandomThroughput(state, bits);
+}
+BENCHMARK(BM_Random_IPP_PRNG)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_RANDOM_BITS_ARGS;
+
+static void BM_Random_AES_CTR(benchmark::State& state) {
+  if (!ipcl::AesCtrDrbg::isSupported()) {
+    state.SkipWithError("AES-NI is not supported");
+    return;
+  }
+  int bits = state.range(0);
+  ipcl::AesCtrDrbg& drbg = ipcl::getThreadDrbg();
+  std::vector<Ipp32u> buf(BITSIZE_WORD(bits));
+  for (auto _ : state) {
+    for (int i = 0; i < RANDOM_BATCH_SIZE; i++)
+      drbg.generate(buf.data(), buf.size() * sizeof(Ipp32u));
+  }
+  setRandomThroughput(state, bits);
+}
+BENCHMARK(BM_Random_AES_CTR)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_RANDOM_BITS_ARGS;
+
+// The generator selected at build time, through the bulk API
+static void BM_Random_getRandomBNs(benchmark::State& state) {
+  int bits = state.range(0);
+  for (auto _ : state) {
+    std::vector<BigNumber> r = ipcl::getRandomBNs(RANDOM_BATCH_SIZE, bits);
+    benchmark::DoNotOptimize(r.data());
+  }
+  setRandomThroughput(state, bits);
+}
+BENCHMARK(BM_Random_getRandomBNs)
+    ->Unit(benchmark::kMicrosecond)
+    ->ADD_SAMPLE_RANDOM_BITS_ARGS;
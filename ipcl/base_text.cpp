@@ -3,6 +3,8 @@
 
 #include "ipcl/base_text.hpp"
 
+#include <utility>
+
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -21,10 +23,14 @@ BaseText::BaseText(const BigNumber& bn) : m_texts{bn}, m_size(1) {}
 BaseText::BaseText(const std::vector<BigNumber>& bn_v)
     : m_texts(bn_v), m_size(m_texts.size()) {}
 
-BaseText::BaseText(const BaseText& bt) {
-  this->m_texts = bt.getTexts();
-  this->m_size = bt.getSize();
-}
+BaseText::BaseText(std::vector<BigNumber>&& bn_v)
+    : m_texts(std::move(bn_v)), m_size(m_texts.size()) {}
+
+BaseText::BaseText(const BigNumberView& bn_view)
+    : m_texts(bn_view.toVector()), m_size(m_texts.size()) {}
+
+BaseText::BaseText(const BaseText& bt)
+    : m_texts(bt.m_texts), m_size(bt.m_size) {}
 
 BaseText& BaseText::operator=(const BaseText& other) {
   if (this == &other) return *this;
@@ -99,6 +105,17 @@ std::vector<BigNumber> BaseText::getChunk(const std::size_t& start,
   return v;
 }
 
+BigNumberView BaseText::getView() const { return BigNumberView(m_texts); }
+
+BigNumberView BaseText::getView(const std::size_t& start,
+                                const std::size_t& size,
+                                const std::size_t& stride) const {
+  ERROR_CHECK(stride > 0 && (size == 0 || start + (size - 1) * stride < m_size),
+              "BaseText: getView parameter is incorrect");
+
+  return BigNumberView(m_texts.data(), start, size, stride);
+}
+
 std::vector<BigNumber> BaseText::getTexts() const { return m_texts; }
 
 std::size_t BaseText::getSize() const { return m_size; }
@@ -16,9 +16,21 @@
 
 #include "ipcl/bignum.h"
 
+#include <cstdint>
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "ipcl/utils/util.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -26,14 +38,115 @@
 //
 //////////////////////////////////////////////////////////////////////
 
-BigNumber::~BigNumber() { delete[](Ipp8u*) m_pBN; }
+//
+// storage of IppsBigNumState buffers
+//
+
+// Bin: Buffers are rounded to size classes and cached per thread, so the
+// temporaries of arithmetic expressions rarely reach the system allocator.
+// A buffer freed by another thread than the one allocating it simply moves
+// to the cache of the freeing thread.
+static const std::size_t PoolGranularity = 64;
+static const std::size_t PoolMaxBytes = 16 * 1024;
+static const std::size_t PoolClasses = PoolMaxBytes / PoolGranularity;
+static const std::size_t PoolMaxCached = 64;
+
+namespace {
+
+struct PoolCache {
+  std::vector<void*> free[PoolClasses];
+  ~PoolCache();
+};
+
+thread_local PoolCache g_pool;
+thread_local bool g_pool_destroyed = false;
+
+PoolCache::~PoolCache() {
+  for (auto& list : free)
+    for (void* p : list) ::operator delete(p);
+  g_pool_destroyed = true;
+}
+
+void* poolAllocate(std::size_t bytes) {
+  if (bytes > PoolMaxBytes || g_pool_destroyed)
+    return ::operator new(bytes);
+  std::size_t cls = (bytes - 1) / PoolGranularity;
+  auto& list = g_pool.free[cls];
+  if (list.empty()) return ::operator new((cls + 1) * PoolGranularity);
+  void* p = list.back();
+  list.pop_back();
+  return p;
+}
+
+void poolDeallocate(void* p, std::size_t bytes) {
+  if (bytes > PoolMaxBytes || g_pool_destroyed) {
+    ::operator delete(p);
+    return;
+  }
+  auto& list = g_pool.free[(bytes - 1) / PoolGranularity];
+  if (list.size() < PoolMaxCached)
+    list.push_back(p);
+  else
+    ::operator delete(p);
+}
+
+const BigNumber::Allocator g_pool_allocator = {poolAllocate, poolDeallocate};
+std::atomic<const BigNumber::Allocator*> g_allocator{&g_pool_allocator};
+
+// Bin: Every buffer records the allocator it came from, so the allocator
+// can be changed while BigNumbers are alive
+struct alignas(16) StateHeader {
+  const BigNumber::Allocator* alloc;
+  std::size_t bytes;
+};
+
+IppsBigNumState* allocState(int size) {
+  const BigNumber::Allocator* alloc = g_allocator.load();
+  std::size_t bytes = sizeof(StateHeader) + size;
+  auto header = static_cast<StateHeader*>(alloc->allocate(bytes));
+  if (!header) return nullptr;
+  header->alloc = alloc;
+  header->bytes = bytes;
+  return reinterpret_cast<IppsBigNumState*>(header + 1);
+}
+
+void freeState(IppsBigNumState* pBN) {
+  if (!pBN) return;
+  auto header = reinterpret_cast<StateHeader*>(pBN) - 1;
+  header->alloc->deallocate(header, header->bytes);
+}
+
+// Bin: Round the room up, so that buffers of similar lengths share a size
+// class and assignments can reuse the destination storage
+int roundRoom(int length) {
+  if (length <= 1) return 1;
+  if (length <= 16) {
+    int room = 1;
+    while (room < length) room <<= 1;
+    return room;
+  }
+  return (length + 15) & ~15;
+}
+
+}  // namespace
+
+void BigNumber::SetAllocator(const Allocator* alloc) {
+  g_allocator.store(alloc ? alloc : &g_pool_allocator);
+}
+
+const BigNumber::Allocator* BigNumber::GetAllocator() {
+  return g_allocator.load();
+}
+
+BigNumber::~BigNumber() { freeState(m_pBN); }
 
 bool BigNumber::create(const Ipp32u* pData, int length, IppsBigNumSGN sgn) {
+  int room = roundRoom(length);
   int size;
-  ippsBigNumGetSize(length, &size);
-  m_pBN = (IppsBigNumState*)(new Ipp8u[size]);
+  ippsBigNumGetSize(room, &size);
+  m_pBN = allocState(size);
   if (!m_pBN) return false;
-  ippsBigNumInit(length, m_pBN);
+  ippsBigNumInit(room, m_pBN);
   if (pData) ippsSet_BN(sgn, length, pData, m_pBN);
   return true;
 }
@@ -64,32 +177,25 @@ BigNumber::BigNumber(const Ipp32u* pData, int length, IppsBigNumSGN sgn) {
 // Bin: Following GMP lower case
 static char HexDigitList[] = "0123456789abcdef";
 
-BigNumber::BigNumber(const char* s) {
-  bool neg = '-' == s[0];
-  if (neg) s++;
-  bool hex = ('0' == s[0]) && (('x' == s[1]) || ('X' == s[1]));
+// Bin: Decimal digits processed per 32-bit limb operation
+static const int DecDigitsPerWord = 9;
+static const Ipp32u DecWordBase = 1000000000u;
 
-  int dataLen;
-  Ipp32u base;
-  if (hex) {
-    s += 2;
-    base = 0x10;
-    dataLen = (int)(strlen(s) + 7) / 8;
-  } else {
-    base = 10;
-    dataLen = (int)(strlen(s) + 9) / 10;
-  }
-
-  create(0, dataLen);
-  *(this) = Zero();
-  while (*s) {
-    char tmp[2] = {s[0], 0};
-    Ipp32u digit = (Ipp32u)strcspn(HexDigitList, tmp);
-    *this = (*this) * base + BigNumber(digit);
-    s++;
-  }
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
 
-  if (neg) (*this) = Zero() - (*this);
+// Bin: Delegates to the zero constructor, so that the storage is released
+// when a malformed string throws
+BigNumber::BigNumber(const char* s) : BigNumber(Ipp32u(0)) {
+  int len = (int)strlen(s);
+  const char* digits = ('-' == s[0]) ? s + 1 : s;
+  bool hex = ('0' == digits[0]) && (('x' == digits[1]) || ('X' == digits[1]));
+  bool ok = hex ? fromHex(*this, s, len) : fromDec(*this, s, len);
+  ERROR_CHECK(ok, std::string("BigNumber: malformed number string ") + s);
 }
 
 BigNumber::BigNumber(const BigNumber& bn) {
@@ -101,6 +207,20 @@ BigNumber::BigNumber(const BigNumber& bn) {
   create(bnData, BITSIZE_WORD(bnBitLen), bnSgn);
 }
 
+// Bin: The storage is transferred and the moved-from BigNumber is left
+// without storage, which reads as zero
+BigNumber::BigNumber(BigNumber&& bn) noexcept : m_pBN(bn.m_pBN) {
+  bn.m_pBN = nullptr;
+}
+
+// Bin: Gives a moved-from BigNumber a zero when it is used again
+IppsBigNumState* BigNumber::createZero() const {
+  const Ipp32u zero = 0;
+  ERROR_CHECK(const_cast<BigNumber*>(this)->create(&zero, 1, IppsBigNumPOS),
+              "BigNumber: failed to allocate storage");
+  return m_pBN;
+}
+
 //
 // set value
 //
@@ -109,6 +229,20 @@ void BigNumber::Set(const Ipp32u* pData, int length,
   ippsSet_BN(sgn, length, pData, BN(*this));
 }
 
+void BigNumber::Assign(const Ipp32u* pData, int length, IppsBigNumSGN sgn) {
+  while (length > 1 && 0 == pData[length - 1]) length--;
+  if (1 == length && 0 == pData[0]) sgn = IppsBigNumPOS;
+
+  int room = 0;
+  if (m_pBN) ippsGetSize_BN(m_pBN, &room);
+  if (length <= room) {
+    ippsSet_BN(sgn, length, pData, m_pBN);
+  } else {
+    freeState(m_pBN);
+    create(pData, length, sgn);
+  }
+}
+
 //
 // constants
 //
@@ -137,8 +271,17 @@ BigNumber& BigNumber::operator=(const BigNumber& bn) {
     Ipp32u* bnData;
     ippsRef_BN(&bnSgn, &bnBitLen, &bnData, bn);
 
-    delete[](Ipp8u*) m_pBN;
-    create(bnData, BITSIZE_WORD(bnBitLen), bnSgn);
+    // reuses the current storage when it is large enough
+    Assign(bnData, BITSIZE_WORD(bnBitLen), bnSgn);
+  }
+  return *this;
+}
+
+BigNumber& BigNumber::operator=(BigNumber&& bn) noexcept {
+  if (this != &bn) {
+    freeState(m_pBN);
+    m_pBN = bn.m_pBN;
+    bn.m_pBN = nullptr;
   }
   return *this;
 }
@@ -152,7 +295,7 @@ BigNumber& BigNumber::operator+=(const BigNumber& bn) {
 
   BigNumber result(0, BITSIZE_WORD(rBitLen));
   ippsAdd_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
@@ -165,7 +308,7 @@ BigNumber& BigNumber::operator+=(Ipp32u n) {
   BigNumber result(0, BITSIZE_WORD(rBitLen));
   BigNumber bn(n);
   ippsAdd_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
@@ -178,7 +321,7 @@ BigNumber& BigNumber::operator-=(const BigNumber& bn) {
 
   BigNumber result(0, BITSIZE_WORD(rBitLen));
   ippsSub_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
@@ -191,7 +334,7 @@ BigNumber& BigNumber::operator-=(Ipp32u n) {
   BigNumber result(0, BITSIZE_WORD(rBitLen));
   BigNumber bn(n);
   ippsSub_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
@@ -204,7 +347,7 @@ BigNumber& BigNumber::operator*=(const BigNumber& bn) {
 
   BigNumber result(0, BITSIZE_WORD(rBitLen));
   ippsMul_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
@@ -216,14 +359,24 @@ BigNumber& BigNumber::operator*=(Ipp32u n) {
   BigNumber result(0, BITSIZE_WORD(aBitLen + 32));
   BigNumber bn(n);
   ippsMul_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
+// Bin: ippsMod_BN and ippsDiv_BN normalize the divisor in place while they
+// run, and ippsModInv_BN and ippsGcd_BN may work on their operands in place,
+// so an operand shared between threads (e.g. a key modulus) would be
+// corrupted. They are given per-thread copies instead, one per slot.
+static IppsBigNumState* privateCopy(const BigNumber& bn, int slot = 0) {
+  static thread_local BigNumber copies[2];
+  copies[slot] = bn;  // reuses the storage of the previous copy
+  return BN(copies[slot]);
+}
+
 BigNumber& BigNumber::operator%=(const BigNumber& bn) {
   BigNumber remainder(bn);
-  ippsMod_BN(BN(*this), BN(bn), BN(remainder));
-  *this = remainder;
+  ippsMod_BN(BN(*this), privateCopy(bn), BN(remainder));
+  *this = std::move(remainder);
   return *this;
 }
 
@@ -235,15 +388,15 @@ BigNumber& BigNumber::operator%=(Ipp32u n) {
   BigNumber result(0, BITSIZE_WORD(aBitLen));
   BigNumber bn(n);
   ippsMod_BN(*this, bn, result);
-  *this = result;
+  *this = std::move(result);
   return *this;
 }
 
 BigNumber& BigNumber::operator/=(const BigNumber& bn) {
   BigNumber quotient(*this);
   BigNumber remainder(bn);
-  ippsDiv_BN(BN(*this), BN(bn), BN(quotient), BN(remainder));
-  *this = quotient;
+  ippsDiv_BN(BN(*this), privateCopy(bn), BN(quotient), BN(remainder));
+  *this = std::move(quotient);
   return *this;
 }
 
@@ -253,57 +406,65 @@ BigNumber& BigNumber::operator/=(Ipp32u n) {
   BigNumber bn(n);
   BigNumber remainder(bn);
   ippsDiv_BN(BN(*this), BN(bn), BN(quotient), BN(remainder));
-  *this = quotient;
+  *this = std::move(quotient);
   return *this;
 }
 
 BigNumber operator+(const BigNumber& a, const BigNumber& b) {
   BigNumber r(a);
-  return r += b;
+  r += b;
+  return r;
 }
 
 // Bin: Support integer add
 BigNumber operator+(const BigNumber& a, Ipp32u n) {
   BigNumber r(a);
-  return r += n;
+  r += n;
+  return r;
 }
 
 BigNumber operator-(const BigNumber& a, const BigNumber& b) {
   BigNumber r(a);
-  return r -= b;
+  r -= b;
+  return r;
 }
 
 // Bin: Support integer sub
 BigNumber operator-(const BigNumber& a, Ipp32u n) {
   BigNumber r(a);
-  return r -= n;
+  r -= n;
+  return r;
 }
 
 BigNumber operator*(const BigNumber& a, const BigNumber& b) {
   BigNumber r(a);
-  return r *= b;
+  r *= b;
+  return r;
 }
 
 // Bin: Support integer mul
 BigNumber operator*(const BigNumber& a, Ipp32u n) {
   BigNumber r(a);
-  return r *= n;
+  r *= n;
+  return r;
 }
 
 BigNumber operator/(const BigNumber& a, const BigNumber& b) {
   BigNumber q(a);
-  return q /= b;
+  q /= b;
+  return q;
 }
 
 // Bin: Support integer div
 BigNumber operator/(const BigNumber& a, Ipp32u n) {
   BigNumber q(a);
-  return q /= n;
+  q /= n;
+  return q;
 }
 
 BigNumber operator%(const BigNumber& a, const BigNumber& b) {
   BigNumber r(b);
-  ippsMod_BN(BN(a), BN(b), BN(r));
+  ippsMod_BN(BN(a), privateCopy(b), BN(r));
   return r;
 }
 
@@ -330,7 +491,7 @@ BigNumber BigNumber::InverseAdd(const BigNumber& a) const {
 
 BigNumber BigNumber::InverseMul(const BigNumber& a) const {
   BigNumber r(*this);
-  ippsModInv_BN(BN(a), BN(*this), BN(r));
+  ippsModInv_BN(privateCopy(a, 0), privateCopy(*this, 1), BN(r));
   return r;
 }
 
@@ -352,7 +513,7 @@ BigNumber BigNumber::ModMul(const BigNumber& a, const BigNumber& b) const {
 BigNumber BigNumber::gcd(const BigNumber& q) const {
   BigNumber gcd(*this);
 
-  ippsGcd_BN(BN(*this), BN(q), BN(gcd));
+  ippsGcd_BN(privateCopy(*this, 0), privateCopy(q, 1), BN(gcd));
 
   return gcd;
 }
@@ -463,8 +624,7 @@ void BigNumber::num2vec(std::vector<Ipp32u>& v) const {
   ippsRef_BN(nullptr, &bnBitLen, &bnData, *this);
 
   int len = BITSIZE_WORD(bnBitLen);
-  ;
-  for (int n = 0; n < len; n++) v.push_back(bnData[n]);
+  v.insert(v.end(), bnData, bnData + len);
 }
 
 void BigNumber::num2hex(std::string& s) const {
@@ -475,6 +635,7 @@ void BigNumber::num2hex(std::string& s) const {
 
   int len = BITSIZE_WORD(bnBitLen);
 
+  s.reserve(s.size() + len * 8 + 3);
   if (bnSgn == ippBigNumNEG) s.append(1, '-');
   s.append(1, '0');
   s.append(1, 'x');
@@ -493,6 +654,43 @@ void BigNumber::num2hex(std::string& s) const {
   }
 }
 
+void BigNumber::num2dec(std::string& s) const {
+  IppsBigNumSGN bnSgn;
+  int bnBitLen;
+  Ipp32u* bnData;
+  ippsRef_BN(&bnSgn, &bnBitLen, &bnData, *this);
+
+  // Bin: Split into base 10^9 groups by repeated in-place division
+  static thread_local std::vector<Ipp32u> words;
+  static thread_local std::vector<Ipp32u> groups;
+  int len = BITSIZE_WORD(bnBitLen);
+  words.assign(bnData, bnData + len);
+  groups.clear();
+  while (len > 0 && 0 == words[len - 1]) len--;
+  while (len > 0) {
+    std::uint64_t rem = 0;
+    for (int n = len - 1; n >= 0; n--) {
+      std::uint64_t cur = (rem << 32) | words[n];
+      words[n] = (Ipp32u)(cur / DecWordBase);
+      rem = cur % DecWordBase;
+    }
+    groups.push_back((Ipp32u)rem);
+    while (len > 0 && 0 == words[len - 1]) len--;
+  }
+  if (groups.empty()) groups.push_back(0);
+
+  s.reserve(s.size() + groups.size() * DecDigitsPerWord + 1);
+  if (bnSgn == ippBigNumNEG && (groups.size() > 1 || groups[0] != 0))
+    s.append(1, '-');
+  char buf[DecDigitsPerWord + 1];
+  snprintf(buf, sizeof(buf), "%u", groups.back());
+  s.append(buf);
+  for (int n = (int)groups.size() - 2; n >= 0; n--) {
+    snprintf(buf, sizeof(buf), "%09u", groups[n]);
+    s.append(buf);
+  }
+}
+
 std::ostream& operator<<(std::ostream& os, const BigNumber& a) {
   std::string s;
   a.num2hex(s);
@@ -508,17 +706,66 @@ void BigNumber::num2char(std::vector<Ipp8u>& dest) const {
   dest.assign(bnData, bnData + len);
 }
 
+//
+// byte order reversal between BigNumber limbs and QAT buffers
+//
+
+// dst[k] = src[len - 1 - k], 8 bytes per bswap
+static void reverseCopyScalar(const Ipp8u* src, int len, Ipp8u* dst) {
+  int k = 0;
+  for (; k + 8 <= len; k += 8) {
+    std::uint64_t v;
+    memcpy(&v, src + len - 8 - k, 8);
+    v = __builtin_bswap64(v);
+    memcpy(dst + k, &v, 8);
+  }
+  for (; k < len; k++) dst[k] = src[len - 1 - k];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// dst[k] = src[len - 1 - k], 16 bytes per pshufb
+__attribute__((target("ssse3"))) static void reverseCopySSSE3(const Ipp8u* src,
+                                                              int len,
+                                                              Ipp8u* dst) {
+  const __m128i reverse =
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  int k = 0;
+  for (; k + 16 <= len; k += 16) {
+    __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + len - 16 - k));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k),
+                     _mm_shuffle_epi8(v, reverse));
+  }
+  reverseCopyScalar(src, len - k, dst + k);
+}
+
+static const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+#endif
+
+static void reverseCopy(const Ipp8u* src, int len, Ipp8u* dst) {
+#if defined(__x86_64__) || defined(__i386__)
+  if (has_ssse3) return reverseCopySSSE3(src, len, dst);
+#endif
+  reverseCopyScalar(src, len, dst);
+}
+
 bool BigNumber::fromBin(BigNumber& bn, const unsigned char* data, int len) {
   if (len <= 0) return false;
 
-  // Create BigNumber containg input data passed as argument
-  bn = BigNumber(reinterpret_cast<const Ipp32u*>(data), (len / 4));
-  Ipp32u* ref_bn_data_ = NULL;
-  ippsRef_BN(NULL, NULL, &ref_bn_data_, BN(bn));
-
-  // Convert it to little endian format
-  unsigned char* data_ = reinterpret_cast<unsigned char*>(ref_bn_data_);
-  for (int i = 0; i < len; i++) data_[i] = data[len - 1 - i];
+  // Reverse the input straight into the storage of bn, which only grows
+  // when it is too small
+  int words = (len + 3) / 4;
+  int room = 0;
+  if (bn.m_pBN) ippsGetSize_BN(bn.m_pBN, &room);
+  if (room < words) {
+    freeState(bn.m_pBN);
+    if (!bn.create(nullptr, words)) return false;
+  }
+  Ipp32u* bnData;
+  ippsRef_BN(nullptr, nullptr, &bnData, bn.m_pBN);
+  bnData[words - 1] = 0;
+  reverseCopy(data, len, reinterpret_cast<Ipp8u*>(bnData));
+  ippsSet_BN(IppsBigNumPOS, words, bnData, bn.m_pBN);
 
   return true;
 }
@@ -531,10 +778,12 @@ bool BigNumber::toBin(unsigned char* data, int len, const BigNumber& bn) {
   Ipp32u* ref_bn_data_ = NULL;
   ippsRef_BN(NULL, &bitSize, &ref_bn_data_, BN(bn));
 
-  // Revert it to big endian format
-  int bitSizeLen = BITSIZE_WORD(bitSize) * 4;
-  unsigned char* data_ = reinterpret_cast<unsigned char*>(ref_bn_data_);
-  for (int i = 0; i < bitSizeLen; i++) data[len - 1 - i] = data_[i];
+  // Revert it to big endian format, zero padded to len bytes
+  int byteSize = (bitSize + 7) >> 3;
+  if (byteSize > len) return false;
+  memset(data, 0, len - byteSize);
+  reverseCopy(reinterpret_cast<const Ipp8u*>(ref_bn_data_), byteSize,
+              data + len - byteSize);
 
   return true;
 }
@@ -556,10 +805,70 @@ bool BigNumber::toBin(unsigned char** bin, int* len, const BigNumber& bn) {
   memset(bin[0], 0, *len);
   if (NULL == bin[0]) return false;
 
-  unsigned char* data_out = bin[0];
-  unsigned char* bn_data_ = reinterpret_cast<unsigned char*>(ref_bn_data_);
-  for (int i = 0; i < bitSizeLen; i++)
-    data_out[bitSizeLen - 1 - i] = bn_data_[i];
+  reverseCopy(reinterpret_cast<const Ipp8u*>(ref_bn_data_), bitSizeLen,
+              bin[0]);
+
+  return true;
+}
+
+bool BigNumber::fromHex(BigNumber& bn, const char* s, int len) {
+  IppsBigNumSGN sgn = IppsBigNumPOS;
+  if (len > 0 && '-' == s[0]) {
+    sgn = IppsBigNumNEG;
+    s++;
+    len--;
+  }
+  if (len >= 2 && '0' == s[0] && ('x' == s[1] || 'X' == s[1])) {
+    s += 2;
+    len -= 2;
+  }
+  if (len <= 0) return false;
+
+  // Bin: Place every digit straight into its limb, least significant first
+  static thread_local std::vector<Ipp32u> words;
+  words.assign((len + 7) / 8, 0);
+  for (int i = 0; i < len; i++) {
+    int digit = hexValue(s[len - 1 - i]);
+    if (digit < 0) return false;
+    words[i / 8] |= (Ipp32u)digit << (4 * (i % 8));
+  }
+  bn.Assign(words.data(), (int)words.size(), sgn);
+  return true;
+}
 
+bool BigNumber::fromDec(BigNumber& bn, const char* s, int len) {
+  IppsBigNumSGN sgn = IppsBigNumPOS;
+  if (len > 0 && '-' == s[0]) {
+    sgn = IppsBigNumNEG;
+    s++;
+    len--;
+  }
+  if (len <= 0) return false;
+
+  // Bin: Accumulate groups of 9 digits with an in-place limb multiply-add,
+  // so that no temporary BigNumber is created per digit
+  static thread_local std::vector<Ipp32u> words;
+  words.assign(len / DecDigitsPerWord + 2, 0);
+  int used = 0;
+  int group = len % DecDigitsPerWord;
+  if (0 == group) group = DecDigitsPerWord;
+  for (int pos = 0; pos < len; pos += group, group = DecDigitsPerWord) {
+    Ipp32u value = 0;
+    Ipp32u scale = 1;
+    for (int i = pos; i < pos + group; i++) {
+      if (s[i] < '0' || s[i] > '9') return false;
+      value = value * 10 + (Ipp32u)(s[i] - '0');
+      scale *= 10;
+    }
+    std::uint64_t carry = value;
+    for (int n = 0; n < used; n++) {
+      std::uint64_t cur = (std::uint64_t)words[n] * scale + carry;
+      words[n] = (Ipp32u)cur;
+      carry = cur >> 32;
+    }
+    if (carry) words[used++] = (Ipp32u)carry;
+  }
+  if (0 == used) used = 1;
+  bn.Assign(words.data(), used, sgn);
   return true;
 }
@@ -0,0 +1,189 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/bignum_io.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/thread_pool.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+// Copy value bytes into little-endian byte order
+static void toLittleEndian(const unsigned char* in, std::size_t bytes,
+                           ByteOrder order, unsigned char* out) {
+  if (order == ByteOrder::LITTLE)
+    std::memcpy(out, in, bytes);
+  else
+    std::reverse_copy(in, in + bytes, out);
+}
+
+void importBytes(const void* src, std::size_t elem_bytes, std::size_t count,
+                 ByteOrder order, BigNumber* dst) {
+  ERROR_CHECK(elem_bytes > 0, "importBytes: value size must be positive");
+  auto bytes = static_cast<const unsigned char*>(src);
+  std::size_t words = BITSIZE_WORD(elem_bytes * 8);
+
+  parallelFor(
+      count,
+      [&](std::size_t i) {
+        static thread_local std::vector<Ipp32u> limbs;
+        limbs.assign(words, 0);
+        // assemble the limbs from bytes, independent of the host byte order
+        const unsigned char* in = bytes + i * elem_bytes;
+        for (std::size_t j = 0; j < elem_bytes; j++) {
+          std::size_t k = (order == ByteOrder::LITTLE) ? j : elem_bytes - 1 - j;
+          limbs[j / 4] |= static_cast<Ipp32u>(in[k]) << (8 * (j % 4));
+        }
+        dst[i].Assign(limbs.data(), static_cast<int>(words));
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+std::vector<BigNumber> importBytes(const void* src, std::size_t elem_bytes,
+                                   std::size_t count, ByteOrder order) {
+  std::vector<BigNumber> res(count);
+  importBytes(src, elem_bytes, count, order, res.data());
+  return res;
+}
+
+void importBytesRaw(const void* src, std::size_t elem_bytes, std::size_t count,
+                    ByteOrder order, std::size_t width, Ipp32u* dst) {
+  ERROR_CHECK(elem_bytes > 0 && elem_bytes <= width * sizeof(Ipp32u),
+              "importBytesRaw: value size does not fit in the raw width");
+  auto bytes = static_cast<const unsigned char*>(src);
+  auto out = reinterpret_cast<unsigned char*>(dst);
+  std::size_t out_bytes = width * sizeof(Ipp32u);
+
+  // the raw format is little-endian, so this is a plain byte copy
+  parallelFor(
+      count,
+      [&](std::size_t i) {
+        unsigned char* o = out + i * out_bytes;
+        toLittleEndian(bytes + i * elem_bytes, elem_bytes, order, o);
+        std::memset(o + elem_bytes, 0, out_bytes - elem_bytes);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+void exportBytes(const BigNumberView& src, std::size_t elem_bytes,
+                 ByteOrder order, void* dst) {
+  auto out = static_cast<unsigned char*>(dst);
+
+  parallelFor(
+      src.size(),
+      [&](std::size_t i) {
+        IppsBigNumSGN sgn;
+        int bits;
+        Ipp32u* data;
+        ippsRef_BN(&sgn, &bits, &data, src[i]);
+        std::size_t len = (bits + 7) >> 3;
+        ERROR_CHECK(sgn == IppsBigNumPOS && len <= elem_bytes,
+                    "exportBytes: value does not fit in the value size");
+
+        unsigned char* o = out + i * elem_bytes;
+        for (std::size_t j = 0; j < elem_bytes; j++) {
+          unsigned char b = 0;
+          if (j < len)
+            b = static_cast<unsigned char>(data[j / 4] >> (8 * (j % 4)));
+          o[(order == ByteOrder::LITTLE) ? j : elem_bytes - 1 - j] = b;
+        }
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+void exportBigEndian(const BigNumberView& src, int len,
+                     unsigned char* const* dst) {
+  std::size_t size = src.size();
+  if (size == 0) return;
+
+  bool ok = BigNumber::toBin(dst[0], len, src[0]);
+  ERROR_CHECK(ok, "exportBigEndian: value does not fit in the buffer");
+  if (src.getStride() == 0) {
+    // the same value everywhere, e.g. a shared modulus
+    parallelFor(
+        size - 1, [&](std::size_t i) { std::memcpy(dst[i + 1], dst[0], len); },
+        IPCL_PARALLEL_GRAIN_SIZE);
+    return;
+  }
+  parallelFor(
+      size - 1,
+      [&](std::size_t i) {
+        bool ok = BigNumber::toBin(dst[i + 1], len, src[i + 1]);
+        ERROR_CHECK(ok, "exportBigEndian: value does not fit in the buffer");
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+void importBigEndian(const unsigned char* const* src, int len,
+                     std::size_t count, BigNumber* dst) {
+  parallelFor(
+      count,
+      [&](std::size_t i) {
+        bool ok = BigNumber::fromBin(dst[i], src[i], len);
+        ERROR_CHECK(ok, "importBigEndian: invalid buffer size");
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+void importHex(const std::vector<std::string>& src, BigNumber* dst) {
+  parallelFor(
+      src.size(),
+      [&](std::size_t i) {
+        bool ok = BigNumber::fromHex(dst[i], src[i].data(),
+                                     static_cast<int>(src[i].size()));
+        ERROR_CHECK(ok, "importHex: invalid hex string at index " +
+                            std::to_string(i));
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+std::vector<BigNumber> importHex(const std::vector<std::string>& src) {
+  std::vector<BigNumber> res(src.size());
+  importHex(src, res.data());
+  return res;
+}
+
+void importDecimal(const std::vector<std::string>& src, BigNumber* dst) {
+  parallelFor(
+      src.size(),
+      [&](std::size_t i) {
+        bool ok = BigNumber::fromDec(dst[i], src[i].data(),
+                                     static_cast<int>(src[i].size()));
+        ERROR_CHECK(ok, "importDecimal: invalid decimal string at index " +
+                            std::to_string(i));
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+std::vector<BigNumber> importDecimal(const std::vector<std::string>& src) {
+  std::vector<BigNumber> res(src.size());
+  importDecimal(src, res.data());
+  return res;
+}
+
+std::vector<std::string> exportHex(const BigNumberView& src) {
+  std::vector<std::string> res(src.size());
+  parallelFor(
+      src.size(),
+      [&](std::size_t i) {
+        src[i].num2hex(res[i]);
+        if (res[i].back() == 'x') res[i].push_back('0');
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+  return res;
+}
+
+std::vector<std::string> exportDecimal(const BigNumberView& src) {
+  std::vector<std::string> res(src.size());
+  parallelFor(
+      src.size(), [&](std::size_t i) { src[i].num2dec(res[i]); },
+      IPCL_PARALLEL_GRAIN_SIZE);
+  return res;
+}
+
+}  // namespace ipcl
@@ -0,0 +1,79 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/bignum_view.hpp"
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+const BigNumber& BigNumberView::at(std::size_t idx) const {
+  ERROR_CHECK(idx < m_length, "BigNumberView: at index is out of range");
+  return (*this)[idx];
+}
+
+BigNumberView BigNumberView::slice(std::size_t start, std::size_t size,
+                                   std::size_t stride) const {
+  ERROR_CHECK(stride > 0, "BigNumberView: slice stride must be positive");
+  ERROR_CHECK(size == 0 || start + (size - 1) * stride < m_length,
+              "BigNumberView: slice parameter is out of range");
+  BigNumberView view(*this);
+  view.m_length = size;
+  if (size == 0) {
+    view.m_rotation = view.m_period = 0;
+    return view;
+  }
+
+  std::size_t first = (start + m_rotation) % m_period;
+  if (first + (size - 1) * stride < m_period) {
+    // No wraparound: a plain strided view
+    view.m_offset = m_offset + first * m_stride;
+    view.m_stride = m_stride * stride;
+    view.m_rotation = 0;
+    view.m_period = size;
+  } else if (stride == 1) {
+    // Wraps around within the same period
+    view.m_rotation = first;
+  } else if (m_period % stride == 0) {
+    // Every stride-th element of the period, starting at first % stride
+    view.m_offset = m_offset + (first % stride) * m_stride;
+    view.m_stride = m_stride * stride;
+    view.m_rotation = first / stride;
+    view.m_period = m_period / stride;
+  } else {
+    std::vector<BigNumber> v(size);
+    for (std::size_t i = 0; i < size; i++) v[i] = (*this)[start + i * stride];
+    return BigNumberView::own(std::move(v));
+  }
+  return view;
+}
+
+BigNumberView BigNumberView::rotate(int shift) const {
+  if (m_length == 0) return *this;
+  if (m_period != m_length) return own(toVector()).rotate(shift);
+
+  long long n = static_cast<long long>(m_length);  // NOLINT [runtime/int]
+  long long r = (static_cast<long long>(m_rotation) - shift) % n;  // NOLINT
+  if (r < 0) r += n;
+  BigNumberView view(*this);
+  view.m_rotation = static_cast<std::size_t>(r);
+  return view;
+}
+
+BigNumberView BigNumberView::own(std::vector<BigNumber>&& v) {
+  auto owned = std::make_shared<const std::vector<BigNumber>>(std::move(v));
+  BigNumberView view(*owned);
+  view.m_owned = std::move(owned);
+  return view;
+}
+
+std::vector<BigNumber> BigNumberView::toVector() const {
+  if (isContiguous()) return std::vector<BigNumber>(data(), data() + m_length);
+
+  std::vector<BigNumber> v;
+  v.reserve(m_length);
+  for (std::size_t i = 0; i < m_length; i++) v.push_back((*this)[i]);
+  return v;
+}
+
+}  // namespace ipcl
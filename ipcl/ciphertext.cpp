@@ -4,8 +4,11 @@
 #include "ipcl/ciphertext.hpp"
 
 #include <algorithm>
+#include <utility>
 
+#include "ipcl/fixed_bignum.hpp"
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 
 namespace ipcl {
 CipherText::CipherText(const PublicKey& pk, const uint32_t& n)
@@ -20,6 +23,9 @@ CipherText::CipherText(const PublicKey& pk, const BigNumber& bn)
 CipherText::CipherText(const PublicKey& pk, const std::vector<BigNumber>& bn_v)
     : BaseText(bn_v), m_pk(std::make_shared<PublicKey>(pk)) {}
 
+CipherText::CipherText(const PublicKey& pk, std::vector<BigNumber>&& bn_v)
+    : BaseText(std::move(bn_v)), m_pk(std::make_shared<PublicKey>(pk)) {}
+
 CipherText::CipherText(const CipherText& ct) : BaseText(ct) {
   this->m_pk = ct.m_pk;
 }
@@ -31,134 +37,158 @@ CipherText& CipherText::operator=(const CipherText& other) {
   return *this;
 }
 
+CipherText::CipherText(const CipherTextView& ct_view)
+    : BaseText(ct_view.getView()), m_pk(ct_view.getPubKey()) {}
+
 // CT+CT
 CipherText CipherText::operator+(const CipherText& other) const {
+  return CipherTextView(*this) + CipherTextView(other);
+}
+
+// CT + PT
+CipherText CipherText::operator+(const PlainText& other) const {
+  return CipherTextView(*this) + PlainTextView(other);
+}
+
+// CT * PT
+CipherText CipherText::operator*(const PlainText& other) const {
+  return CipherTextView(*this) * PlainTextView(other);
+}
+
+// CT + CTV
+CipherText CipherText::operator+(const CipherTextView& other) const {
+  return CipherTextView(*this) + other;
+}
+
+// CT + PTV
+CipherText CipherText::operator+(const PlainTextView& other) const {
+  return CipherTextView(*this) + other;
+}
+
+// CT * PTV
+CipherText CipherText::operator*(const PlainTextView& other) const {
+  return CipherTextView(*this) * other;
+}
+
+CipherText CipherText::getCipherText(const size_t& idx) const {
+  ERROR_CHECK((idx >= 0) && (idx < m_size),
+              "CipherText::getCipherText index is out of range");
+
+  return CipherText(*m_pk, m_texts[idx]);
+}
+
+std::shared_ptr<PublicKey> CipherText::getPubKey() const { return m_pk; }
+
+CipherText CipherText::rotate(int shift) const {
+  ERROR_CHECK(m_size != 1, "rotate: Cannot rotate single CipherText");
+  int size = static_cast<int>(m_size);
+  ERROR_CHECK(shift >= -size && shift <= size,
+              "rotate: Cannot shift more than the test size");
+
+  if (shift == 0 || shift == size || shift == -size)
+    return CipherText(*m_pk, m_texts);
+
+  return CipherText(CipherTextView(*this).rotate(shift));
+}
+
+CipherTextView::CipherTextView(const CipherText& ct)
+    : m_view(ct.getView()), m_pk(ct.getPubKey()) {}
+
+CipherTextView::CipherTextView(const CipherText& ct, std::size_t start,
+                               std::size_t size, std::size_t stride)
+    : m_view(ct.getView(start, size, stride)), m_pk(ct.getPubKey()) {}
+
+CipherTextView CipherTextView::slice(std::size_t start, std::size_t size,
+                                     std::size_t stride) const {
+  return CipherTextView(m_pk, m_view.slice(start, size, stride));
+}
+
+CipherTextView CipherTextView::rotate(int shift) const {
+  return CipherTextView(m_pk, m_view.rotate(shift));
+}
+
+// CTV+CTV
+CipherText CipherTextView::operator+(const CipherTextView& other) const {
+  std::size_t a_size = getSize();
   std::size_t b_size = other.getSize();
-  ERROR_CHECK(this->m_size == b_size || b_size == 1,
+  ERROR_CHECK(a_size == b_size || b_size == 1,
               "CT + CT error: Size mismatch!");
   ERROR_CHECK(*(m_pk->getN()) == *(other.m_pk->getN()),
               "CT + CT error: 2 different public keys detected!");
 
-  const auto& a = *this;
-  const auto& b = other;
+  const auto& a = m_view;
+  const auto& b = other.m_view;
 
-  if (m_size == 1) {
-    BigNumber sum = a.raw_add(a.m_texts.front(), b.getTexts().front());
+  if (a_size == 1) {
+    BigNumber sum = raw_add(a.front(), b.front());
     return CipherText(*m_pk, sum);
   } else {
-    std::vector<BigNumber> sum(m_size);
+    const BigNumber& sq = *(m_pk->getNSQ());
+    std::vector<BigNumber> sum;
 
     if (b_size == 1) {
-// add vector by scalar
-#ifdef IPCL_USE_OMP
-      int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
-#endif  // IPCL_USE_OMP
-      for (std::size_t i = 0; i < m_size; i++)
-        sum[i] = a.raw_add(a.m_texts[i], b.m_texts[0]);
+      // add vector by scalar
+      sum = modMul(a, BigNumberView::broadcast(b.front(), a_size), sq);
     } else {
-// add vector by vector
-#ifdef IPCL_USE_OMP
-      int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, m_size))
-#endif  // IPCL_USE_OMP
-      for (std::size_t i = 0; i < m_size; i++)
-        sum[i] = a.raw_add(a.m_texts[i], b.m_texts[i]);
+      // add vector by vector
+      sum = modMul(a, b, sq);
     }
-    return CipherText(*m_pk, sum);
+    return CipherText(*m_pk, std::move(sum));
   }
 }
 
-// CT + PT
-CipherText CipherText::operator+(const PlainText& other) const {
+// CTV + PTV
+CipherText CipherTextView::operator+(const PlainTextView& other) const {
   // convert PT to CT
   CipherText b = this->m_pk->encrypt(other, false);
   // calculate CT + CT
-  return this->operator+(b);
+  return this->operator+(CipherTextView(b));
 }
 
-// CT * PT
-CipherText CipherText::operator*(const PlainText& other) const {
+// CTV * PTV
+CipherText CipherTextView::operator*(const PlainTextView& other) const {
+  std::size_t a_size = getSize();
   std::size_t b_size = other.getSize();
-  ERROR_CHECK(this->m_size == b_size || b_size == 1,
+  ERROR_CHECK(a_size == b_size || b_size == 1,
               "CT * PT error: Size mismatch!");
 
-  const auto& a = *this;
-  const auto& b = other;
+  const auto& a = m_view;
+  const auto& b = other.getView();
 
-  if (m_size == 1) {
-    BigNumber product = a.raw_mul(a.m_texts.front(), b.getTexts().front());
+  if (a_size == 1) {
+    BigNumber product = raw_mul(a.front(), b.front());
     return CipherText(*m_pk, product);
   } else {
     std::vector<BigNumber> product;
     if (b_size == 1) {
       // multiply vector by scalar
-      std::vector<BigNumber> b_v(a.m_size, b.getElement(0));
-      product = a.raw_mul(a.m_texts, b_v);
+      product = raw_mul(a, BigNumberView::broadcast(b.front(), a_size));
     } else {
       // multiply vector by vector
-      product = a.raw_mul(a.m_texts, b.getTexts());
+      product = raw_mul(a, b);
     }
     return CipherText(*m_pk, product);
   }
 }
 
-CipherText CipherText::getCipherText(const size_t& idx) const {
-  ERROR_CHECK((idx >= 0) && (idx < m_size),
-              "CipherText::getCipherText index is out of range");
-
-  return CipherText(*m_pk, m_texts[idx]);
-}
-
-std::shared_ptr<PublicKey> CipherText::getPubKey() const { return m_pk; }
-
-CipherText CipherText::rotate(int shift) const {
-  ERROR_CHECK(m_size != 1, "rotate: Cannot rotate single CipherText");
-  ERROR_CHECK(shift >= (-1) * static_cast<int>(m_size) && shift <= m_size,
-              "rotate: Cannot shift more than the test size");
-
-  if (shift == 0 || shift == m_size || shift == (-1) * static_cast<int>(m_size))
-    return CipherText(*m_pk, m_texts);
-
-  if (shift > 0)
-    shift = m_size - shift;
-  else
-    shift = -shift;
-
-  std::vector<BigNumber> new_bn = getTexts();
-  std::rotate(std::begin(new_bn), std::begin(new_bn) + shift, std::end(new_bn));
-  return CipherText(*m_pk, new_bn);
-}
-
-BigNumber CipherText::raw_add(const BigNumber& a, const BigNumber& b) const {
-  // Hold a copy of nsquare for multi-threaded
-  // The BigNumber % operator is not thread safe
-  // const BigNumber& sq = *(m_pk->getNSQ());
-  const BigNumber sq = *(m_pk->getNSQ());
+BigNumber CipherTextView::raw_add(const BigNumber& a,
+                                  const BigNumber& b) const {
+  const BigNumber& sq = *(m_pk->getNSQ());
   return a * b % sq;
 }
 
-BigNumber CipherText::raw_mul(const BigNumber& a, const BigNumber& b) const {
+BigNumber CipherTextView::raw_mul(const BigNumber& a,
+                                  const BigNumber& b) const {
   const BigNumber& sq = *(m_pk->getNSQ());
   return modExp(a, b, sq);
 }
 
-std::vector<BigNumber> CipherText::raw_mul(
-    const std::vector<BigNumber>& a, const std::vector<BigNumber>& b) const {
-  std::size_t v_size = a.size();
-  std::vector<BigNumber> sq(v_size, *(m_pk->getNSQ()));
-
-  // If hybrid OPTIMAL mode is used, use a special ratio
-  if (isHybridOptimal()) {
-    float qat_ratio = (v_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
-                          ? IPCL_HYBRID_MODEXP_RATIO_FULL
-                          : IPCL_HYBRID_MODEXP_RATIO_MULTIPLY;
-    setHybridRatio(qat_ratio, false);
-  }
+std::vector<BigNumber> CipherTextView::raw_mul(const BigNumberView& a,
+                                               const BigNumberView& b) const {
+  // If hybrid OPTIMAL mode is used, use the split tuned for multiplication
+  HybridOpScope hybrid_scope(HybridOp::MULTIPLY);
 
-  return modExp(a, b, sq);
+  return modExp(a, b, *(m_pk->getNSQ()));
 }
 
 }  // namespace ipcl
@@ -0,0 +1,223 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/ciphertext_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ipcl/utils/thread_pool.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+CipherTextStore::~CipherTextStore() { release(); }
+
+CipherTextStore::CipherTextStore(CipherTextStore&& other) noexcept {
+  *this = std::move(other);
+}
+
+CipherTextStore& CipherTextStore::operator=(CipherTextStore&& other) noexcept {
+  if (this == &other) return *this;
+  release();
+  m_map = other.m_map;
+  m_map_size = other.m_map_size;
+  m_data = other.m_data;
+  m_count = other.m_count;
+  m_width = other.m_width;
+  m_writable = other.m_writable;
+  m_pk = std::move(other.m_pk);
+  other.m_map = nullptr;
+  other.m_map_size = 0;
+  other.m_data = nullptr;
+  other.m_count = 0;
+  return *this;
+}
+
+void CipherTextStore::release() {
+  if (m_map != nullptr) munmap(m_map, m_map_size);
+  m_map = nullptr;
+  m_data = nullptr;
+}
+
+CipherTextStore CipherTextStore::map(int fd, std::size_t file_size,
+                                     const PublicKey& pk, bool writable) {
+  void* addr = MAP_FAILED;
+  if (file_size >= IPCL_RAW_HEADER_SIZE)
+    addr = mmap(nullptr, file_size,
+                writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd,
+                0);
+  close(fd);
+  ERROR_CHECK(addr != MAP_FAILED, "CipherTextStore: failed to map the file");
+
+  CipherTextStore st;
+  st.m_map = addr;
+  st.m_map_size = file_size;
+  st.m_writable = writable;
+  st.m_pk = std::make_shared<PublicKey>(pk);
+
+  // st owns the mapping from here, so a failed check unmaps it
+  auto bytes = static_cast<unsigned char*>(addr);
+  RawHeader header = decodeRawHeader(bytes);
+  ERROR_CHECK(header.fingerprint == pk.getFingerprint(),
+              "CipherTextStore: file was encrypted with another key");
+  ERROR_CHECK(header.width == getRawWidth(pk),
+              "CipherTextStore: value width does not match the key");
+  ERROR_CHECK((file_size - IPCL_RAW_HEADER_SIZE) / sizeof(Ipp32u) /
+                      header.width >=
+                  header.count,
+              "CipherTextStore: file is truncated");
+
+  st.m_data = reinterpret_cast<Ipp32u*>(bytes + IPCL_RAW_HEADER_SIZE);
+  st.m_count = header.count;
+  st.m_width = header.width;
+  madvise(addr, file_size, MADV_SEQUENTIAL);
+  return st;
+}
+
+CipherTextStore CipherTextStore::open(const std::string& fn,
+                                      const PublicKey& pk, bool writable) {
+  int fd = ::open(fn.c_str(), writable ? O_RDWR : O_RDONLY);
+  ERROR_CHECK(fd >= 0, "CipherTextStore: cannot open " + fn);
+
+  struct stat sb;
+  if (fstat(fd, &sb) != 0) {
+    close(fd);
+    ERROR_CHECK(false, "CipherTextStore: cannot stat " + fn);
+  }
+  return map(fd, sb.st_size, pk, writable);
+}
+
+CipherTextStore CipherTextStore::create(const std::string& fn,
+                                        const PublicKey& pk,
+                                        std::size_t count) {
+  RawHeader header;
+  header.version = IPCL_RAW_FORMAT_VERSION;
+  header.width = getRawWidth(pk);
+  header.fingerprint = pk.getFingerprint();
+  header.count = count;
+  std::size_t file_size =
+      IPCL_RAW_HEADER_SIZE + count * header.width * sizeof(Ipp32u);
+
+  int fd = ::open(fn.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  ERROR_CHECK(fd >= 0, "CipherTextStore: cannot create " + fn);
+
+  unsigned char hbuf[IPCL_RAW_HEADER_SIZE];
+  encodeRawHeader(header, hbuf);
+  if (ftruncate(fd, file_size) != 0 ||
+      pwrite(fd, hbuf, IPCL_RAW_HEADER_SIZE, 0) !=
+          static_cast<ssize_t>(IPCL_RAW_HEADER_SIZE)) {
+    close(fd);
+    ERROR_CHECK(false, "CipherTextStore: cannot write " + fn);
+  }
+  return map(fd, file_size, pk, true);
+}
+
+CipherText CipherTextStore::load(std::size_t start, std::size_t size) const {
+  ERROR_CHECK(start <= m_count && size <= m_count - start,
+              "CipherTextStore::load range is out of range");
+  return CipherText(*m_pk, unpackRaw(m_data + start * m_width, m_width, size));
+}
+
+void CipherTextStore::store(std::size_t start, const CipherTextView& ct) {
+  ERROR_CHECK(m_writable, "CipherTextStore::store store is read-only");
+  ERROR_CHECK(start <= m_count && ct.getSize() <= m_count - start,
+              "CipherTextStore::store range is out of range");
+  ERROR_CHECK(*(ct.getPubKey()->getN()) == *(m_pk->getN()),
+              "CipherTextStore::store different public keys detected");
+  packRaw(ct.getView(), m_width, m_data + start * m_width);
+}
+
+void CipherTextStore::flush() {
+  if (m_writable && m_map != nullptr)
+    ERROR_CHECK(msync(m_map, m_map_size, MS_SYNC) == 0,
+                "CipherTextStore::flush msync failed");
+}
+
+void CipherTextStore::prefetch(std::size_t start, std::size_t size) const {
+  if (size == 0) return;
+  // madvise needs a page aligned start address
+  const std::size_t page = sysconf(_SC_PAGESIZE);
+  auto begin = reinterpret_cast<std::uintptr_t>(m_data + start * m_width);
+  auto end =
+      reinterpret_cast<std::uintptr_t>(m_data + (start + size) * m_width);
+  begin -= begin % page;
+  madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+void CipherTextStore::forEachChunk(
+    std::size_t chunk_size,
+    const std::function<void(std::size_t, std::size_t)>& func) const {
+  ERROR_CHECK(chunk_size > 0, "CipherTextStore: chunk size must be positive");
+  for (std::size_t off = 0; off < m_count; off += chunk_size) {
+    std::size_t n = std::min(chunk_size, m_count - off);
+    // let the kernel read the next chunk while this one is computed
+    std::size_t next = off + n;
+    prefetch(next, std::min(chunk_size, m_count - next));
+    func(off, n);
+  }
+}
+
+void CipherTextStore::add(const CipherTextStore& other, CipherTextStore& out,
+                          std::size_t chunk_size) const {
+  ERROR_CHECK(other.m_count == m_count && out.m_count == m_count,
+              "CipherTextStore::add size mismatch");
+  forEachChunk(chunk_size, [&](std::size_t off, std::size_t n) {
+    out.store(off, load(off, n) + other.load(off, n));
+  });
+}
+
+void CipherTextStore::multiply(const PlainText& pt, CipherTextStore& out,
+                               std::size_t chunk_size) const {
+  std::size_t pt_size = pt.getSize();
+  ERROR_CHECK((pt_size == m_count || pt_size == 1) && out.m_count == m_count,
+              "CipherTextStore::multiply size mismatch");
+  forEachChunk(chunk_size, [&](std::size_t off, std::size_t n) {
+    PlainTextView b = (pt_size == 1) ? PlainTextView(pt)
+                                     : PlainTextView(pt, off, n);
+    out.store(off, load(off, n) * b);
+  });
+}
+
+CipherText CipherTextStore::sum(std::size_t chunk_size) const {
+  ERROR_CHECK(m_count > 0, "CipherTextStore::sum store is empty");
+
+  const BigNumber& nsq = *(m_pk->getNSQ());
+  BigNumber acc = BigNumber::One();
+  forEachChunk(chunk_size, [&](std::size_t off, std::size_t n) {
+    CipherText ct = load(off, n);
+    BigNumberView v = ct.getView();
+
+    // partial products of IPCL_PARALLEL_GRAIN_SIZE values each
+    std::size_t num_parts =
+        (n + IPCL_PARALLEL_GRAIN_SIZE - 1) / IPCL_PARALLEL_GRAIN_SIZE;
+    std::vector<BigNumber> parts(num_parts);
+    parallelFor(num_parts, [&](std::size_t p) {
+      std::size_t begin = p * IPCL_PARALLEL_GRAIN_SIZE;
+      std::size_t end =
+          std::min<std::size_t>(n, begin + IPCL_PARALLEL_GRAIN_SIZE);
+      BigNumber prod = v[begin];
+      for (std::size_t i = begin + 1; i < end; i++) prod = prod * v[i] % nsq;
+      parts[p] = prod;
+    });
+    for (const auto& p : parts) acc = acc * p % nsq;
+  });
+  return CipherText(*m_pk, acc);
+}
+
+void CipherTextStore::decrypt(const PrivateKey& sk, const PlainTextSink& sink,
+                              std::size_t chunk_size) const {
+  ERROR_CHECK(static_cast<bool>(sink), "CipherTextStore::decrypt no sink");
+  forEachChunk(chunk_size, [&](std::size_t off, std::size_t n) {
+    sink(off, sk.decrypt(load(off, n)));
+  });
+}
+
+}  // namespace ipcl
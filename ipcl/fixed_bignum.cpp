@@ -0,0 +1,122 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/fixed_bignum.hpp"
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/thread_pool.hpp"
+
+namespace ipcl {
+
+template <int Bits>
+static void fixedModMul(const BigNumberView& a, const BigNumberView& b,
+                        const BigNumber& mod, std::vector<BigNumber>& res) {
+  using Num = FixedBigNum<Bits>;
+  const FixedMontgomery<Bits> mont(mod);
+
+  parallelFor(
+      a.size(),
+      [&](std::size_t i) {
+        Num x, y, r;
+        // operands out of the kernel range take the BigNumber path
+        if (!Num::fromBigNumber(a[i], x) || !Num::fromBigNumber(b[i], y) ||
+            x.compare(mont.getModulus()) >= 0 ||
+            y.compare(mont.getModulus()) >= 0) {
+          res[i] = a[i] * b[i] % mod;
+          return;
+        }
+        mont.modMul(r, x, y);
+        r.toBigNumber(res[i]);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+template <int Bits>
+static void fixedMulPlusOne(const BigNumber& a, const BigNumberView& b,
+                            const BigNumber& mod, std::vector<BigNumber>& res) {
+  using Half = FixedBigNum<Bits / 2>;
+  Half x;
+  bool fits = Half::fromBigNumber(a, x);
+  ERROR_CHECK(fits, "mulPlusOneMod: factor does not fit the kernel");
+
+  parallelFor(
+      b.size(),
+      [&](std::size_t i) {
+        Half y;
+        // a * b[i] + 1 < a^2 = mod needs no reduction when b[i] < a
+        if (!Half::fromBigNumber(b[i], y) || y.compare(x) >= 0) {
+          res[i] = (a * b[i] + 1) % mod;
+          return;
+        }
+        FixedBigNum<Bits> r;
+        Half::mul(r, x, y);
+        FixedBigNum<Bits>::add(r, r, FixedBigNum<Bits>(1));
+        r.toBigNumber(res[i]);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+// Size of the fixed-width kernel for a modulus, 0 if there is none
+static int getKernelBits(const BigNumber& mod) {
+  int bits = mod.BitSize();
+  if (bits > 4096 || mod <= BigNumber::Zero()) return 0;
+  return (bits <= 1024) ? 1024 : (bits + 1023) / 1024 * 1024;
+}
+
+std::vector<BigNumber> modMul(const BigNumberView& a, const BigNumberView& b,
+                              const BigNumber& mod) {
+  ERROR_CHECK(a.size() == b.size(), "modMul: size mismatch");
+  std::vector<BigNumber> res(a.size());
+
+  switch (mod.IsOdd() ? getKernelBits(mod) : 0) {
+    case 1024:
+      fixedModMul<1024>(a, b, mod, res);
+      break;
+    case 2048:
+      fixedModMul<2048>(a, b, mod, res);
+      break;
+    case 3072:
+      fixedModMul<3072>(a, b, mod, res);
+      break;
+    case 4096:
+      fixedModMul<4096>(a, b, mod, res);
+      break;
+    default:
+      parallelFor(
+          a.size(), [&](std::size_t i) { res[i] = a[i] * b[i] % mod; },
+          IPCL_PARALLEL_GRAIN_SIZE);
+  }
+  return res;
+}
+
+std::vector<BigNumber> mulPlusOneMod(const BigNumber& a, const BigNumberView& b,
+                                     const BigNumber& mod, bool is_square) {
+  std::vector<BigNumber> res(b.size());
+
+  // the fixed-width path relies on mod = a^2 and a of half the kernel size
+  int kernel_bits = getKernelBits(mod);
+  if (kernel_bits != 0 && 2 * a.BitSize() > kernel_bits) kernel_bits = 0;
+  if (kernel_bits != 0 && !is_square && a * a != mod) kernel_bits = 0;
+
+  switch (kernel_bits) {
+    case 1024:
+      fixedMulPlusOne<1024>(a, b, mod, res);
+      break;
+    case 2048:
+      fixedMulPlusOne<2048>(a, b, mod, res);
+      break;
+    case 3072:
+      fixedMulPlusOne<3072>(a, b, mod, res);
+      break;
+    case 4096:
+      fixedMulPlusOne<4096>(a, b, mod, res);
+      break;
+    default:
+      parallelFor(
+          b.size(), [&](std::size_t i) { res[i] = (a * b[i] + 1) % mod; },
+          IPCL_PARALLEL_GRAIN_SIZE);
+  }
+  return res;
+}
+
+}  // namespace ipcl
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "ipcl/bignum.h"
+#include "ipcl/bignum_view.hpp"
 
 namespace ipcl {
 
@@ -23,6 +24,8 @@ class BaseText {
   explicit BaseText(const std::vector<uint32_t>& n_v);
   explicit BaseText(const BigNumber& bn);
   explicit BaseText(const std::vector<BigNumber>& bn_v);
+  explicit BaseText(std::vector<BigNumber>&& bn_v);
+  explicit BaseText(const BigNumberView& bn_view);
 
   /**
    * BaseText copy constructor
@@ -88,6 +91,21 @@ class BaseText {
   std::vector<BigNumber> getChunk(const std::size_t& start,
                                   const std::size_t& size) const;
 
+  /**
+   * Gets a zero-copy view of all BigNumber elements in m_text
+   */
+  BigNumberView getView() const;
+
+  /**
+   * Gets a zero-copy view of a chunk of BigNumber elements in m_text
+   * @param[in] start Start position
+   * @param[in] size The number of element
+   * @param[in] stride Step between consecutive elements(default is 1)
+   * return A view of the chunk, valid while this object is unmodified
+   */
+  BigNumberView getView(const std::size_t& start, const std::size_t& size,
+                        const std::size_t& stride = 1) const;
+
   /**
    * Gets the BigNumber container
    */
@@ -19,6 +19,7 @@
 #if !defined _BIGNUMBER_H_
 #define _BIGNUMBER_H_
 
+#include <cstddef>
 #include <ostream>
 #include <vector>
 
@@ -33,6 +34,7 @@ class BigNumber : public ipcl::serializer::serializerBase {
   BigNumber(const Ipp32u* pData, int length = 1,
             IppsBigNumSGN sgn = IppsBigNumPOS);
   BigNumber(const BigNumber& bn);
+  BigNumber(BigNumber&& bn) noexcept;
   BigNumber(const char* s);
   virtual ~BigNumber();
   const void* addr = static_cast<const void*>(this);
@@ -40,17 +42,34 @@ class BigNumber : public ipcl::serializer::serializerBase {
   // set value
   void Set(const Ipp32u* pData, int length = 1,
            IppsBigNumSGN sgn = IppsBigNumPOS);
-  // conversion to IppsBigNumState
-  friend IppsBigNumState* BN(const BigNumber& bn) { return bn.m_pBN; }
-  operator IppsBigNumState*() const { return m_pBN; }
+  // set value, reusing the storage when it is large enough
+  void Assign(const Ipp32u* pData, int length = 1,
+              IppsBigNumSGN sgn = IppsBigNumPOS);
+  // conversion to IppsBigNumState; a moved-from BigNumber holds no storage
+  // and gets a zero on first use
+  friend IppsBigNumState* BN(const BigNumber& bn) { return bn.state(); }
+  operator IppsBigNumState*() const { return state(); }
 
   // some useful constants
   static const BigNumber& Zero();
   static const BigNumber& One();
   static const BigNumber& Two();
 
+  // Storage of the IppsBigNumState buffers. By default buffers come from
+  // per-thread size-class free lists; an allocator set with SetAllocator()
+  // must outlive every BigNumber created while it is set.
+  struct Allocator {
+    void* (*allocate)(std::size_t bytes);
+    void (*deallocate)(void* p, std::size_t bytes);
+  };
+  static void SetAllocator(const Allocator* alloc);  // nullptr for default
+  static const Allocator* GetAllocator();
+
   // arithmetic operators probably need
+  // Operations never modify their const operands, so values shared between
+  // threads (e.g. key moduli) can be used concurrently without copies.
   BigNumber& operator=(const BigNumber& bn);
+  BigNumber& operator=(BigNumber&& bn) noexcept;
   // Bin: Support integer add
   BigNumber& operator+=(Ipp32u n);
   BigNumber& operator+=(const BigNumber& bn);
@@ -119,6 +138,7 @@ class BigNumber : public ipcl::serializer::serializerBase {
 
   // conversion and output
   void num2hex(std::string& s) const;          // convert to hex string
+  void num2dec(std::string& s) const;          // convert to decimal string
   void num2vec(std::vector<Ipp32u>& v) const;  // convert to 32-bit word vector
   friend std::ostream& operator<<(std::ostream& os, const BigNumber& a);
   void num2char(std::vector<Ipp8u>& dest) const;
@@ -128,6 +148,12 @@ class BigNumber : public ipcl::serializer::serializerBase {
   static bool toBin(unsigned char* data, int len, const BigNumber& bn);
   static bool toBin(unsigned char** data, int* len, const BigNumber& bn);
 
+  // Parse a hex (optional 0x prefix) or decimal string of len characters,
+  // with an optional leading '-', in time linear in the number of limbs
+  // produced per digit group. Returns false on an invalid digit.
+  static bool fromHex(BigNumber& bn, const char* s, int len);
+  static bool fromDec(BigNumber& bn, const char* s, int len);
+
  protected:
   friend class cereal::access;
   template <class Archive>
@@ -154,7 +180,9 @@ class BigNumber : public ipcl::serializer::serializerBase {
 
   bool create(const Ipp32u* pData, int length,
               IppsBigNumSGN sgn = IppsBigNumPOS);
-  IppsBigNumState* m_pBN;
+  IppsBigNumState* state() const { return m_pBN ? m_pBN : createZero(); }
+  IppsBigNumState* createZero() const;
+  mutable IppsBigNumState* m_pBN;
 };
 
 constexpr int BITSIZE_WORD(int n) { return (((n) + 31) >> 5); }
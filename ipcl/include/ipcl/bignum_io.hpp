@@ -0,0 +1,114 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_BIGNUM_IO_HPP_
+#define IPCL_INCLUDE_IPCL_BIGNUM_IO_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/bignum_view.hpp"
+
+namespace ipcl {
+
+/**
+ * Byte order of the values of a contiguous byte buffer
+ */
+enum class ByteOrder { BIG, LITTLE };
+
+/**
+ * Convert fixed-width unsigned integers into BigNumbers, in parallel.
+ * Destination BigNumbers are reused when their storage is large enough.
+ * @param[in] src Buffer of count * elem_bytes bytes
+ * @param[in] elem_bytes Number of bytes per value
+ * @param[in] count Number of values
+ * @param[in] order Byte order of the values
+ * @param[out] dst Destination of count BigNumbers
+ */
+void importBytes(const void* src, std::size_t elem_bytes, std::size_t count,
+                 ByteOrder order, BigNumber* dst);
+
+std::vector<BigNumber> importBytes(const void* src, std::size_t elem_bytes,
+                                   std::size_t count,
+                                   ByteOrder order = ByteOrder::BIG);
+
+/**
+ * Convert fixed-width unsigned integers straight into the packed limbs of
+ * the raw format, without creating BigNumbers
+ * @param[in] src Buffer of count * elem_bytes bytes
+ * @param[in] elem_bytes Number of bytes per value, at most 4 * width
+ * @param[in] count Number of values
+ * @param[in] order Byte order of the values
+ * @param[in] width Number of limbs per packed value
+ * @param[out] dst Destination of count * width limbs
+ */
+void importBytesRaw(const void* src, std::size_t elem_bytes, std::size_t count,
+                    ByteOrder order, std::size_t width, Ipp32u* dst);
+
+/**
+ * Convert non-negative BigNumbers into fixed-width unsigned integers, zero
+ * padded, in parallel
+ * @param[in] src Values to convert
+ * @param[in] elem_bytes Number of bytes per value
+ * @param[in] order Byte order of the values
+ * @param[out] dst Buffer of src.size() * elem_bytes bytes
+ */
+void exportBytes(const BigNumberView& src, std::size_t elem_bytes,
+                 ByteOrder order, void* dst);
+
+/**
+ * Write non-negative BigNumbers into separate len-byte big-endian buffers,
+ * the operand format of QAT, in parallel. A broadcast view is converted
+ * once.
+ * @param[in] src Values to write
+ * @param[in] len Size of each buffer in bytes
+ * @param[out] dst src.size() buffers of len bytes
+ */
+void exportBigEndian(const BigNumberView& src, int len,
+                     unsigned char* const* dst);
+
+/**
+ * Read len-byte big-endian buffers, the result format of QAT, straight into
+ * the storage of destination BigNumbers, in parallel
+ * @param[in] src count buffers of len bytes
+ * @param[in] len Size of each buffer in bytes
+ * @param[in] count Number of buffers
+ * @param[out] dst Destination of count BigNumbers
+ */
+void importBigEndian(const unsigned char* const* src, int len,
+                     std::size_t count, BigNumber* dst);
+
+/**
+ * Parse hex strings (with or without 0x prefix) into BigNumbers, in parallel
+ * @param[in] src Hex strings
+ * @param[out] dst Destination of src.size() BigNumbers
+ */
+void importHex(const std::vector<std::string>& src, BigNumber* dst);
+
+std::vector<BigNumber> importHex(const std::vector<std::string>& src);
+
+/**
+ * Parse decimal strings into BigNumbers, in parallel
+ * @param[in] src Decimal strings
+ * @param[out] dst Destination of src.size() BigNumbers
+ */
+void importDecimal(const std::vector<std::string>& src, BigNumber* dst);
+
+std::vector<BigNumber> importDecimal(const std::vector<std::string>& src);
+
+/**
+ * Format BigNumbers as 0x prefixed hex strings, in parallel
+ * @param[in] src Values to format
+ */
+std::vector<std::string> exportHex(const BigNumberView& src);
+
+/**
+ * Format BigNumbers as decimal strings, in parallel
+ * @param[in] src Values to format
+ */
+std::vector<std::string> exportDecimal(const BigNumberView& src);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_BIGNUM_IO_HPP_
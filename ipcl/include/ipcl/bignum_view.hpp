@@ -0,0 +1,138 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_BIGNUM_VIEW_HPP_
+#define IPCL_INCLUDE_IPCL_BIGNUM_VIEW_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "ipcl/bignum.h"
+
+namespace ipcl {
+
+/**
+ * Non-owning view over BigNumber storage described by an offset, a length,
+ * a stride, a rotation offset and a period. Element i of the view is
+ * base[offset + ((i + rotation) % period) * stride]; the period is the
+ * length, except for slices wrapping around a rotated view. A stride of 0
+ * repeats a single BigNumber length times. The view is valid as long as the
+ * viewed storage is alive and not resized.
+ */
+class BigNumberView {
+ public:
+  BigNumberView()
+      : m_base(nullptr),
+        m_offset(0),
+        m_length(0),
+        m_stride(1),
+        m_rotation(0),
+        m_period(0) {}
+
+  /**
+   * View over a whole BigNumber vector
+   */
+  BigNumberView(const std::vector<BigNumber>& v)  // NOLINT [runtime/explicit]
+      : m_base(v.data()),
+        m_offset(0),
+        m_length(v.size()),
+        m_stride(1),
+        m_rotation(0),
+        m_period(v.size()) {}
+
+  /**
+   * BigNumberView constructor
+   * @param[in] base Pointer to the first BigNumber of the storage
+   * @param[in] offset Index of the first element of the view in the storage
+   * @param[in] length Number of elements in the view
+   * @param[in] stride Distance between consecutive elements(default is 1)
+   * @param[in] rotation Rotation offset(default is 0)
+   */
+  BigNumberView(const BigNumber* base, std::size_t offset, std::size_t length,
+                std::size_t stride = 1, std::size_t rotation = 0)
+      : m_base(base),
+        m_offset(offset),
+        m_length(length),
+        m_stride(stride),
+        m_rotation(length > 0 ? rotation % length : 0),
+        m_period(length) {}
+
+  /**
+   * View repeating one BigNumber
+   * @param[in] bn BigNumber to repeat
+   * @param[in] length Number of elements in the view
+   */
+  static BigNumberView broadcast(const BigNumber& bn, std::size_t length) {
+    return BigNumberView(&bn, 0, length, 0);
+  }
+
+  const BigNumber& operator[](std::size_t idx) const {
+    std::size_t pos = idx + m_rotation;
+    if (pos >= m_period) pos -= m_period;
+    return m_base[m_offset + pos * m_stride];
+  }
+
+  /**
+   * Bounds-checked element access
+   */
+  const BigNumber& at(std::size_t idx) const;
+
+  std::size_t size() const { return m_length; }
+  bool empty() const { return m_length == 0; }
+  const BigNumber& front() const { return (*this)[0]; }
+
+  std::size_t getOffset() const { return m_offset; }
+  std::size_t getStride() const { return m_stride; }
+  std::size_t getRotation() const { return m_rotation; }
+
+  /**
+   * Check whether the elements are adjacent and in storage order
+   */
+  bool isContiguous() const {
+    return (m_stride == 1 || m_length < 2) && m_rotation == 0;
+  }
+
+  /**
+   * Pointer to the first element, only meaningful for contiguous views
+   */
+  const BigNumber* data() const { return m_base + m_offset; }
+
+  /**
+   * Sub-view of size elements starting at start, taking every stride-th
+   * element. Slices may wrap around the end of a rotated view.
+   * @param[in] start Start position in this view
+   * @param[in] size The number of elements
+   * @param[in] stride Step between consecutive elements(default is 1)
+   */
+  BigNumberView slice(std::size_t start, std::size_t size,
+                      std::size_t stride = 1) const;
+
+  /**
+   * Rotated view, with the same semantics as CipherText::rotate: element i of
+   * the result is element (i - shift) mod size of this view. Rotating a slice
+   * that wraps around copies its elements into storage owned by the result.
+   * @param[in] shift Rotate length
+   */
+  BigNumberView rotate(int shift) const;
+
+  /**
+   * Deep copy of the viewed elements
+   */
+  std::vector<BigNumber> toVector() const;
+
+ private:
+  // View over a copy of the elements, kept alive by the view
+  static BigNumberView own(std::vector<BigNumber>&& v);
+
+  const BigNumber* m_base;
+  std::size_t m_offset;
+  std::size_t m_length;
+  std::size_t m_stride;
+  std::size_t m_rotation;
+  std::size_t m_period;
+  // Set only when the view owns a copy of its elements
+  std::shared_ptr<const std::vector<BigNumber>> m_owned;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_BIGNUM_VIEW_HPP_
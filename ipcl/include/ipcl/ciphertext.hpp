@@ -4,15 +4,19 @@
 #ifndef IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
 #define IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "ipcl/key_registry.hpp"
 #include "ipcl/plaintext.hpp"
 #include "ipcl/pub_key.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
 
+class CipherTextView;
+
 class CipherText : public BaseText {
  public:
   CipherText() = default;
@@ -25,6 +29,13 @@ class CipherText : public BaseText {
   CipherText(const PublicKey& pk, const std::vector<uint32_t>& n_v);
   CipherText(const PublicKey& pk, const BigNumber& bn);
   CipherText(const PublicKey& pk, const std::vector<BigNumber>& bn_vec);
+  CipherText(const PublicKey& pk, std::vector<BigNumber>&& bn_vec);
+
+  /**
+   * CipherText constructor, copying the elements of a view
+   * @param[in] ct_view Reference to a CipherTextView
+   */
+  explicit CipherText(const CipherTextView& ct_view);
 
   /**
    * CipherText copy constructor
@@ -41,6 +52,12 @@ class CipherText : public BaseText {
   CipherText operator+(const PlainText& other) const;
   // CT*PT
   CipherText operator*(const PlainText& other) const;
+  // CT+CTV
+  CipherText operator+(const CipherTextView& other) const;
+  // CT+PTV
+  CipherText operator+(const PlainTextView& other) const;
+  // CT*PTV
+  CipherText operator*(const PlainTextView& other) const;
 
   /**
    * Get ciphertext of idx
@@ -59,20 +76,111 @@ class CipherText : public BaseText {
   CipherText rotate(int shift) const;
 
  private:
-  BigNumber raw_add(const BigNumber& a, const BigNumber& b) const;
-  BigNumber raw_mul(const BigNumber& a, const BigNumber& b) const;
-  std::vector<BigNumber> raw_mul(const std::vector<BigNumber>& a,
-                                 const std::vector<BigNumber>& b) const;
-
   std::shared_ptr<PublicKey> m_pk;  ///< Public key used to encrypt big number
 
-  // Serialization and desirealization
+  // Serialization and desirealization. From version 1 on, the archive can
+  // carry the fingerprint of a registered key instead of the whole key.
   friend class ::cereal::access;
   template <class Archive>
   void serialize(Archive& ar, const Ipp32u version) {
-    ar(::cereal::base_class<BaseText>(this), ::cereal::make_nvp("pk", *m_pk));
+    constexpr bool loading = Archive::is_loading::value;
+    ar(::cereal::base_class<BaseText>(this));
+
+    constexpr auto by_ref =
+        static_cast<std::uint8_t>(serializer::KeyMode::REFERENCE);
+    std::uint8_t key_mode =
+        static_cast<std::uint8_t>(serializer::KeyMode::EMBED);
+    if (!loading)
+      key_mode = static_cast<std::uint8_t>(serializer::getKeyMode());
+    if (version > 0) ar(::cereal::make_nvp("key_mode", key_mode));
+
+    if (key_mode == by_ref) {
+      std::uint64_t fingerprint = loading ? 0 : m_pk->getFingerprint();
+      ar(::cereal::make_nvp("pk_fingerprint", fingerprint));
+      if (loading) {
+        m_pk = findPublicKey(fingerprint);
+        ERROR_CHECK(m_pk != nullptr,
+                    "CipherText: public key of the archive is not registered");
+      }
+    } else {
+      // never overwrite a key shared with other ciphertexts
+      if (loading) m_pk = std::make_shared<PublicKey>();
+      ar(::cereal::make_nvp("pk", *m_pk));
+    }
   }
 };
 
+/**
+ * Non-owning view over the elements of a CipherText, accepted by decryption
+ * and by the homomorphic operators. Slicing and rotating a view never copies
+ * BigNumbers. Operators return a new CipherText.
+ */
+class CipherTextView {
+ public:
+  CipherTextView() = default;
+
+  /**
+   * View over a whole CipherText
+   */
+  CipherTextView(const CipherText& ct);  // NOLINT [runtime/explicit]
+
+  /**
+   * View over a window of a CipherText
+   * @param[in] ct Viewed CipherText
+   * @param[in] start Start position
+   * @param[in] size The number of element
+   * @param[in] stride Step between consecutive elements(default is 1)
+   */
+  CipherTextView(const CipherText& ct, std::size_t start, std::size_t size,
+                 std::size_t stride = 1);
+
+  /**
+   * View over BigNumber elements encrypted with a public key
+   */
+  CipherTextView(std::shared_ptr<PublicKey> pk, const BigNumberView& view)
+      : m_view(view), m_pk(std::move(pk)) {}
+
+  // CTV+CTV
+  CipherText operator+(const CipherTextView& other) const;
+  // CTV+PTV
+  CipherText operator+(const PlainTextView& other) const;
+  // CTV*PTV
+  CipherText operator*(const PlainTextView& other) const;
+
+  const BigNumber& operator[](std::size_t idx) const { return m_view[idx]; }
+
+  std::size_t getSize() const { return m_view.size(); }
+
+  const BigNumberView& getView() const { return m_view; }
+
+  /**
+   * Get public key
+   */
+  std::shared_ptr<PublicKey> getPubKey() const { return m_pk; }
+
+  /**
+   * Sub-view, see BigNumberView::slice
+   */
+  CipherTextView slice(std::size_t start, std::size_t size,
+                       std::size_t stride = 1) const;
+
+  /**
+   * Rotated view, see CipherText::rotate
+   * @param[in] shift rotate length
+   */
+  CipherTextView rotate(int shift) const;
+
+ private:
+  BigNumber raw_add(const BigNumber& a, const BigNumber& b) const;
+  BigNumber raw_mul(const BigNumber& a, const BigNumber& b) const;
+  std::vector<BigNumber> raw_mul(const BigNumberView& a,
+                                 const BigNumberView& b) const;
+
+  BigNumberView m_view;
+  std::shared_ptr<PublicKey> m_pk;
+};
+
 }  // namespace ipcl
+
+CEREAL_CLASS_VERSION(ipcl::CipherText, 1);
 #endif  // IPCL_INCLUDE_IPCL_CIPHERTEXT_HPP_
@@ -0,0 +1,145 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_CIPHERTEXT_STORE_HPP_
+#define IPCL_INCLUDE_IPCL_CIPHERTEXT_STORE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ipcl/ciphertext.hpp"
+#include "ipcl/plaintext.hpp"
+#include "ipcl/pri_key.hpp"
+#include "ipcl/pub_key.hpp"
+#include "ipcl/raw_format.hpp"
+#include "ipcl/stream.hpp"
+#include "ipcl/utils/common.hpp"
+
+namespace ipcl {
+
+/**
+ * Memory-mapped, file-backed array of ciphertexts in the raw format. Opening
+ * a store only maps the file; values are paged in by the OS and converted to
+ * BigNumber one chunk at a time, so homomorphic operations and decryption
+ * can run over stores larger than the memory. Results can be written into
+ * another (or the same) writable store.
+ */
+class CipherTextStore {
+ public:
+  CipherTextStore() = default;
+  ~CipherTextStore();
+
+  CipherTextStore(const CipherTextStore&) = delete;
+  CipherTextStore& operator=(const CipherTextStore&) = delete;
+  CipherTextStore(CipherTextStore&& other) noexcept;
+  CipherTextStore& operator=(CipherTextStore&& other) noexcept;
+
+  /**
+   * Map an existing raw format file
+   * @param[in] fn File name
+   * @param[in] pk Public key the file was encrypted with
+   * @param[in] writable Map the file for writing(default is false)
+   */
+  static CipherTextStore open(const std::string& fn, const PublicKey& pk,
+                              bool writable = false);
+
+  /**
+   * Create (or truncate) a raw format file of count zero values and map it
+   * for writing
+   * @param[in] fn File name
+   * @param[in] pk Public key of the stored ciphertexts
+   * @param[in] count Number of values
+   */
+  static CipherTextStore create(const std::string& fn, const PublicKey& pk,
+                                std::size_t count);
+
+  /**
+   * Get number of ciphertexts in the store
+   */
+  std::size_t getSize() const { return m_count; }
+
+  /**
+   * Get number of 32-bit limbs per ciphertext
+   */
+  std::size_t getWidth() const { return m_width; }
+
+  std::shared_ptr<PublicKey> getPubKey() const { return m_pk; }
+
+  bool isWritable() const { return m_writable; }
+
+  /**
+   * Convert a range of the store into a CipherText
+   * @param[in] start Index of the first ciphertext
+   * @param[in] size Number of ciphertexts
+   */
+  CipherText load(std::size_t start, std::size_t size) const;
+
+  /**
+   * Write ciphertexts into the store
+   * @param[in] start Index of the first ciphertext to overwrite
+   * @param[in] ct Ciphertexts encrypted with the key of the store
+   */
+  void store(std::size_t start, const CipherTextView& ct);
+
+  /**
+   * Flush written pages to the file
+   */
+  void flush();
+
+  /**
+   * Homomorphic addition: out[i] = this[i] + other[i]
+   * @param[in] other Store of the same size and key
+   * @param[out] out Writable store of the same size, may be this store
+   * @param[in] chunk_size Number of values per chunk
+   */
+  void add(const CipherTextStore& other, CipherTextStore& out,
+           std::size_t chunk_size = IPCL_STORE_CHUNK_SIZE) const;
+
+  /**
+   * Homomorphic multiplication by a plaintext: out[i] = this[i] * pt[i], or
+   * this[i] * pt[0] for a single plaintext
+   * @param[in] pt PlainText of size 1 or of the size of the store
+   * @param[out] out Writable store of the same size, may be this store
+   * @param[in] chunk_size Number of values per chunk
+   */
+  void multiply(const PlainText& pt, CipherTextStore& out,
+                std::size_t chunk_size = IPCL_STORE_CHUNK_SIZE) const;
+
+  /**
+   * Homomorphic sum of all the ciphertexts of the store
+   * @param[in] chunk_size Number of values per chunk
+   * @return encrypted sum as a CipherText of size 1
+   */
+  CipherText sum(std::size_t chunk_size = IPCL_STORE_CHUNK_SIZE) const;
+
+  /**
+   * Decrypt the store chunk by chunk
+   * @param[in] sk Private key
+   * @param[in] sink Destination of the plaintext chunks, called in order
+   * @param[in] chunk_size Number of values per chunk
+   */
+  void decrypt(const PrivateKey& sk, const PlainTextSink& sink,
+               std::size_t chunk_size = IPCL_STORE_CHUNK_SIZE) const;
+
+ private:
+  static CipherTextStore map(int fd, std::size_t file_size,
+                             const PublicKey& pk, bool writable);
+  void prefetch(std::size_t start, std::size_t size) const;
+  void forEachChunk(
+      std::size_t chunk_size,
+      const std::function<void(std::size_t, std::size_t)>& func) const;
+  void release();
+
+  void* m_map = nullptr;
+  std::size_t m_map_size = 0;
+  Ipp32u* m_data = nullptr;
+  std::size_t m_count = 0;
+  std::size_t m_width = 0;
+  bool m_writable = false;
+  std::shared_ptr<PublicKey> m_pk;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_CIPHERTEXT_STORE_HPP_
@@ -0,0 +1,266 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_FIXED_BIGNUM_HPP_
+#define IPCL_INCLUDE_IPCL_FIXED_BIGNUM_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/bignum_view.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+using uint128_t = unsigned __int128;
+
+/**
+ * Unsigned integer of a compile-time number of bits, stored inline as
+ * 64-bit little-endian limbs (the limb layout of the multi-buffer modular
+ * exponentiation buffers). All loop bounds are compile-time constants, so
+ * the kernels below are fully unrolled by the compiler.
+ */
+template <int Bits>
+class FixedBigNum {
+  static_assert(Bits > 0 && Bits % 64 == 0,
+                "FixedBigNum: Bits must be a positive multiple of 64");
+
+ public:
+  using Limb = std::uint64_t;
+  static constexpr int kBits = Bits;
+  static constexpr int kLimbs = BITSIZE_DWORD(Bits);
+
+  FixedBigNum() : m_limbs{} {}
+  explicit FixedBigNum(Limb value) : m_limbs{} { m_limbs[0] = value; }
+
+  Limb& operator[](int idx) { return m_limbs[idx]; }
+  const Limb& operator[](int idx) const { return m_limbs[idx]; }
+  Limb* data() { return m_limbs; }
+  const Limb* data() const { return m_limbs; }
+
+  /**
+   * Convert a BigNumber
+   * @param[in] bn Source value
+   * @param[out] out Destination
+   * @return false if bn is negative or does not fit in Bits
+   */
+  static bool fromBigNumber(const BigNumber& bn, FixedBigNum& out) {
+    IppsBigNumSGN sgn;
+    int bits;
+    Ipp32u* words;
+    ippsRef_BN(&sgn, &bits, &words, BN(bn));
+    int num_words = BITSIZE_WORD(bits);
+    if (sgn != IppsBigNumPOS || num_words > 2 * kLimbs) return false;
+
+    out = FixedBigNum();
+    for (int i = 0; i < num_words; i++)
+      out.m_limbs[i / 2] |= static_cast<Limb>(words[i]) << (32 * (i % 2));
+    return true;
+  }
+
+  /**
+   * Convert into a BigNumber, reusing its storage when it is large enough
+   * @param[out] bn Destination
+   */
+  void toBigNumber(BigNumber& bn) const {
+    Ipp32u words[2 * kLimbs];
+    for (int i = 0; i < kLimbs; i++) {
+      words[2 * i] = static_cast<Ipp32u>(m_limbs[i]);
+      words[2 * i + 1] = static_cast<Ipp32u>(m_limbs[i] >> 32);
+    }
+    bn.Assign(words, 2 * kLimbs);
+  }
+
+  BigNumber toBigNumber() const {
+    BigNumber bn;
+    toBigNumber(bn);
+    return bn;
+  }
+
+  bool isZero() const {
+    Limb acc = 0;
+    for (int i = 0; i < kLimbs; i++) acc |= m_limbs[i];
+    return acc == 0;
+  }
+
+  int compare(const FixedBigNum& other) const {
+    for (int i = kLimbs - 1; i >= 0; i--) {
+      if (m_limbs[i] != other.m_limbs[i])
+        return m_limbs[i] < other.m_limbs[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  /**
+   * r = a + b
+   * @return the carry out
+   */
+  static Limb add(FixedBigNum& r, const FixedBigNum& a, const FixedBigNum& b) {
+    Limb carry = 0;
+    for (int i = 0; i < kLimbs; i++) {
+      uint128_t cur =
+          static_cast<uint128_t>(a.m_limbs[i]) + b.m_limbs[i] + carry;
+      r.m_limbs[i] = static_cast<Limb>(cur);
+      carry = static_cast<Limb>(cur >> 64);
+    }
+    return carry;
+  }
+
+  /**
+   * r = a - b
+   * @return the borrow out
+   */
+  static Limb sub(FixedBigNum& r, const FixedBigNum& a, const FixedBigNum& b) {
+    Limb borrow = 0;
+    for (int i = 0; i < kLimbs; i++) {
+      Limb ai = a.m_limbs[i];
+      Limb d = ai - b.m_limbs[i];
+      Limb next = (ai < b.m_limbs[i]) | (d < borrow);
+      r.m_limbs[i] = d - borrow;
+      borrow = next;
+    }
+    return borrow;
+  }
+
+  /**
+   * Full product r = a * b
+   */
+  template <int OtherBits>
+  static void mul(FixedBigNum<Bits + OtherBits>& r, const FixedBigNum& a,
+                  const FixedBigNum<OtherBits>& b) {
+    r = FixedBigNum<Bits + OtherBits>();
+    for (int j = 0; j < FixedBigNum<OtherBits>::kLimbs; j++) {
+      Limb carry = 0;
+      for (int i = 0; i < kLimbs; i++) {
+        uint128_t cur =
+            static_cast<uint128_t>(a.m_limbs[i]) * b[j] + r[i + j] +
+            carry;
+        r[i + j] = static_cast<Limb>(cur);
+        carry = static_cast<Limb>(cur >> 64);
+      }
+      r[j + kLimbs] = carry;
+    }
+  }
+
+ private:
+  Limb m_limbs[kLimbs];
+};
+
+/**
+ * Montgomery arithmetic modulo an odd modulus of at most Bits bits, with
+ * R = 2^(64 * FixedBigNum<Bits>::kLimbs). Operands must be smaller than the
+ * modulus.
+ */
+template <int Bits>
+class FixedMontgomery {
+ public:
+  using Num = FixedBigNum<Bits>;
+  using Limb = typename Num::Limb;
+  static constexpr int kLimbs = Num::kLimbs;
+
+  /**
+   * FixedMontgomery constructor
+   * @param[in] mod Odd modulus of at most Bits bits
+   */
+  explicit FixedMontgomery(const BigNumber& mod) {
+    bool fits = Num::fromBigNumber(mod, m_mod);
+    ERROR_CHECK(fits && (m_mod[0] & 1),
+                "FixedMontgomery: modulus must be odd and fit in Bits");
+
+    // -mod^-1 mod 2^64 by Newton iteration, correct to 3 bits to start with
+    Limb inv = m_mod[0];
+    for (int i = 0; i < 5; i++) inv *= 2 - m_mod[0] * inv;
+    m_inv = ~inv + 1;
+
+    // R^2 mod mod
+    std::vector<Ipp32u> r2(4 * kLimbs + 1, 0);
+    r2.back() = 1;
+    BigNumber r2_bn =
+        BigNumber(r2.data(), static_cast<int>(r2.size())) % mod;
+    Num::fromBigNumber(r2_bn, m_r2);
+  }
+
+  const Num& getModulus() const { return m_mod; }
+
+  /**
+   * Montgomery product r = a * b / R mod m (CIOS)
+   */
+  void mul(Num& r, const Num& a, const Num& b) const {
+    Limb t[kLimbs + 2] = {0};
+    for (int i = 0; i < kLimbs; i++) {
+      Limb carry = 0;
+      for (int j = 0; j < kLimbs; j++) {
+        uint128_t cur =
+            static_cast<uint128_t>(a[j]) * b[i] + t[j] + carry;
+        t[j] = static_cast<Limb>(cur);
+        carry = static_cast<Limb>(cur >> 64);
+      }
+      uint128_t top = static_cast<uint128_t>(t[kLimbs]) + carry;
+      t[kLimbs] = static_cast<Limb>(top);
+      t[kLimbs + 1] = static_cast<Limb>(top >> 64);
+
+      Limb q = t[0] * m_inv;
+      uint128_t cur = static_cast<uint128_t>(q) * m_mod[0] + t[0];
+      carry = static_cast<Limb>(cur >> 64);
+      for (int j = 1; j < kLimbs; j++) {
+        cur = static_cast<uint128_t>(q) * m_mod[j] + t[j] + carry;
+        t[j - 1] = static_cast<Limb>(cur);
+        carry = static_cast<Limb>(cur >> 64);
+      }
+      top = static_cast<uint128_t>(t[kLimbs]) + carry;
+      t[kLimbs - 1] = static_cast<Limb>(top);
+      t[kLimbs] = t[kLimbs + 1] + static_cast<Limb>(top >> 64);
+    }
+
+    for (int i = 0; i < kLimbs; i++) r[i] = t[i];
+    if (t[kLimbs] != 0 || r.compare(m_mod) >= 0) Num::sub(r, r, m_mod);
+  }
+
+  void toMont(Num& r, const Num& a) const { mul(r, a, m_r2); }
+
+  void fromMont(Num& r, const Num& a) const { mul(r, a, Num(1)); }
+
+  /**
+   * Plain modular product r = a * b mod m
+   */
+  void modMul(Num& r, const Num& a, const Num& b) const {
+    Num t;
+    mul(t, a, b);
+    mul(r, t, m_r2);
+  }
+
+ private:
+  Num m_mod;
+  Num m_r2;
+  Limb m_inv;
+};
+
+/**
+ * Batched modular multiplication res[i] = a[i] * b[i] mod mod, in parallel.
+ * Odd moduli of up to 4096 bits use a fixed-width Montgomery kernel
+ * specialized on the next multiple of 1024 bits, other moduli use
+ * BigNumber arithmetic.
+ * @param[in] a First factors
+ * @param[in] b Second factors, of the size of a
+ * @param[in] mod Modulus shared by all the elements
+ */
+std::vector<BigNumber> modMul(const BigNumberView& a, const BigNumberView& b,
+                              const BigNumber& mod);
+
+/**
+ * Batched res[i] = (a * b[i] + 1) mod mod, in parallel, i.e. the Paillier
+ * encryption core with a = n and mod = n^2. Moduli of up to 4096 bits use a
+ * fixed-width half-size product when b[i] < a.
+ * @param[in] a Shared factor
+ * @param[in] b Per-element factors
+ * @param[in] mod Modulus, a^2 for the fixed-width path
+ * @param[in] is_square Whether mod is known to be a^2, which skips checking
+ * it (default is false)
+ */
+std::vector<BigNumber> mulPlusOneMod(const BigNumber& a, const BigNumberView& b,
+                                     const BigNumber& mod,
+                                     bool is_square = false);
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_FIXED_BIGNUM_HPP_
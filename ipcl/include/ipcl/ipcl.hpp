@@ -4,10 +4,19 @@
 #ifndef IPCL_INCLUDE_IPCL_IPCL_HPP_
 #define IPCL_INCLUDE_IPCL_IPCL_HPP_
 
+#include "ipcl/bignum_io.hpp"
+#include "ipcl/ciphertext_store.hpp"
+#include "ipcl/fixed_bignum.hpp"
+#include "ipcl/key_registry.hpp"
 #include "ipcl/mod_exp.hpp"
 #include "ipcl/pri_key.hpp"
+#include "ipcl/raw_format.hpp"
+#include "ipcl/stream.hpp"
 #include "ipcl/utils/context.hpp"
+#include "ipcl/utils/drbg.hpp"
+#include "ipcl/utils/numa.hpp"
 #include "ipcl/utils/serialize.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 
 namespace ipcl {
 
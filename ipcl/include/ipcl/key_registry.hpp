@@ -0,0 +1,69 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_KEY_REGISTRY_HPP_
+#define IPCL_INCLUDE_IPCL_KEY_REGISTRY_HPP_
+
+#include <cstdint>
+#include <memory>
+
+#include "ipcl/pub_key.hpp"
+
+namespace ipcl {
+
+/**
+ * Add a public key to the process-wide key registry, used to resolve the
+ * key references of CipherText archives written in KeyMode::REFERENCE
+ * @param[in] pk Public key
+ * @return the fingerprint the key is registered under
+ */
+std::uint64_t registerPublicKey(const PublicKey& pk);
+
+/**
+ * Add a shared public key to the key registry without copying it
+ * @param[in] pk Public key
+ * @return the fingerprint the key is registered under
+ */
+std::uint64_t registerPublicKey(std::shared_ptr<PublicKey> pk);
+
+/**
+ * Remove a public key from the key registry
+ * @param[in] fingerprint Fingerprint of the key
+ * @return true if the key was registered
+ */
+bool unregisterPublicKey(std::uint64_t fingerprint);
+
+/**
+ * Look up a registered public key
+ * @param[in] fingerprint Fingerprint of the key
+ * @return the registered key, or nullptr if there is none
+ */
+std::shared_ptr<PublicKey> findPublicKey(std::uint64_t fingerprint);
+
+namespace serializer {
+
+/**
+ * How a CipherText archive refers to its public key
+ */
+enum class KeyMode {
+  EMBED,     // the archive carries the whole public key
+  REFERENCE  // the archive carries the key fingerprint only
+};
+
+/**
+ * Set the key mode of the CipherText archives written by the calling thread.
+ * Archives written in KeyMode::REFERENCE can only be loaded where the key is
+ * registered.
+ * @param[in] mode Key mode(default is KeyMode::EMBED)
+ */
+void setKeyMode(KeyMode mode);
+
+/**
+ * Get the key mode of the calling thread
+ */
+KeyMode getKeyMode();
+
+}  // namespace serializer
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_KEY_REGISTRY_HPP_
@@ -4,9 +4,12 @@
 #ifndef IPCL_INCLUDE_IPCL_MOD_EXP_HPP_
 #define IPCL_INCLUDE_IPCL_MOD_EXP_HPP_
 
+#include <cstddef>
+#include <string>
 #include <vector>
 
 #include "ipcl/bignum.h"
+#include "ipcl/bignum_view.hpp"
 
 namespace ipcl {
 
@@ -62,6 +65,66 @@ HybridMode getHybridMode();
  */
 bool isHybridOptimal();
 
+/**
+ * Operation a batch of modular exponentiations belongs to. In
+ * HybridMode::OPTIMAL, the QAT/CPU split is tuned online for each operation
+ * and modulus size.
+ */
+enum class HybridOp { NONE = -1, ENCRYPT = 0, DECRYPT = 1, MULTIPLY = 2 };
+
+/**
+ * Tags the modular exponentiations of the calling thread with an operation
+ * until the end of the enclosing scope
+ */
+class HybridOpScope {
+ public:
+  explicit HybridOpScope(HybridOp op);
+  ~HybridOpScope();
+
+  HybridOpScope(const HybridOpScope&) = delete;
+  HybridOpScope& operator=(const HybridOpScope&) = delete;
+
+ private:
+  HybridOp m_prev;
+};
+
+/**
+ * Learned QAT/CPU split of an (operation, modulus size) pair
+ */
+struct HybridTuningStats {
+  HybridOp op;
+  int mod_bits;        // modulus size, rounded up to a multiple of 512 bits
+  float ratio;         // share of the work QAT takes, from the throughputs
+  double qat_rate;     // smoothed QAT throughput, modexp per second
+  double cpu_rate;     // smoothed CPU throughput, modexp per second
+  std::size_t samples;  // number of hybrid runs measured
+};
+
+/**
+ * Get the splits learned in HybridMode::OPTIMAL
+ */
+std::vector<HybridTuningStats> getHybridTuningStats();
+
+/**
+ * Forget the learned splits, the next runs start from the default ratios
+ */
+void resetHybridTuning();
+
+/**
+ * Save the learned ratios to a text file
+ * @param[in] path file to write
+ * @return false if the file cannot be written
+ */
+bool saveHybridTuning(const std::string& path);
+
+/**
+ * Load ratios saved by saveHybridTuning(), as the starting point of the
+ * tuning
+ * @param[in] path file to read
+ * @return false if the file cannot be read or is malformed
+ */
+bool loadHybridTuning(const std::string& path);
+
 /**
  * Modular exponentiation for multi BigNumber
  * @param[in] base base of the exponentiation
@@ -72,6 +135,39 @@ bool isHybridOptimal();
 std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
                               const std::vector<BigNumber>& exp,
                               const std::vector<BigNumber>& mod);
+
+/**
+ * Modular exponentiation over BigNumber views, without copying the operands
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular, use BigNumberView::broadcast for a shared modulus
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> modExp(const BigNumberView& base,
+                              const BigNumberView& exp,
+                              const BigNumberView& mod);
+
+/**
+ * Modular exponentiation of multi BigNumber with a shared modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular shared by all the elements
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> modExp(const BigNumberView& base,
+                              const BigNumberView& exp, const BigNumber& mod);
+
+/**
+ * Modular exponentiation of multi BigNumber with a shared exponent and
+ * modulus
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow shared by all the elements
+ * @param[in] mod modular shared by all the elements
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> modExp(const BigNumberView& base, const BigNumber& exp,
+                              const BigNumber& mod);
+
 /**
  * Modular exponentiation for single BigNumber
  * @param[in] base base of the exponentiation
@@ -93,6 +189,17 @@ std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
                                  const std::vector<BigNumber>& exp,
                                  const std::vector<BigNumber>& mod);
 
+/**
+ * IPP modular exponentiation for multi buffer over BigNumber views
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> ippModExp(const BigNumberView& base,
+                                 const BigNumberView& exp,
+                                 const BigNumberView& mod);
+
 /**
  * IPP modular exponentiation for single buffer
  * @param[in] base base of the exponentiation
@@ -114,5 +221,16 @@ std::vector<BigNumber> qatModExp(const std::vector<BigNumber>& base,
                                  const std::vector<BigNumber>& exp,
                                  const std::vector<BigNumber>& mod);
 
+/**
+ * QAT modular exponentiation for multi BigNumber over BigNumber views
+ * @param[in] base base of the exponentiation
+ * @param[in] exp pow of the exponentiation
+ * @param[in] mod modular
+ * @return the modular exponentiation result of type BigNumber
+ */
+std::vector<BigNumber> qatModExp(const BigNumberView& base,
+                                 const BigNumberView& exp,
+                                 const BigNumberView& mod);
+
 }  // namespace ipcl
 #endif  // IPCL_INCLUDE_IPCL_MOD_EXP_HPP_
@@ -11,6 +11,8 @@
 namespace ipcl {
 
 class CipherText;
+class CipherTextView;
+class PlainTextView;
 /**
  * This structure encapsulates types uint32_t,
  * uint32_t vector, BigNumber and BigNumber vector.
@@ -44,6 +46,12 @@ class PlainText : public BaseText {
    */
   explicit PlainText(const std::vector<BigNumber>& bn_v);
 
+  /**
+   * PlainText constructor, copying the elements of a view
+   * @param[in] pt_view Reference to a PlainTextView
+   */
+  explicit PlainText(const PlainTextView& pt_view);
+
   /**
    * PlainText copy constructor
    */
@@ -97,5 +105,65 @@ class PlainText : public BaseText {
   }
 };
 
+/**
+ * Non-owning view over the elements of a PlainText, accepted wherever a
+ * PlainText is read. Slicing and rotating a view never copies BigNumbers.
+ */
+class PlainTextView {
+ public:
+  PlainTextView() = default;
+
+  /**
+   * View over a whole PlainText
+   */
+  PlainTextView(const PlainText& pt);  // NOLINT [runtime/explicit]
+
+  /**
+   * View over a window of a PlainText
+   * @param[in] pt Viewed PlainText
+   * @param[in] start Start position
+   * @param[in] size The number of element
+   * @param[in] stride Step between consecutive elements(default is 1)
+   */
+  PlainTextView(const PlainText& pt, std::size_t start, std::size_t size,
+                std::size_t stride = 1);
+
+  /**
+   * View over BigNumber elements
+   */
+  explicit PlainTextView(const BigNumberView& view) : m_view(view) {}
+
+  const BigNumber& operator[](std::size_t idx) const { return m_view[idx]; }
+
+  std::size_t getSize() const { return m_view.size(); }
+
+  const BigNumberView& getView() const { return m_view; }
+
+  /**
+   * Sub-view, see BigNumberView::slice
+   */
+  PlainTextView slice(std::size_t start, std::size_t size,
+                      std::size_t stride = 1) const;
+
+  /**
+   * Rotated view, see PlainText::rotate
+   * @param[in] shift rotate length
+   */
+  PlainTextView rotate(int shift) const;
+
+  /**
+   * PTV + CTV
+   */
+  CipherText operator+(const CipherTextView& other) const;
+
+  /**
+   * PTV * CTV
+   */
+  CipherText operator*(const CipherTextView& other) const;
+
+ private:
+  BigNumberView m_view;
+};
+
 }  // namespace ipcl
 #endif  // IPCL_INCLUDE_IPCL_PLAINTEXT_HPP_
@@ -60,6 +60,13 @@ class PrivateKey {
    */
   PlainText decrypt(const CipherText& ciphertext) const;
 
+  /**
+   * Decrypt a view of ciphertext without copying it
+   * @param[in] ciphertext CipherTextView to be decrypted
+   * @return plaintext of type PlainText
+   */
+  PlainText decrypt(const CipherTextView& ciphertext) const;
+
   const void* addr = static_cast<const void*>(this);
 
   /**
@@ -181,7 +188,7 @@ class PrivateKey {
    * @param[in] ciphertext input ciphertext
    */
   void decryptRAW(std::vector<BigNumber>& plaintext,
-                  const std::vector<BigNumber>& ciphertext) const;
+                  const BigNumberView& ciphertext) const;
 
   /**
    * Raw decryption function with CRT optimization
@@ -189,7 +196,7 @@ class PrivateKey {
    * @param[in] ciphertext input ciphertext
    */
   void decryptCRT(std::vector<BigNumber>& plaintext,
-                  const std::vector<BigNumber>& ciphertext) const;
+                  const BigNumberView& ciphertext) const;
 };
 
 }  // namespace ipcl
@@ -4,6 +4,7 @@
 #ifndef IPCL_INCLUDE_IPCL_PUB_KEY_HPP_
 #define IPCL_INCLUDE_IPCL_PUB_KEY_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -59,6 +60,15 @@ class PublicKey {
    */
   CipherText encrypt(const PlainText& plaintext, bool make_secure = true) const;
 
+  /**
+   * Encrypt a view of plaintext without copying it
+   * @param[in] plaintext of type PlainTextView
+   * @param[in] make_secure apply obfuscator(default value is true)
+   * @return ciphertext of type CipherText
+   */
+  CipherText encrypt(const PlainTextView& plaintext,
+                     bool make_secure = true) const;
+
   /**
    * Get N of public key in paillier scheme
    */
@@ -84,6 +94,12 @@ class PublicKey {
    */
   int getDwords() const { return m_dwords; }
 
+  /**
+   * Get a 64-bit fingerprint identifying the key, computed from n and the
+   * key length
+   */
+  std::uint64_t getFingerprint() const;
+
   /**
    * Apply obfuscator for ciphertext
    * @param[out] obfuscator output of obfuscator with random value
@@ -177,11 +193,11 @@ class PublicKey {
 
   /**
    * Big number vector multi buffer encryption
-   * @param[in] pt plaintext of BigNumber vector type
+   * @param[in] pt plaintext of BigNumber view type
    * @param[in] make_secure apply obfuscator(default value is true)
    * @return ciphertext of BigNumber vector type
    */
-  std::vector<BigNumber> raw_encrypt(const std::vector<BigNumber>& pt,
+  std::vector<BigNumber> raw_encrypt(const BigNumberView& pt,
                                      bool make_secure = true) const;
 
   std::vector<BigNumber> getDJNObfuscator(std::size_t sz) const;
@@ -0,0 +1,225 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_RAW_FORMAT_HPP_
+#define IPCL_INCLUDE_IPCL_RAW_FORMAT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/bignum_view.hpp"
+#include "ipcl/ciphertext.hpp"
+#include "ipcl/pub_key.hpp"
+#include "ipcl/stream.hpp"
+#include "ipcl/utils/common.hpp"
+
+namespace ipcl {
+
+/**
+ * Header of the raw ciphertext format. On disk it takes
+ * IPCL_RAW_HEADER_SIZE bytes, all fields little-endian, and is followed by
+ * count values of width 32-bit little-endian limbs each, least significant
+ * limb first, zero padded.
+ */
+struct RawHeader {
+  std::uint16_t version;
+  std::uint32_t width;        // limbs per value
+  std::uint64_t fingerprint;  // PublicKey::getFingerprint() of the key
+  std::uint64_t count;        // number of values
+};
+
+constexpr std::size_t IPCL_RAW_HEADER_SIZE = 32;
+constexpr std::uint16_t IPCL_RAW_FORMAT_VERSION = 1;
+
+/**
+ * Write a raw header into a buffer of IPCL_RAW_HEADER_SIZE bytes
+ * @param[in] header Header to encode
+ * @param[out] buf Destination buffer
+ */
+void encodeRawHeader(const RawHeader& header, unsigned char* buf);
+
+/**
+ * Read and validate a raw header from a buffer of IPCL_RAW_HEADER_SIZE bytes
+ * @param[in] buf Source buffer
+ * @return the decoded header
+ */
+RawHeader decodeRawHeader(const unsigned char* buf);
+
+/**
+ * Get the number of limbs of a raw value encrypted under a key
+ * @param[in] pk Public key
+ */
+std::uint32_t getRawWidth(const PublicKey& pk);
+
+/**
+ * Pack non-negative BigNumbers into fixed-width little-endian limbs, in
+ * parallel
+ * @param[in] src Values to pack
+ * @param[in] width Number of limbs per value
+ * @param[out] dst Destination of src.size() * width limbs
+ */
+void packRaw(const BigNumberView& src, std::size_t width, Ipp32u* dst);
+
+/**
+ * Unpack fixed-width little-endian limbs into BigNumbers, in parallel
+ * @param[in] src Source of count * width limbs
+ * @param[in] width Number of limbs per value
+ * @param[in] count Number of values
+ * @return the unpacked values
+ */
+std::vector<BigNumber> unpackRaw(const Ipp32u* src, std::size_t width,
+                                 std::size_t count);
+
+/**
+ * Writer of the chunked container format. The container starts with a
+ * header laid out like the raw format header (with its own magic and a
+ * count of 0), followed by frames. Each frame is a little-endian 32-bit
+ * value count, 4 reserved bytes and the packed values; an empty frame ends
+ * the container.
+ */
+class ChunkedWriter {
+ public:
+  /**
+   * ChunkedWriter constructor, writes the container header
+   * @param[in] os Output stream
+   * @param[in] pk Public key of the ciphertexts to write
+   */
+  ChunkedWriter(std::ostream& os, const PublicKey& pk);
+
+  /**
+   * Write one frame
+   * @param[in] chunk Ciphertexts encrypted with the key of the writer, at
+   * most IPCL_CHUNKED_MAX_FRAME_SIZE
+   */
+  void write(const CipherTextView& chunk);
+
+  /**
+   * Write the end of container frame
+   */
+  void finish();
+
+ private:
+  std::ostream& m_os;
+  std::shared_ptr<BigNumber> m_n;
+  std::uint32_t m_width;
+  bool m_finished;
+  std::vector<Ipp32u> m_buf;
+};
+
+/**
+ * Resumable decoder of the chunked container format. Bytes can be fed in
+ * pieces of any size as they arrive; every complete frame becomes available
+ * as a CipherText right away.
+ */
+class ChunkedDecoder {
+ public:
+  /**
+   * ChunkedDecoder constructor
+   * @param[in] pk Public key the ciphertexts were encrypted with
+   */
+  explicit ChunkedDecoder(const PublicKey& pk);
+
+  ChunkedDecoder(const ChunkedDecoder&) = delete;
+  ChunkedDecoder& operator=(const ChunkedDecoder&) = delete;
+
+  /**
+   * Consume received bytes. Decoding stops at the end of the container, so
+   * bytes following it are left unconsumed.
+   * @param[in] data Received bytes
+   * @param[in] size Number of received bytes
+   * @return number of bytes consumed
+   */
+  std::size_t feed(const void* data, std::size_t size);
+
+  /**
+   * Take the next decoded chunk
+   * @param[out] chunk Decoded ciphertexts
+   * @return false if no complete chunk is available
+   */
+  bool next(CipherText& chunk);
+
+  /**
+   * Get the number of bytes that complete the header, frame header or block
+   * of frame payload being decoded(0 at the end of the container)
+   */
+  std::size_t getBytesNeeded() const { return m_need - m_have; }
+
+  /**
+   * Check whether the end of the container was decoded
+   */
+  bool isFinished() const { return m_state == State::DONE; }
+
+ private:
+  enum class State { HEADER, FRAME, PAYLOAD, DONE };
+
+  void expect(State state, unsigned char* target, std::size_t bytes);
+  void expectPayload();
+  void advance();
+
+  std::shared_ptr<PublicKey> m_pk;
+  std::uint32_t m_width;
+  State m_state;
+  unsigned char m_head[IPCL_RAW_HEADER_SIZE];
+  std::vector<Ipp32u> m_payload;
+  std::size_t m_frame_count;
+  std::size_t m_frame_have;
+  unsigned char* m_target;
+  std::size_t m_need;
+  std::size_t m_have;
+  std::deque<CipherText> m_ready;
+};
+
+namespace serializer {
+
+/**
+ * Write a CipherText in the raw format
+ * @param[in] os Output stream
+ * @param[in] ct CipherText to write
+ */
+void serializeRaw(std::ostream& os, const CipherText& ct);
+
+/**
+ * Read a CipherText in the raw format. The fingerprint stored in the header
+ * must match the fingerprint of pk.
+ * @param[in] is Input stream
+ * @param[in] pk Public key the CipherText was encrypted with
+ * @param[out] ct Destination CipherText
+ */
+void deserializeRaw(std::istream& is, const PublicKey& pk, CipherText& ct);
+
+bool serializeRawToFile(const std::string& fn, const CipherText& ct);
+
+bool deserializeRawFromFile(const std::string& fn, const PublicKey& pk,
+                            CipherText& ct);
+
+/**
+ * Write a CipherText in the chunked container format
+ * @param[in] os Output stream
+ * @param[in] ct CipherText to write
+ * @param[in] chunk_size Number of values per frame
+ */
+void serializeChunked(std::ostream& os, const CipherText& ct,
+                      std::size_t chunk_size = IPCL_RAW_IO_BLOCK_SIZE);
+
+/**
+ * Read a chunked container, handing every frame to a sink as soon as it is
+ * read
+ * @param[in] is Input stream
+ * @param[in] pk Public key the ciphertexts were encrypted with
+ * @param[in] sink Destination of the chunks, with their position
+ * @return total number of values read
+ */
+std::size_t deserializeChunked(std::istream& is, const PublicKey& pk,
+                               const CipherTextSink& sink);
+
+}  // namespace serializer
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_RAW_FORMAT_HPP_
@@ -0,0 +1,105 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_STREAM_HPP_
+#define IPCL_INCLUDE_IPCL_STREAM_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "ipcl/bignum.h"
+#include "ipcl/ciphertext.hpp"
+#include "ipcl/plaintext.hpp"
+#include "ipcl/pri_key.hpp"
+#include "ipcl/pub_key.hpp"
+#include "ipcl/utils/common.hpp"
+
+namespace ipcl {
+
+/**
+ * Chunk reader of a stream. Fills chunk with at most max_size values and
+ * returns the number of values read, 0 at the end of the stream.
+ */
+using BigNumberReader =
+    std::function<std::size_t(std::vector<BigNumber>& chunk,
+                              std::size_t max_size)>;
+
+/**
+ * Sink of encrypted chunks, called in stream order with the position of the
+ * first value of the chunk in the stream
+ */
+using CipherTextSink =
+    std::function<void(std::size_t offset, const CipherText& chunk)>;
+
+/**
+ * Sink of decrypted chunks, called in stream order with the position of the
+ * first value of the chunk in the stream
+ */
+using PlainTextSink =
+    std::function<void(std::size_t offset, const PlainText& chunk)>;
+
+/**
+ * Streaming pipeline settings
+ */
+struct StreamOptions {
+  // Number of values per chunk, rounded up to a multiple of
+  // IPCL_CRYPTO_MB_SIZE
+  std::size_t chunk_size = IPCL_STREAM_CHUNK_SIZE;
+  // Maximum number of chunks read ahead of, and waiting behind, the chunk
+  // being processed
+  std::size_t max_in_flight = IPCL_STREAM_MAX_IN_FLIGHT;
+  // Apply obfuscator when encrypting
+  bool make_secure = true;
+};
+
+/**
+ * Encrypt a stream of plaintext values in fixed-size chunks. Reading, the
+ * computation and the sink run concurrently, and at most
+ * 2 * max_in_flight + 3 chunks are alive at any time. The first exception
+ * thrown by the reader, the computation or the sink stops the pipeline and
+ * is rethrown.
+ * @param[in] pk Public key
+ * @param[in] reader Source of plaintext values
+ * @param[in] sink Destination of ciphertext chunks
+ * @param[in] options Pipeline settings
+ * @return total number of values encrypted
+ */
+std::size_t encryptStream(const PublicKey& pk, const BigNumberReader& reader,
+                          const CipherTextSink& sink,
+                          const StreamOptions& options = StreamOptions());
+
+/**
+ * Decrypt a stream of ciphertext values in fixed-size chunks, with the same
+ * pipelining and memory bound as encryptStream
+ * @param[in] sk Private key
+ * @param[in] pk Public key the ciphertexts were encrypted with
+ * @param[in] reader Source of ciphertext values
+ * @param[in] sink Destination of plaintext chunks
+ * @param[in] options Pipeline settings(make_secure is ignored)
+ * @return total number of values decrypted
+ */
+std::size_t decryptStream(const PrivateKey& sk, const PublicKey& pk,
+                          const BigNumberReader& reader,
+                          const PlainTextSink& sink,
+                          const StreamOptions& options = StreamOptions());
+
+/**
+ * Chunk reader over an iterator range of values convertible to BigNumber.
+ * The range must outlive the returned reader.
+ * @param[in] first Begin of the range
+ * @param[in] last End of the range
+ */
+template <typename InputIt>
+BigNumberReader makeBigNumberReader(InputIt first, InputIt last) {
+  return [first, last](std::vector<BigNumber>& chunk,
+                       std::size_t max_size) mutable {
+    chunk.clear();
+    for (; first != last && chunk.size() < max_size; ++first)
+      chunk.emplace_back(*first);
+    return chunk.size();
+  };
+}
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_STREAM_HPP_
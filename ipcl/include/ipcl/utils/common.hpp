@@ -5,6 +5,7 @@
 #define IPCL_INCLUDE_IPCL_UTILS_COMMON_HPP_
 
 #include <climits>
+#include <cstddef>
 #include <random>
 #include <vector>
 
@@ -13,17 +14,53 @@
 namespace ipcl {
 
 constexpr int IPCL_CRYPTO_MB_SIZE = 8;
+// Default largest number of QAT modexp requests of one call in flight at a
+// time, see QATLimits
 constexpr int IPCL_QAT_MODEXP_BATCH_SIZE = 1024;
+// Largest number of QAT modexp requests converted and submitted at a time
+constexpr int IPCL_QAT_MODEXP_CHUNK_SIZE = 128;
 
 constexpr int IPCL_WORKLOAD_SIZE_THRESHOLD = 128;
 
+// Number of light-weight operations (e.g. mul/mod) grouped into one task
+constexpr int IPCL_PARALLEL_GRAIN_SIZE = 16;
+
+// Minimum number of tasks per NUMA node before a loop is split by node
+constexpr int IPCL_NUMA_PARTITION_MIN_CHUNKS = 2;
+
+// Default number of values per chunk of the streaming pipeline
+constexpr int IPCL_STREAM_CHUNK_SIZE = 4096;
+// Default number of chunks queued on each side of the streaming computation
+constexpr int IPCL_STREAM_MAX_IN_FLIGHT = 2;
+
+// Number of values packed or unpacked per block by the raw format I/O
+constexpr int IPCL_RAW_IO_BLOCK_SIZE = 4096;
+
+// Largest number of values in one frame of the chunked container format
+constexpr int IPCL_CHUNKED_MAX_FRAME_SIZE = 1 << 20;
+
+// Default number of values converted per chunk by CipherTextStore operations
+constexpr int IPCL_STORE_CHUNK_SIZE = 4096;
+
 constexpr float IPCL_HYBRID_MODEXP_RATIO_FULL = 1.0;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_ENCRYPT = 0.25;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_DECRYPT = 0.12;
 constexpr float IPCL_HYBRID_MODEXP_RATIO_MULTIPLY = 0.18;
 
+// Weight of the latest run in the smoothed throughputs of the hybrid tuner
+constexpr double IPCL_HYBRID_TUNER_SMOOTHING = 0.25;
+// Bounds of a tuned ratio, so that both QAT and CPU keep being measured
+constexpr float IPCL_HYBRID_TUNER_MIN_RATIO = 0.02;
+constexpr float IPCL_HYBRID_TUNER_MAX_RATIO = 0.98;
+
 constexpr int IPCL_RDRAND_RETRIES = 3;
 
+// Number of draws of a per-thread pseudo random generator between reseeds
+constexpr int IPCL_PRNG_RESEED_INTERVAL = 1 << 16;
+
+// Number of requests served by the AES-CTR DRBG between reseeds
+constexpr int IPCL_DRBG_RESEED_INTERVAL = 1 << 16;
+
 /**
  * Generate random number with std mt19937
  * @param[in,out] addr Location used to store the generated random number
@@ -35,7 +72,8 @@ void rand32u(std::vector<Ipp32u>& addr);
  * specified bit length
  * @param[in] rand Pointer to the output unsigned integer big number
  * @param[in] bits The number of generated bits
- * @param[in] ctx Pointer to the IppsPRNGState context.
+ * @param[in] ctx Pointer to the IppsPRNGState context, or nullptr to use the
+ * generator of the calling thread
  * @return Error code
  */
 IppStatus ippGenRandom(Ipp32u* rand, int bits, void* ctx);
@@ -45,7 +83,8 @@ IppStatus ippGenRandom(Ipp32u* rand, int bits, void* ctx);
  * specified bit length
  * @param[in] rand Pointer to the output Big Number
  * @param[in] bits The number of generated bits
- * @param[in] ctx Pointer to the IppsPRNGState context.
+ * @param[in] ctx Pointer to the IppsPRNGState context, or nullptr to use the
+ * generator of the calling thread
  * @return Error code
  */
 IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx);
@@ -57,5 +96,13 @@ IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx);
  */
 BigNumber getRandomBN(int bits);
 
+/**
+ * Get many random values, generated in parallel
+ * @param[in] count Number of values
+ * @param[in] bits The number of Big Number bits
+ * @return The random values
+ */
+std::vector<BigNumber> getRandomBNs(std::size_t count, int bits);
+
 }  // namespace ipcl
 #endif  // IPCL_INCLUDE_IPCL_UTILS_COMMON_HPP_
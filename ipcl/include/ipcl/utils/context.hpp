@@ -10,6 +10,24 @@
 
 namespace ipcl {
 
+/**
+ * Capacity limits of the QAT runtime context. Fields left at 0 select the
+ * default noted for each of them.
+ */
+struct QATLimits {
+  // QAT instances to use, 0 for every instance found
+  unsigned int num_instances = 0;
+  // Capacity of each QAT request queue, rounded up to a power of 2; 0 for
+  // the HE QAT default
+  unsigned int buffer_size = 0;
+  // Threads that can use the multithreading HE QAT interface at once; 0 for
+  // the HE QAT default
+  unsigned int buffer_count = 0;
+  // Largest number of QAT modexp requests of one call in flight at a time;
+  // 0 for IPCL_QAT_MODEXP_BATCH_SIZE
+  unsigned int batch_size = 0;
+};
+
 /**
  * Initialize device (CPU, QAT, or both) runtime context for the Paillier crypto
  * services.
@@ -24,6 +42,25 @@ namespace ipcl {
  */
 bool initializeContext(const std::string runtime_choice);
 
+/**
+ * Initialize device runtime context with the given QAT capacity limits, e.g.
+ * to use every QAT instance of a multi-device server.
+ * @param[in] runtime_choice See initializeContext(runtime_choice).
+ * @param[in] qat_limits Number of QAT instances, capacity of the request
+ * queues and number of QAT requests of one call in flight. The smaller of
+ * buffer_size and batch_size must be at least 4.
+ * @return true if runtime context has been properly initialized, false
+ * otherwise.
+ */
+bool initializeContext(const std::string runtime_choice,
+                       const QATLimits& qat_limits);
+
+/**
+ * Limits of the QAT runtime context in use, with the defaults resolved.
+ * Fields other than batch_size are 0 if QAT support is not built.
+ */
+QATLimits getQATLimits(void);
+
 /**
  * Terminate runtime context.
  * @return true if runtime context has been properly terminated, false
@@ -0,0 +1,89 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ipcl {
+
+/**
+ * CTR_DRBG of NIST SP 800-90A with AES-256 and no derivation function.
+ * Counter blocks are encrypted with AES-NI, 16 blocks at a time with VAES
+ * where the CPU supports it. The generator reseeds itself from RDSEED
+ * (falling back to RDRAND, then std::random_device) every
+ * IPCL_DRBG_RESEED_INTERVAL requests, and in a child process after fork().
+ * An instance must not be shared between threads, see getThreadDrbg().
+ */
+class AesCtrDrbg {
+ public:
+  static constexpr int kKeyLen = 32;
+  static constexpr int kBlockLen = 16;
+  static constexpr int kSeedLen = kKeyLen + kBlockLen;
+  // Largest request of SP 800-90A (2^19 bits), longer outputs are split
+  static constexpr std::size_t kMaxRequest = 1 << 16;
+
+  /**
+   * AesCtrDrbg constructor, instantiates from the entropy source
+   */
+  AesCtrDrbg();
+
+  /**
+   * AesCtrDrbg constructor, instantiates from a caller-provided seed, e.g.
+   * for known answer tests
+   * @param[in] seed Seed material of kSeedLen bytes
+   */
+  explicit AesCtrDrbg(const unsigned char* seed);
+
+  ~AesCtrDrbg();
+
+  AesCtrDrbg(const AesCtrDrbg&) = delete;
+  AesCtrDrbg& operator=(const AesCtrDrbg&) = delete;
+
+  /**
+   * Fill a buffer with random bytes
+   * @param[out] out Destination buffer
+   * @param[in] len Number of bytes
+   */
+  void generate(void* out, std::size_t len);
+
+  /**
+   * Reseed from the entropy source
+   */
+  void reseed();
+
+  /**
+   * Reseed from caller-provided seed material
+   * @param[in] seed Seed material of kSeedLen bytes
+   */
+  void reseed(const unsigned char* seed);
+
+  /**
+   * Check whether the CPU supports the AES-NI instructions the generator
+   * needs
+   */
+  static bool isSupported();
+
+ private:
+  void instantiate(const unsigned char* seed);
+  void update(const unsigned char* provided);
+  void generateBlocks(unsigned char* out, std::size_t blocks);
+
+  alignas(16) unsigned char m_round_keys[15 * kBlockLen];
+  std::uint64_t m_v_hi;
+  std::uint64_t m_v_lo;
+  std::uint64_t m_reseed_counter;
+  pid_t m_pid;  // process that last (re)seeded the state
+};
+
+/**
+ * Get the AES-CTR DRBG of the calling thread, instantiated on first use
+ */
+AesCtrDrbg& getThreadDrbg();
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_DRBG_HPP_
@@ -0,0 +1,100 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_NUMA_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_NUMA_HPP_
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "ipcl/utils/parse_cpuinfo.hpp"
+
+namespace ipcl {
+
+/**
+ * Get the cpu topology of the machine, discovered once from sysfs
+ */
+const linuxCPUTopology& getCPUTopology();
+
+/**
+ * Check whether NUMA-aware execution is in use, i.e. the machine exposes
+ * more than one node and IPCL_DISABLE_NUMA is not set
+ */
+bool isNUMAEnabled();
+
+/**
+ * Get the topology index (not the kernel node id) of the node the calling
+ * thread is currently running on
+ */
+int getCurrentNode();
+
+/**
+ * Restrict the calling thread to the cpus of a node
+ * @param[in] node Topology index of the node
+ * @return true on success
+ */
+bool bindThreadToNode(int node);
+
+/**
+ * Allocate memory preferably backed by pages of a node. Small requests, and
+ * all requests on single-node machines, use the regular heap.
+ * @param[in] bytes Size in bytes
+ * @param[in] node Topology index of the node
+ */
+void* allocOnNode(std::size_t bytes, int node);
+
+/**
+ * Free memory obtained by allocOnNode
+ * @param[in] ptr Pointer returned by allocOnNode
+ * @param[in] bytes Size in bytes used for the allocation
+ */
+void freeOnNode(void* ptr, std::size_t bytes);
+
+/**
+ * Split [0, size) into one contiguous slice per node, in topology order,
+ * with slice boundaries aligned to align iterations
+ * @param[in] size Number of iterations
+ * @param[in] num_nodes Number of nodes
+ * @param[in] align Slice alignment(default is 1)
+ * @return half-open [begin, end) range of each node
+ */
+std::vector<std::pair<std::size_t, std::size_t>> partitionByNode(
+    std::size_t size, std::size_t num_nodes, std::size_t align = 1);
+
+/**
+ * std allocator placing container storage on a given node
+ */
+template <typename T>
+class NodeLocalAllocator {
+ public:
+  using value_type = T;
+
+  explicit NodeLocalAllocator(int node = getCurrentNode()) : m_node(node) {}
+  template <typename U>
+  NodeLocalAllocator(const NodeLocalAllocator<U>& other)  // NOLINT
+      : m_node(other.node()) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(allocOnNode(n * sizeof(T), m_node));
+  }
+  void deallocate(T* p, std::size_t n) { freeOnNode(p, n * sizeof(T)); }
+
+  int node() const { return m_node; }
+
+  template <typename U>
+  bool operator==(const NodeLocalAllocator<U>& other) const {
+    return m_node == other.node();
+  }
+  template <typename U>
+  bool operator!=(const NodeLocalAllocator<U>& other) const {
+    return m_node != other.node();
+  }
+
+ private:
+  int m_node;
+};
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_NUMA_HPP_
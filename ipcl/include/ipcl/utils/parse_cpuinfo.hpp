@@ -5,10 +5,12 @@
 #define IPCL_INCLUDE_IPCL_UTILS_PARSE_CPUINFO_HPP_
 
 #include <algorithm>
+#include <cstdlib>
 #include <exception>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace ipcl {
 // trim from start (in place)
@@ -37,7 +39,7 @@ typedef struct {
   int n_nodes;
 } linuxCPUInfo;
 
-static void parseCPUInfo(linuxCPUInfo& info) {
+static inline void parseCPUInfo(linuxCPUInfo& info) {
   std::ifstream cpuinfo;
   cpuinfo.exceptions(std::ifstream::badbit);
   info.n_cores = 0;
@@ -72,6 +74,56 @@ static void parseCPUInfo(linuxCPUInfo& info) {
 }
 linuxCPUInfo getLinuxCPUInfoImpl(void);
 
+typedef struct {
+  int id;                         // NUMA node id as numbered by the kernel
+  std::vector<int> cpus;          // usable logical cpus on the node
+  std::vector<int> primary_cpus;  // first SMT sibling of each physical core
+} linuxNUMANode;
+
+typedef struct {
+  int n_processors;  // usable logical cpus
+  int n_cores;       // usable physical cores
+  int n_smt;         // hardware threads per physical core
+  std::vector<linuxNUMANode> nodes;
+} linuxCPUTopology;
+
+// Largest cpu or node id accepted in a sysfs list
+constexpr long IPCL_MAX_CPU_LIST_ID = 1 << 16;  // NOLINT [runtime/int]
+
+// parse a sysfs cpu/node list such as "0-3,8-11", empty if it is malformed
+static inline std::vector<int> parseCPUList(std::string list) {
+  std::vector<int> ids;
+  trim(list);
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    const char* str = range.c_str();
+    char* end = nullptr;
+    long first = std::strtol(str, &end, 10);  // NOLINT [runtime/int]
+    bool ok = (end != str);
+    long last = first;  // NOLINT [runtime/int]
+    if (ok && *end == '-') {
+      str = end + 1;
+      last = std::strtol(str, &end, 10);
+      ok = (end != str);
+    }
+    if (!ok || *end != '\0' || first < 0 || last < first ||
+        last > IPCL_MAX_CPU_LIST_ID)
+      return {};
+    for (long i = first; i <= last; i++)  // NOLINT [runtime/int]
+      ids.push_back(static_cast<int>(i));
+  }
+  return ids;
+}
+
+/**
+ * Discover NUMA nodes, cores and SMT siblings from sysfs, restricted to the
+ * cpus the process is allowed to run on. Falls back to a single node holding
+ * every usable cpu when sysfs exposes no NUMA information.
+ */
+linuxCPUTopology getLinuxCPUTopologyImpl(void);
+
 }  // namespace ipcl
 
 #endif  // IPCL_INCLUDE_IPCL_UTILS_PARSE_CPUINFO_HPP_
@@ -0,0 +1,157 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IPCL_INCLUDE_IPCL_UTILS_THREAD_POOL_HPP_
+#define IPCL_INCLUDE_IPCL_UTILS_THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>  // NOLINT [build/c++11]
+#include <utility>
+#include <vector>
+
+namespace ipcl {
+
+/**
+ * Persistent work-stealing thread pool shared by every parallel region of the
+ * library. Each worker owns a task deque; idle workers steal from the others.
+ * Callers of parallelFor always take part in their own loop, so the pool can
+ * be used concurrently from many external threads and from nested regions
+ * without deadlocking or over-subscribing the machine.
+ *
+ * Workers may be organized in per-node groups bound to the cpus of their
+ * NUMA node. Idle workers then steal from their own node first, and large
+ * loops are split into one contiguous slice per node.
+ */
+class ThreadPool {
+ public:
+  /**
+   * ThreadPool constructor
+   * @param[in] num_workers Number of persistent worker threads
+   */
+  explicit ThreadPool(std::size_t num_workers);
+
+  /**
+   * ThreadPool constructor with per-node worker groups
+   * @param[in] workers_per_node Number of workers of each node, in
+   * getCPUTopology() order
+   * @param[in] bind Whether to bind each group to the cpus of its node
+   */
+  ThreadPool(const std::vector<std::size_t>& workers_per_node, bool bind);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * Get number of worker threads
+   */
+  std::size_t getNumWorkers() const { return m_workers.size(); }
+
+  /**
+   * Get number of worker groups(one per NUMA node when node-aware)
+   */
+  std::size_t getNumGroups() const { return m_groups.size(); }
+
+  /**
+   * Run func(begin, end) over [0, size) split into chunks of at most grain
+   * iterations. Returns after every chunk is processed; the first exception
+   * thrown by a chunk is rethrown to the caller. With several worker groups,
+   * loops of at least IPCL_NUMA_PARTITION_MIN_CHUNKS chunks per group are
+   * split by node, so a given index range is always handled on the same node.
+   * @param[in] size Number of iterations
+   * @param[in] func Chunk body, called with a half-open iteration range
+   * @param[in] grain Number of iterations per chunk(default is 1)
+   * @param[in] max_concurrency Maximum number of threads, including the
+   * caller, working on this call(0 means the whole pool)
+   */
+  void parallelFor(std::size_t size,
+                   const std::function<void(std::size_t, std::size_t)>& func,
+                   std::size_t grain = 1, std::size_t max_concurrency = 0);
+
+ private:
+  struct Job;
+  struct WorkQueue {
+    std::mutex mtx;
+    std::deque<std::function<void()>> tasks;
+  };
+  struct WorkerGroup {
+    std::size_t first;  // index of the first worker of the group
+    std::size_t count;
+    std::atomic<std::size_t> next;
+  };
+
+  void start(const std::vector<std::size_t>& workers_per_node, bool bind);
+  void workerLoop(std::size_t id, std::size_t group, bool bind);
+  void push(std::function<void()> task, std::size_t group);
+  bool tryPop(std::size_t id, std::function<void()>& task);
+  std::size_t callerGroup() const;
+  static void runChunks(Job& job);
+
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+  std::vector<std::size_t> m_worker_group;
+  std::vector<std::unique_ptr<WorkerGroup>> m_groups;
+  std::vector<std::thread> m_workers;
+  std::atomic<std::size_t> m_pending;
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  bool m_stop;
+};
+
+/**
+ * Get the library-wide thread pool, created on first use with
+ * getDefaultNumThreads() workers
+ */
+std::shared_ptr<ThreadPool> getThreadPool();
+
+/**
+ * Resize the library-wide thread pool. Calls already running keep the pool
+ * they started with.
+ * @param[in] num_threads Maximum number of threads in a parallel region,
+ * including the caller(0 restores the default)
+ */
+void setNumThreads(std::size_t num_threads);
+
+/**
+ * Get the maximum number of threads in a parallel region, including the
+ * caller
+ */
+std::size_t getNumThreads();
+
+/**
+ * Get the default maximum number of threads in a parallel region, taken from
+ * the IPCL_NUM_THREADS environment variable if set, otherwise from the build
+ * configuration. With NUMA-aware execution the build configuration value is
+ * applied per node.
+ */
+std::size_t getDefaultNumThreads();
+
+/**
+ * Parallel loop over [0, size) on the library-wide thread pool
+ * @param[in] size Number of iterations
+ * @param[in] func Loop body, called with a single iteration index
+ * @param[in] grain Number of iterations per task(default is 1)
+ * @param[in] max_concurrency Maximum number of threads for this call(0 means
+ * no per-call limit)
+ */
+template <typename Func>
+void parallelFor(std::size_t size, Func&& func, std::size_t grain = 1,
+                 std::size_t max_concurrency = 0) {
+  if (size == 0) return;
+  auto body = [&func](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) func(i);
+  };
+  if (size <= grain || max_concurrency == 1) {
+    body(0, size);
+    return;
+  }
+  getThreadPool()->parallelFor(size, body, grain, max_concurrency);
+}
+
+}  // namespace ipcl
+#endif  // IPCL_INCLUDE_IPCL_UTILS_THREAD_POOL_HPP_
@@ -27,10 +27,11 @@ inline std::string build_log(const char* file, int line,
   return log.str();
 }
 
-#define ERROR_CHECK(e, ...)                                                 \
-  do {                                                                      \
-    if (!(e))                                                               \
-      throw std::runtime_error(build_log(__FILE__, __LINE__, __VA_ARGS__)); \
+#define ERROR_CHECK(e, ...)                                  \
+  do {                                                       \
+    if (!(e))                                                \
+      throw std::runtime_error(                              \
+          ipcl::build_log(__FILE__, __LINE__, __VA_ARGS__)); \
   } while (0)
 
 template <typename T>
@@ -43,7 +44,7 @@ inline void vec_size_check(const std::vector<T>& v, const char* file,
 
 #define VEC_SIZE_CHECK(v) vec_size_check(v, __FILE__, __LINE__)
 
-enum class RNGenType { RDSEED = 1, RDRAND = 2, PSEUDO = 3 };
+enum class RNGenType { RDSEED = 1, RDRAND = 2, PSEUDO = 3, AES_CTR = 4 };
 
 #ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
 static const bool disable_avx512ifma =
@@ -52,19 +53,25 @@ static const bool prefer_rdrand =
     (std::getenv("IPCL_PREFER_RDRAND") != nullptr);
 static const bool prefer_ipp_prng =
     (std::getenv("IPCL_PREFER_IPP_PRNG") != nullptr);
+static const bool prefer_aes_drbg =
+    (std::getenv("IPCL_PREFER_AES_DRBG") != nullptr);
 static const cpu_features::X86Features features =
     cpu_features::GetX86Info().features;
 static const bool has_avx512ifma = features.avx512ifma && !disable_avx512ifma;
 static const bool use_rdseed =
     features.rdseed && !prefer_rdrand && !prefer_ipp_prng;
 static const bool use_rdrand = features.rdrnd && prefer_rdrand;
+static const bool use_aes_drbg = features.aes && prefer_aes_drbg;
 
-static const RNGenType kRNGenType = use_rdseed   ? RNGenType::RDSEED
+static const RNGenType kRNGenType = use_aes_drbg ? RNGenType::AES_CTR
+                                    : use_rdseed ? RNGenType::RDSEED
                                     : use_rdrand ? RNGenType::RDRAND
                                                  : RNGenType::PSEUDO;
 
 #else  // compile time detection of cpu feature
-#ifdef IPCL_RNG_INSTR_RDSEED
+#ifdef IPCL_RNG_AES_CTR_DRBG
+static const RNGenType kRNGenType = RNGenType::AES_CTR;
+#elif defined(IPCL_RNG_INSTR_RDSEED)
 static const RNGenType kRNGenType = RNGenType::RDSEED;
 #elif defined(IPCL_RNG_INSTR_RDRAND)
 static const RNGenType kRNGenType = RNGenType::RDRAND;
@@ -78,16 +85,6 @@ class OMPUtilities {
  public:
   static const int MaxThreads;
 
-  static int assignOMPThreads(int& remaining_threads, int requested_threads) {
-    int retval = (requested_threads > 0 ? requested_threads : 1);
-    if (retval > remaining_threads) retval = remaining_threads;
-    if (retval > 1)
-      remaining_threads -= retval;
-    else
-      retval = 1;
-    return retval;
-  }
-
  private:
 #ifdef IPCL_RUNTIME_DETECT_CPU_FEATURES
   static const linuxCPUInfo cpuinfo;
@@ -0,0 +1,61 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/key_registry.hpp"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+static std::shared_mutex g_registry_mtx;
+static std::unordered_map<std::uint64_t, std::shared_ptr<PublicKey>>
+    g_registry;
+
+static thread_local serializer::KeyMode g_key_mode =
+    serializer::KeyMode::EMBED;
+
+std::uint64_t registerPublicKey(const PublicKey& pk) {
+  return registerPublicKey(std::make_shared<PublicKey>(pk));
+}
+
+std::uint64_t registerPublicKey(std::shared_ptr<PublicKey> pk) {
+  ERROR_CHECK(pk != nullptr, "registerPublicKey: public key is null");
+  std::uint64_t fingerprint = pk->getFingerprint();
+
+  std::unique_lock<std::shared_mutex> lock(g_registry_mtx);
+  auto it = g_registry.find(fingerprint);
+  if (it != g_registry.end()) {
+    // the same key may be registered again, a colliding key may not
+    ERROR_CHECK(*(it->second->getN()) == *(pk->getN()),
+                "registerPublicKey: fingerprint collision with another key");
+    return fingerprint;
+  }
+  g_registry.emplace(fingerprint, std::move(pk));
+  return fingerprint;
+}
+
+bool unregisterPublicKey(std::uint64_t fingerprint) {
+  std::unique_lock<std::shared_mutex> lock(g_registry_mtx);
+  return g_registry.erase(fingerprint) > 0;
+}
+
+std::shared_ptr<PublicKey> findPublicKey(std::uint64_t fingerprint) {
+  std::shared_lock<std::shared_mutex> lock(g_registry_mtx);
+  auto it = g_registry.find(fingerprint);
+  return (it == g_registry.end()) ? nullptr : it->second;
+}
+
+namespace serializer {
+
+void setKeyMode(KeyMode mode) { g_key_mode = mode; }
+
+KeyMode getKeyMode() { return g_key_mode; }
+
+}  // namespace serializer
+
+}  // namespace ipcl
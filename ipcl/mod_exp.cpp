@@ -4,17 +4,31 @@
 #include "ipcl/mod_exp.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <condition_variable>  //NOLINT
 #include <cstring>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>  //NOLINT
+#include <sstream>
 #include <thread>  //NOLINT
+#include <utility>
 
 #include "crypto_mb/exp.h"
 
 #ifdef IPCL_USE_QAT
 #include <heqat/bnops.h>
 #include <heqat/common.h>
+#include <heqat/common/numa.h>
 #endif
 
+#include "ipcl/bignum_io.hpp"
+#include "ipcl/utils/context.hpp"
+#include "ipcl/utils/numa.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -22,7 +36,8 @@ namespace ipcl {
 static thread_local struct {
   float ratio;
   HybridMode mode;
-} g_hybrid_params = {0.0, HybridMode::OPTIMAL};
+  HybridOp op;
+} g_hybrid_params = {0.0, HybridMode::OPTIMAL, HybridOp::NONE};
 
 static inline float scale_down(int value, float scale = 100.0) {
   return value / scale;
@@ -45,13 +60,15 @@ void setHybridMode(HybridMode mode) {
 #ifdef IPCL_USE_QAT
   int mode_value = static_cast<std::underlying_type<HybridMode>::type>(mode);
   float ratio = scale_down(mode_value);
-  g_hybrid_params = {ratio, mode};
+  g_hybrid_params.ratio = ratio;
+  g_hybrid_params.mode = mode;
 #endif  // IPCL_USE_QAT
 }
 
 void setHybridOff() {
 #ifdef IPCL_USE_QAT
-  g_hybrid_params = {0.0, HybridMode::UNDEFINED};
+  g_hybrid_params.ratio = 0.0;
+  g_hybrid_params.mode = HybridMode::UNDEFINED;
 #endif  // IPCL_USE_QAT
 }
 
@@ -63,129 +80,584 @@ bool isHybridOptimal() {
   return (g_hybrid_params.mode == HybridMode::OPTIMAL) ? true : false;
 }
 
+HybridOpScope::HybridOpScope(HybridOp op) : m_prev(g_hybrid_params.op) {
+  g_hybrid_params.op = op;
+}
+
+HybridOpScope::~HybridOpScope() { g_hybrid_params.op = m_prev; }
+
+// Online tuning of the QAT/CPU split of HybridMode::OPTIMAL, shared by all
+// threads and keyed by operation and modulus size
+struct HybridTuning {
+  float ratio;
+  double qat_rate;
+  double cpu_rate;
+  std::size_t samples;
+};
+
+static std::mutex g_tuning_mutex;
+static std::map<std::pair<HybridOp, int>, HybridTuning> g_tuning;
+
+static const char* const hybrid_op_names[] = {"encrypt", "decrypt",
+                                              "multiply"};
+
+static inline int tuningBits(int bits) { return (bits + 511) / 512 * 512; }
+
+static inline float clampRatio(float ratio) {
+  return std::min(std::max(ratio, IPCL_HYBRID_TUNER_MIN_RATIO),
+                  IPCL_HYBRID_TUNER_MAX_RATIO);
+}
+
+// The split is only looked up and learned by hybrid modExp calls
+#if defined(IPCL_USE_QAT) && defined(IPCL_USE_OMP)
+static float defaultRatio(HybridOp op) {
+  switch (op) {
+    case HybridOp::ENCRYPT:
+      return IPCL_HYBRID_MODEXP_RATIO_ENCRYPT;
+    case HybridOp::DECRYPT:
+      return IPCL_HYBRID_MODEXP_RATIO_DECRYPT;
+    case HybridOp::MULTIPLY:
+      return IPCL_HYBRID_MODEXP_RATIO_MULTIPLY;
+    default:
+      return g_hybrid_params.ratio;
+  }
+}
+
+static float getTunedRatio(HybridOp op, int mod_bits) {
+  std::lock_guard<std::mutex> lock(g_tuning_mutex);
+  auto it = g_tuning.find({op, mod_bits});
+  return (it == g_tuning.end()) ? defaultRatio(op) : it->second.ratio;
+}
+
+// Fold the throughputs of a hybrid run into the learned split: QAT and CPU
+// finish together when the work is split in proportion to their throughputs
+static void updateTuning(HybridOp op, int mod_bits, std::size_t qat_size,
+                         double qat_sec, std::size_t cpu_size,
+                         double cpu_sec) {
+  auto smooth = [](double& avg, double sample) {
+    avg = (avg > 0) ? avg + IPCL_HYBRID_TUNER_SMOOTHING * (sample - avg)
+                    : sample;
+  };
+
+  std::lock_guard<std::mutex> lock(g_tuning_mutex);
+  HybridTuning& t =
+      g_tuning.emplace(std::make_pair(op, mod_bits),
+                       HybridTuning{defaultRatio(op), 0.0, 0.0, 0})
+          .first->second;
+  if (qat_size > 0 && qat_sec > 0) smooth(t.qat_rate, qat_size / qat_sec);
+  if (cpu_size > 0 && cpu_sec > 0) smooth(t.cpu_rate, cpu_size / cpu_sec);
+  t.samples++;
+  if (t.qat_rate > 0 && t.cpu_rate > 0)
+    t.ratio = clampRatio(t.qat_rate / (t.qat_rate + t.cpu_rate));
+}
+#endif  // IPCL_USE_QAT && IPCL_USE_OMP
+
+std::vector<HybridTuningStats> getHybridTuningStats() {
+  std::lock_guard<std::mutex> lock(g_tuning_mutex);
+  std::vector<HybridTuningStats> stats;
+  stats.reserve(g_tuning.size());
+  for (const auto& entry : g_tuning) {
+    const HybridTuning& t = entry.second;
+    stats.push_back({entry.first.first, entry.first.second, t.ratio,
+                     t.qat_rate, t.cpu_rate, t.samples});
+  }
+  return stats;
+}
+
+void resetHybridTuning() {
+  std::lock_guard<std::mutex> lock(g_tuning_mutex);
+  g_tuning.clear();
+}
+
+bool saveHybridTuning(const std::string& path) {
+  std::ofstream ofs(path, std::ios::out);
+  if (!ofs) return false;
+
+  ofs << "# operation modulus_bits qat_ratio\n";
+  for (const HybridTuningStats& st : getHybridTuningStats())
+    ofs << hybrid_op_names[static_cast<int>(st.op)] << " " << st.mod_bits
+        << " " << st.ratio << "\n";
+  return static_cast<bool>(ofs);
+}
+
+bool loadHybridTuning(const std::string& path) {
+  std::ifstream ifs(path, std::ios::in);
+  if (!ifs) return false;
+
+  std::map<std::pair<HybridOp, int>, HybridTuning> loaded;
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream iss(line);
+    std::string name;
+    int mod_bits;
+    float ratio;
+    if (!(iss >> name >> mod_bits >> ratio) || mod_bits <= 0 ||
+        !(ratio >= 0.0 && ratio <= 1.0))
+      return false;
+
+    auto op_name = std::find(std::begin(hybrid_op_names),
+                             std::end(hybrid_op_names), name);
+    if (op_name == std::end(hybrid_op_names)) return false;
+    HybridOp op =
+        static_cast<HybridOp>(op_name - std::begin(hybrid_op_names));
+    loaded[{op, tuningBits(mod_bits)}] =
+        HybridTuning{clampRatio(ratio), 0.0, 0.0, 0};
+  }
+
+  std::lock_guard<std::mutex> lock(g_tuning_mutex);
+  for (const auto& entry : loaded) g_tuning[entry.first] = entry.second;
+  return true;
+}
+
 #ifdef IPCL_USE_QAT
-// [Multi-Thread supported] QAT ModExp interface to offload computation to QAT
-static std::vector<BigNumber> heQatBnModExp_MT(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exponent,
-    const std::vector<BigNumber>& modulus, unsigned int batch_size) {
-  int nbits = modulus.front().BitSize();
-  int length = BITSIZE_WORD(nbits) * 4;
-  nbits = 8 * length;
+// Operands of a QAT modexp call, converted into QAT requests chunk by chunk.
+// They must outlive the requests of the call, i.e. until its completion
+// queue is drained.
+struct QatModExpOperands {
+  QatModExpOperands(const BigNumberView& b, const BigNumberView& e,
+                    const BigNumberView& m)
+      : base(b), exponent(e), modulus(m), shared_modulus(nullptr) {
+    int bits = m.front().BitSize();
+    length = BITSIZE_WORD(bits) * 4;
+    nbits = 8 * length;
+
+    // A broadcast modulus (n^2, p^2 or q^2) is converted once into QAT
+    // memory that every request of the call points at
+    if (m.getStride() == 0) {
+      HE_QAT_STATUS status = HE_QAT_memAllocContig(
+          reinterpret_cast<void**>(&shared_modulus), length,
+          BYTE_ALIGNMENT_64, HE_QAT_getNumaNode());
+      ERROR_CHECK(HE_QAT_STATUS_SUCCESS == status,
+                  "qatModExp: failed to allocate QAT memory");
+      try {
+        exportBigEndian(m.slice(0, 1), length, &shared_modulus);
+      } catch (...) {
+        HE_QAT_memFreeContig(reinterpret_cast<void**>(&shared_modulus));
+        throw;
+      }
+    }
+  }
 
-  unsigned int worksize = base.size();
-  unsigned int nslices = (worksize + batch_size - 1) / batch_size;
-  unsigned int residue = worksize % batch_size;
+  ~QatModExpOperands() {
+    HE_QAT_memFreeContig(reinterpret_cast<void**>(&shared_modulus));
+  }
 
-  batch_size = (nslices > 0) ? batch_size : worksize;
+  QatModExpOperands(const QatModExpOperands&) = delete;
+  QatModExpOperands& operator=(const QatModExpOperands&) = delete;
+
+  const BigNumberView& base;
+  const BigNumberView& exponent;
+  const BigNumberView& modulus;
+  int length;
+  int nbits;
+  unsigned char* shared_modulus;  // nullptr unless broadcast
+};
+
+// Convert values [offset, offset + n) straight into QAT requests reserved on
+// cq and submit them with consecutive tickets, the first one in first_ticket.
+// Results are left in QAT memory and read on completion.
+// Returns the number of requests submitted, less than n on failure. Requests
+// reserved and not submitted are given back, also when a conversion throws.
+static unsigned int submitQatChunk(HE_QAT_CompletionQueue* cq,
+                                   const QatModExpOperands& ops,
+                                   std::size_t offset, unsigned int n,
+                                   void* user_data,
+                                   HE_QAT_Ticket* first_ticket) {
+  unsigned char* bn_base_data_[IPCL_QAT_MODEXP_CHUNK_SIZE];
+  unsigned char* bn_exponent_data_[IPCL_QAT_MODEXP_CHUNK_SIZE];
+  unsigned char* bn_modulus_data_[IPCL_QAT_MODEXP_CHUNK_SIZE];
+  HE_QAT_BnModExpOperands ops_[IPCL_QAT_MODEXP_CHUNK_SIZE];
+
+  n = std::min<unsigned int>(n, IPCL_QAT_MODEXP_CHUNK_SIZE);
+  unsigned int reserved = 0;
+  while (reserved < n && HE_QAT_STATUS_SUCCESS ==
+                             HE_QAT_bnModExpReserve_Async(cq, ops.nbits,
+                                                          &ops_[reserved])) {
+    bn_base_data_[reserved] = ops_[reserved].base;
+    bn_exponent_data_[reserved] = ops_[reserved].exponent;
+    bn_modulus_data_[reserved] = ops_[reserved].modulus;
+    reserved++;
+  }
+  if (reserved == 0) return 0;
+
+  unsigned int submitted = 0;
+  auto cancel_rest = [&]() {
+    for (unsigned int i = submitted; i < reserved; i++)
+      HE_QAT_bnModExpCancel_Async(cq, &ops_[i]);
+  };
+
+  try {
+    exportBigEndian(ops.base.slice(offset, reserved), ops.length,
+                    bn_base_data_);
+    exportBigEndian(ops.exponent.slice(offset, reserved), ops.length,
+                    bn_exponent_data_);
+    if (ops.shared_modulus != nullptr) {
+      for (unsigned int i = 0; i < reserved; i++)
+        ops_[i].modulus = ops.shared_modulus;
+    } else {
+      exportBigEndian(ops.modulus.slice(offset, reserved), ops.length,
+                      bn_modulus_data_);
+    }
+  } catch (...) {
+    cancel_rest();
+    throw;
+  }
 
-  HE_QAT_STATUS status = HE_QAT_STATUS_FAIL;
+  for (; submitted < reserved; submitted++) {
+    HE_QAT_Ticket ticket;
+    if (HE_QAT_STATUS_SUCCESS !=
+        HE_QAT_bnModExpSubmit_Async(cq, nullptr, &ops_[submitted], user_data,
+                                    &ticket)) {
+      cancel_rest();
+      break;
+    }
+    if (submitted == 0) *first_ticket = ticket;
+  }
+  return submitted;
+}
 
-  unsigned char* bn_base_data_[batch_size];
-  unsigned char* bn_exponent_data_[batch_size];
-  unsigned char* bn_modulus_data_[batch_size];
-  unsigned char* bn_remainder_data_[batch_size];
+// Wait for every request submitted to cq, discarding the results
+static void drainCompletionQueue(HE_QAT_CompletionQueue* cq) {
+  HE_QAT_Completion completions[IPCL_QAT_MODEXP_CHUNK_SIZE];
+  while (wait_completion_queue(cq, completions, 1,
+                               IPCL_QAT_MODEXP_CHUNK_SIZE) > 0) {
+  }
+}
 
-  // Pre-allocate memory for data
-  for (int i = 0; i < batch_size; i++) {
-    bn_base_data_[i] = reinterpret_cast<unsigned char*>(
-        malloc(length * sizeof(unsigned char)));
-    bn_exponent_data_[i] = reinterpret_cast<unsigned char*>(
-        malloc(length * sizeof(unsigned char)));
+// Completion queue owned by a scope. When the scope is left by an
+// exception, the requests still in flight are waited for before the queue
+// is destroyed, so that none completes into a destroyed queue.
+class CompletionQueueGuard {
+ public:
+  CompletionQueueGuard() : m_cq(nullptr) {
+    HE_QAT_STATUS status = create_completion_queue(&m_cq);
+    ERROR_CHECK(HE_QAT_STATUS_SUCCESS == status,
+                "qatModExp: failed to create QAT completion queue");
+  }
 
-    bn_modulus_data_[i] = reinterpret_cast<unsigned char*>(
-        malloc(length * sizeof(unsigned char)));
-    bn_remainder_data_[i] = reinterpret_cast<unsigned char*>(
-        malloc(length * sizeof(unsigned char)));
+  ~CompletionQueueGuard() {
+    if (m_cq == nullptr) return;
+    drainCompletionQueue(m_cq);
+    destroy_completion_queue(m_cq);
+  }
 
-    ERROR_CHECK(
-        bn_base_data_[i] != nullptr && bn_exponent_data_[i] != nullptr &&
-            bn_modulus_data_[i] != nullptr && bn_remainder_data_[i] != nullptr,
-        "qatMultiBuffExp: alloc memory for error");
-  }  // End preparing input containers
+  CompletionQueueGuard(const CompletionQueueGuard&) = delete;
+  CompletionQueueGuard& operator=(const CompletionQueueGuard&) = delete;
+
+  HE_QAT_CompletionQueue* get() const { return m_cq; }
+
+  // Destroy the queue once every request has been harvested
+  HE_QAT_STATUS destroy() {
+    HE_QAT_STATUS status = destroy_completion_queue(m_cq);
+    if (HE_QAT_STATUS_SUCCESS == status) m_cq = nullptr;
+    return status;
+  }
+
+ private:
+  HE_QAT_CompletionQueue* m_cq;
+};
+
+// Chunk size and in-flight limit of a completion queue, from the batch size
+// and queue capacity of the context. Requests of the last harvest stay
+// reserved until the next one, so a chunk being submitted and one being
+// harvested must fit next to the requests in flight.
+struct QatWindow {
+  QatWindow() {
+    QATLimits limits = getQATLimits();
+    std::size_t capacity =
+        std::min<std::size_t>(limits.batch_size, limits.buffer_size);
+    chunk = std::max<std::size_t>(
+        1, std::min<std::size_t>(IPCL_QAT_MODEXP_CHUNK_SIZE, capacity / 4));
+    max_in_flight = capacity - 2 * chunk;
+  }
+
+  std::size_t chunk;
+  std::size_t max_in_flight;
+};
+
+// [Multi-Thread supported] QAT ModExp interface to offload computation to QAT
+// through a completion queue. Conversion, submission and harvesting overlap:
+// a chunk is converted and submitted while earlier chunks are processed, and
+// results are imported in completion order as they arrive.
+static std::vector<BigNumber> heQatBnModExp_Async(
+    const BigNumberView& base, const BigNumberView& exponent,
+    const BigNumberView& modulus) {
+  QatModExpOperands ops(base, exponent, modulus);
+  std::size_t worksize = base.size();
+
+  CompletionQueueGuard cq_guard;
+  HE_QAT_CompletionQueue* cq = cq_guard.get();
+
+  const QatWindow window;
+  std::vector<HE_QAT_Completion> completions(window.chunk);
 
   // Container to hold total number of outputs to be returned
   std::vector<BigNumber> remainder(worksize, 0);
 
-  // N batch process
-  for (unsigned int j = 0; j < nslices; j++) {
-    // Secure one of the distributed outstanding buffers
-    unsigned int buffer_id = 0;
-    status = acquire_bnModExp_buffer(&buffer_id);
-    if (HE_QAT_STATUS_SUCCESS != status) {
-      printf("Error: acquire_bnModExp_buffer()\n");
-      exit(1);
+  // Requests are submitted in index order to a queue of their own, so the
+  // ticket of a request is its index
+  std::size_t submitted = 0;
+  std::size_t completed = 0;
+  bool failed = false;
+  while (completed < worksize) {
+    std::size_t in_flight = submitted - completed;
+    if (submitted < worksize && in_flight < window.max_in_flight) {
+      unsigned int n = std::min(window.chunk, worksize - submitted);
+      HE_QAT_Ticket first_ticket;
+      unsigned int count =
+          submitQatChunk(cq, ops, submitted, n, nullptr, &first_ticket);
+      ERROR_CHECK(count == n, "qatModExp: failed to reserve QAT request");
+      submitted += n;
+      in_flight += n;
     }
 
-    int parallel_quantity =
-        ((j == nslices - 1) && (residue > 0)) ? residue : batch_size;
+    // Keep converting while there is room, otherwise wait for results
+    unsigned int count;
+    if (submitted < worksize && in_flight < window.max_in_flight)
+      count = poll_completion_queue(cq, completions.data(), window.chunk);
+    else
+      count = wait_completion_queue(cq, completions.data(), 1, window.chunk);
+
+    for (unsigned int i = 0; i < count; i++) {
+      const HE_QAT_Completion& c = completions[i];
+      if (HE_QAT_STATUS_SUCCESS != c.status ||
+          !BigNumber::fromBin(remainder[c.ticket], c.result, ops.length))
+        failed = true;
+    }
+    completed += count;
+  }
 
-    for (unsigned int i = 0; i < parallel_quantity; i++) {
-      memset(bn_base_data_[i], 0, length);
-      memset(bn_exponent_data_[i], 0, length);
-      memset(bn_modulus_data_[i], 0, length);
-      memset(bn_remainder_data_[i], 0, length);
+  HE_QAT_STATUS status = cq_guard.destroy();
+  ERROR_CHECK(HE_QAT_STATUS_SUCCESS == status,
+              "qatModExp: failed to destroy QAT completion queue");
+  ERROR_CHECK(!failed, "qatModExp: QAT modular exponentiation failed");
 
-      bool ret = false;
-      ret =
-          BigNumber::toBin(bn_base_data_[i], length, base[j * batch_size + i]);
-      if (!ret) {
-        printf("bn_base_data_: failed at bigNumberToBin()\n");
-        exit(1);
-      }
-      ret = BigNumber::toBin(bn_exponent_data_[i], length,
-                             exponent[j * batch_size + i]);
-      if (!ret) {
-        printf("bn_exponent_data_: failed at bigNumberToBin()\n");
-        exit(1);
-      }
+  return remainder;
+}
 
-      ret = BigNumber::toBin(bn_modulus_data_[i], length,
-                             modulus[j * batch_size + i]);
-      if (!ret) {
-        printf("bn_modulus_data_: failed at bigNumberToBin()\n");
-        exit(1);
+using Clock = std::chrono::steady_clock;
+
+static inline double elapsedSec(Clock::time_point since) {
+  return std::chrono::duration<double>(Clock::now() - since).count();
+}
+
+// Hybrid modexp call whose values are pulled chunk by chunk by the QAT feeder
+// and by the CPU workers until none is left. The feeder takes at most
+// qat_quota values, so that the CPU workers do not wait for the tail of a
+// slower QAT.
+class HybridJob {
+ public:
+  HybridJob(const BigNumberView& base, const BigNumberView& exp,
+            const BigNumberView& mod, std::vector<BigNumber>& res,
+            std::size_t qat_quota)
+      : ops(base, exp, mod),
+        res(res),
+        size(base.size()),
+        qat_quota(qat_quota),
+        qat_size(0),
+        qat_in_flight(0),
+        qat_sec(0.0),
+        failed(false),
+        start(Clock::now()),
+        m_next(0),
+        m_done(false) {}
+
+  // Take the next chunk of at most max_n values
+  bool take(std::size_t max_n, std::size_t& begin, std::size_t& n) {
+    if (m_next.load(std::memory_order_relaxed) >= size) return false;
+    begin = m_next.fetch_add(max_n);
+    if (begin >= size) return false;
+    n = std::min(max_n, size - begin);
+    return true;
+  }
+
+  // Take the next chunk of at most max_n values for QAT, within its quota
+  bool takeQat(std::size_t max_n, std::size_t& begin, std::size_t& n) {
+    if (qat_size >= qat_quota) return false;
+    return take(std::min(max_n, qat_quota - qat_size), begin, n);
+  }
+
+  bool drained() const { return m_next.load() >= size; }
+
+  // Nothing is left for the feeder to take
+  bool qatDrained() const { return qat_size >= qat_quota || drained(); }
+
+  // Stop handing out chunks, e.g. after an error on either side
+  void cancel() { m_next.store(size); }
+
+  // Called by the feeder once its last request has completed
+  void finish() {
+    qat_sec = elapsedSec(start);
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_done = true;
+    m_cv.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this] { return m_done; });
+  }
+
+  QatModExpOperands ops;
+  std::vector<BigNumber>& res;
+  const std::size_t size;
+  const std::size_t qat_quota;
+  // Owned by the feeder until finish()
+  std::size_t qat_size;
+  std::size_t qat_in_flight;
+  double qat_sec;
+  bool failed;
+  const Clock::time_point start;
+
+ private:
+  std::atomic<std::size_t> m_next;
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  bool m_done;
+};
+
+// Persistent thread keeping QAT fed with the chunks of every hybrid call in
+// progress. All the requests go through one completion queue, which only
+// exists while there is work, so that none is left at terminateContext().
+class QatFeeder {
+ public:
+  static QatFeeder& get() {
+    static QatFeeder feeder;
+    return feeder;
+  }
+
+  void post(HybridJob* job) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_pending.push_back(job);
+    m_cv.notify_one();
+  }
+
+  ~QatFeeder() {
+    {
+      std::lock_guard<std::mutex> lock(m_mtx);
+      m_stop = true;
+      m_cv.notify_one();
+    }
+    m_thread.join();
+  }
+
+ private:
+  // Requests of a chunk share the chunk as user data; a request's index
+  // follows from its ticket
+  struct Chunk {
+    HybridJob* job;
+    std::size_t begin;
+    HE_QAT_Ticket first_ticket;
+    unsigned int remaining;
+  };
+
+  QatFeeder() : m_stop(false), m_thread(&QatFeeder::run, this) {}
+
+  void run() {
+    std::vector<HybridJob*> active;
+    std::vector<HE_QAT_Completion> completions;
+    HE_QAT_CompletionQueue* cq = nullptr;
+    QatWindow window;
+    std::size_t in_flight = 0;
+
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        if (active.empty() && m_pending.empty()) {
+          if (cq != nullptr) {
+            destroy_completion_queue(cq);
+            cq = nullptr;
+          }
+          m_cv.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+          if (m_pending.empty()) return;
+        }
+        active.insert(active.end(), m_pending.begin(), m_pending.end());
+        m_pending.clear();
       }
 
-      status =
-          HE_QAT_bnModExp_MT(buffer_id, bn_remainder_data_[i], bn_base_data_[i],
-                             bn_exponent_data_[i], bn_modulus_data_[i], nbits);
+      // Without a queue, the CPU workers take all the values
+      if (cq == nullptr) {
+        if (HE_QAT_STATUS_SUCCESS != create_completion_queue(&cq)) {
+          cq = nullptr;
+          for (HybridJob* job : active) job->finish();
+          active.clear();
+          continue;
+        }
+        window = QatWindow();
+        completions.resize(window.chunk);
+      }
 
-      if (HE_QAT_STATUS_SUCCESS != status) {
-        HE_QAT_PRINT_ERR("\nQAT bnModExp with BigNumber failed\n");
+      // Feed: the jobs take turns, a chunk at a time. A conversion error
+      // fails its job, whose requests in flight are still harvested.
+      bool more = false;
+      for (HybridJob* job : active) {
+        std::size_t begin, n;
+        if (in_flight >= window.max_in_flight) break;
+        if (!job->takeQat(window.chunk, begin, n)) continue;
+        Chunk* chunk = new Chunk{job, begin, 0, 0};
+        unsigned int count = 0;
+        try {
+          count = submitQatChunk(cq, job->ops, begin, n, chunk,
+                                 &chunk->first_ticket);
+        } catch (...) {
+          job->cancel();
+        }
+        chunk->remaining = count;
+        if (count < n) job->failed = true;
+        if (count == 0) delete chunk;
+        job->qat_size += n;
+        job->qat_in_flight += count;
+        in_flight += count;
+        more = more || !job->qatDrained();
       }
-    }
 
-    release_bnModExp_buffer(buffer_id, parallel_quantity);
+      // Keep feeding while there is room, otherwise wait for results
+      unsigned int count = 0;
+      if (in_flight > 0) {
+        if (more && in_flight < window.max_in_flight)
+          count =
+              poll_completion_queue(cq, completions.data(), window.chunk);
+        else
+          count = wait_completion_queue(cq, completions.data(), 1,
+                                        window.chunk);
+      }
 
-    for (unsigned int i = 0; i < parallel_quantity; i++) {
-      unsigned char* bn_remainder_ = bn_remainder_data_[i];
-      bool ret = BigNumber::fromBin(remainder[j * batch_size + i],
-                                    bn_remainder_, length);
-      if (!ret) {
-        printf("residue bn_remainder_data_: failed at BigNumber::fromBin()\n");
-        exit(1);
+      for (unsigned int i = 0; i < count; i++) {
+        const HE_QAT_Completion& c = completions[i];
+        Chunk* chunk = static_cast<Chunk*>(c.user_data);
+        HybridJob* job = chunk->job;
+        std::size_t idx = chunk->begin + (c.ticket - chunk->first_ticket);
+        if (HE_QAT_STATUS_SUCCESS != c.status ||
+            !BigNumber::fromBin(job->res[idx], c.result, job->ops.length))
+          job->failed = true;
+        job->qat_in_flight--;
+        in_flight--;
+        if (--chunk->remaining == 0) delete chunk;
       }
-    }
-  }
 
-  // Free memory
-  for (unsigned int i = 0; i < batch_size; i++) {
-    free(bn_base_data_[i]);
-    bn_base_data_[i] = NULL;
-    free(bn_exponent_data_[i]);
-    bn_exponent_data_[i] = NULL;
-    free(bn_modulus_data_[i]);
-    bn_modulus_data_[i] = NULL;
-    free(bn_remainder_data_[i]);
-    bn_remainder_data_[i] = NULL;
+      // Retire the jobs with nothing left to take or in flight
+      auto retired = std::partition(active.begin(), active.end(),
+                                    [](HybridJob* job) {
+                                      return !job->qatDrained() ||
+                                             job->qat_in_flight > 0;
+                                    });
+      for (auto it = retired; it != active.end(); ++it) (*it)->finish();
+      active.erase(retired, active.end());
+    }
   }
 
-  return remainder;
-}
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  std::deque<HybridJob*> m_pending;
+  bool m_stop;
+  std::thread m_thread;
+};
 
 // QAT ModExp interface to offload computation to QAT
 [[deprecated(
-    "This funcion does NOT support multi-thread, use heQatBnModExp_MT "
+    "This funcion does NOT support multi-thread, use heQatBnModExp_Async "
     "instead.")]]  // NOLINT
 static std::vector<BigNumber>
 heQatBnModExp(const std::vector<BigNumber>& base,
@@ -443,9 +915,21 @@ heQatBnModExp(const std::vector<BigNumber>& base,
 }
 #endif  // IPCL_USE_QAT
 
-static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
-                                          const std::vector<BigNumber>& exp,
-                                          const std::vector<BigNumber>& mod) {
+// Batch buffers of the calling thread, allocated on its node and reused by
+// every batch it processes. They are reallocated when they are too small or
+// the thread has moved to another node.
+static int64u* getMBBuffers(std::size_t size) {
+  using NodeVector = std::vector<int64u, NodeLocalAllocator<int64u>>;
+  static thread_local NodeVector buff;
+  int node = getCurrentNode();
+  if (buff.size() < size || buff.get_allocator().node() != node)
+    NodeVector(size, NodeLocalAllocator<int64u>(node)).swap(buff);
+  return buff.data();
+}
+
+static std::vector<BigNumber> ippMBModExp(const BigNumberView& base,
+                                          const BigNumberView& exp,
+                                          const BigNumberView& mod) {
   std::size_t real_v_size = base.size();
   std::size_t pow_v_size = exp.size();
   std::size_t mod_v_size = mod.size();
@@ -489,9 +973,12 @@ static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
 
   int mod_dwords = BITSIZE_DWORD(mod_bits);
   int num_buff = IPCL_CRYPTO_MB_SIZE * mod_dwords;
-  std::vector<int64u> out_buff(num_buff);
-  std::vector<int64u> base_buff(num_buff);
-  std::vector<int64u> exp_buff(num_buff);
+  // batch buffers are placed on the node of the (pinned) calling worker;
+  // they are cleared, as operands are zero-extended to mod_bits
+  int64u* out_buff = getMBBuffers(3 * num_buff);
+  int64u* base_buff = out_buff + num_buff;
+  int64u* exp_buff = base_buff + num_buff;
+  std::fill(out_buff, out_buff + 3 * num_buff, 0);
 
   for (int i = 0; i < IPCL_CRYPTO_MB_SIZE; i++) {
     auto idx = i * mod_dwords;
@@ -506,7 +993,9 @@ static std::vector<BigNumber> ippMBModExp(const std::vector<BigNumber>& base,
   }
 
   int work_buff_size = mbx_exp_BufferSize(mod_bits);
-  auto work_buff = std::vector<Ipp8u>(work_buff_size);
+  static thread_local std::vector<Ipp8u> work_buff;
+  if (work_buff.size() < static_cast<std::size_t>(work_buff_size))
+    work_buff.resize(work_buff_size);
   // If actual sizes of modules are different,
   // set the mod_bits parameter equal to maximum size of the actual module in
   // bit size and extend all the modules with zero bits to the mod_bits value.
@@ -584,19 +1073,19 @@ static BigNumber ippSBModExp(const BigNumber& base, const BigNumber& exp,
   return res;
 }
 
-std::vector<BigNumber> qatModExp(const std::vector<BigNumber>& base,
-                                 const std::vector<BigNumber>& exp,
-                                 const std::vector<BigNumber>& mod) {
+std::vector<BigNumber> qatModExp(const BigNumberView& base,
+                                 const BigNumberView& exp,
+                                 const BigNumberView& mod) {
 #ifdef IPCL_USE_QAT
-  return heQatBnModExp_MT(base, exp, mod, IPCL_QAT_MODEXP_BATCH_SIZE);
+  return heQatBnModExp_Async(base, exp, mod);
 #else
   ERROR_CHECK(false, "qatModExp: Need to turn on IPCL_ENABLE_QAT");
 #endif  // IPCL_USE_QAT
 }
 
-static std::vector<BigNumber> ippMBModExpWrapper(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exp,
-    const std::vector<BigNumber>& mod) {
+static std::vector<BigNumber> ippMBModExpWrapper(const BigNumberView& base,
+                                                 const BigNumberView& exp,
+                                                 const BigNumberView& mod) {
   std::size_t v_size = base.size();
   std::vector<BigNumber> res(v_size);
 
@@ -604,57 +1093,37 @@ static std::vector<BigNumber> ippMBModExpWrapper(
   std::size_t num_chunk =
       (v_size + IPCL_CRYPTO_MB_SIZE - 1) / IPCL_CRYPTO_MB_SIZE;
 
-#ifdef IPCL_USE_OMP
-  int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, num_chunk))
-#endif  // IPCL_USE_OMP
-  for (std::size_t i = 0; i < num_chunk; i++) {
+  parallelFor(num_chunk, [&](std::size_t i) {
     std::size_t chunk_size = IPCL_CRYPTO_MB_SIZE;
     if ((i == (num_chunk - 1)) && (remainder > 0)) chunk_size = remainder;
 
     std::size_t chunk_offset = i * IPCL_CRYPTO_MB_SIZE;
 
-    auto base_start = base.begin() + chunk_offset;
-    auto base_end = base_start + chunk_size;
-
-    auto exp_start = exp.begin() + chunk_offset;
-    auto exp_end = exp_start + chunk_size;
-
-    auto mod_start = mod.begin() + chunk_offset;
-    auto mod_end = mod_start + chunk_size;
-
-    auto base_chunk = std::vector<BigNumber>(base_start, base_end);
-    auto exp_chunk = std::vector<BigNumber>(exp_start, exp_end);
-    auto mod_chunk = std::vector<BigNumber>(mod_start, mod_end);
-
-    auto tmp = ippMBModExp(base_chunk, exp_chunk, mod_chunk);
+    auto tmp = ippMBModExp(base.slice(chunk_offset, chunk_size),
+                           exp.slice(chunk_offset, chunk_size),
+                           mod.slice(chunk_offset, chunk_size));
     std::copy(tmp.begin(), tmp.end(), res.begin() + chunk_offset);
-  }
+  });
 
   return res;
 }
 
-static std::vector<BigNumber> ippSBModExpWrapper(
-    const std::vector<BigNumber>& base, const std::vector<BigNumber>& exp,
-    const std::vector<BigNumber>& mod) {
+static std::vector<BigNumber> ippSBModExpWrapper(const BigNumberView& base,
+                                                 const BigNumberView& exp,
+                                                 const BigNumberView& mod) {
   std::size_t v_size = base.size();
   std::vector<BigNumber> res(v_size);
 
-#ifdef IPCL_USE_OMP
-  int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
-#endif  // IPCL_USE_OMP
-  for (int i = 0; i < v_size; i++)
+  parallelFor(v_size, [&](std::size_t i) {
     res[i] = ippSBModExp(base[i], exp[i], mod[i]);
+  });
 
   return res;
 }
 
-std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
-                                 const std::vector<BigNumber>& exp,
-                                 const std::vector<BigNumber>& mod) {
+std::vector<BigNumber> ippModExp(const BigNumberView& base,
+                                 const BigNumberView& exp,
+                                 const BigNumberView& mod) {
   std::size_t v_size = base.size();
   std::vector<BigNumber> res(v_size);
 
@@ -677,17 +1146,31 @@ std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
 #endif  // IPCL_RUNTIME_DETECT_CPU_FEATURES
 }
 
-std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
-                              const std::vector<BigNumber>& exp,
-                              const std::vector<BigNumber>& mod) {
+std::vector<BigNumber> modExp(const BigNumberView& base,
+                              const BigNumberView& exp,
+                              const BigNumberView& mod) {
 #ifdef IPCL_USE_QAT
 // if QAT is ON, OMP is OFF --> use QAT only
 #if !defined(IPCL_USE_OMP)
   return qatModExp(base, exp, mod);
 #else
+  std::size_t v_size = base.size();
+
+  // In OPTIMAL mode, tagged operations use the learned split, small
+  // workloads are offloaded to QAT only
+  HybridOp op = g_hybrid_params.op;
+  int tuning_bits = 0;
+  if (isHybridOptimal() && op != HybridOp::NONE) {
+    if (v_size <= IPCL_WORKLOAD_SIZE_THRESHOLD) {
+      g_hybrid_params.ratio = IPCL_HYBRID_MODEXP_RATIO_FULL;
+    } else {
+      tuning_bits = tuningBits(mod.front().BitSize());
+      g_hybrid_params.ratio = getTunedRatio(op, tuning_bits);
+    }
+  }
+
   ERROR_CHECK(g_hybrid_params.ratio >= 0.0 && g_hybrid_params.ratio <= 1.0,
               "modExp: hybrid modexp qat ratio is incorrect");
-  std::size_t v_size = base.size();
   std::size_t hybrid_qat_size =
       static_cast<std::size_t>(g_hybrid_params.ratio * v_size);
 
@@ -698,36 +1181,44 @@ std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
     // use IPP only
     return ippModExp(base, exp, mod);
   } else {
-    // use QAT & IPP together
+    // use QAT & IPP together: the QAT feeder and the CPU workers pull chunks
+    // until none is left, so neither side idles while the other finishes.
+    // The ratio caps the share of QAT, the CPU workers take the rest.
     std::vector<BigNumber> res(v_size);
+    HybridJob job(base, exp, mod, res, hybrid_qat_size);
+    QatFeeder::get().post(&job);
+
+    // On a CPU error, the feeder still writes into job and res until its
+    // requests in flight have completed, so it is waited for before the
+    // exception leaves this scope
+    std::atomic<std::size_t> ipp_size(0);
+    try {
+      parallelFor(getNumThreads(), [&](std::size_t) {
+        std::size_t begin, n;
+        try {
+          while (job.take(IPCL_CRYPTO_MB_SIZE, begin, n)) {
+            std::vector<BigNumber> ipp_res =
+                ippModExp(base.slice(begin, n), exp.slice(begin, n),
+                          mod.slice(begin, n));
+            std::move(ipp_res.begin(), ipp_res.end(), res.begin() + begin);
+            ipp_size += n;
+          }
+        } catch (...) {
+          job.cancel();
+          throw;
+        }
+      });
+    } catch (...) {
+      job.wait();
+      throw;
+    }
+    double ipp_sec = elapsedSec(job.start);
 
-    auto qat_base_start = base.begin();
-    auto qat_base_end = qat_base_start + hybrid_qat_size;
-
-    auto qat_exp_start = exp.begin();
-    auto qat_exp_end = qat_exp_start + hybrid_qat_size;
-
-    auto qat_mod_start = mod.begin();
-    auto qat_mod_end = qat_mod_start + hybrid_qat_size;
-
-    auto qat_base = std::vector<BigNumber>(qat_base_start, qat_base_end);
-    auto qat_exp = std::vector<BigNumber>(qat_exp_start, qat_exp_end);
-    auto qat_mod = std::vector<BigNumber>(qat_mod_start, qat_mod_end);
-
-    auto ipp_base = std::vector<BigNumber>(qat_base_end, base.end());
-    auto ipp_exp = std::vector<BigNumber>(qat_exp_end, exp.end());
-    auto ipp_mod = std::vector<BigNumber>(qat_mod_end, mod.end());
-
-    std::vector<BigNumber> qat_res, ipp_res;
-    std::thread qat_thread([&] {
-      qat_res = qatModExp(qat_base, qat_exp, qat_mod);
-      std::copy(qat_res.begin(), qat_res.end(), res.begin());
-    });
-
-    ipp_res = ippModExp(ipp_base, ipp_exp, ipp_mod);
-    std::copy(ipp_res.begin(), ipp_res.end(), res.begin() + hybrid_qat_size);
-
-    qat_thread.join();
+    job.wait();
+    ERROR_CHECK(!job.failed, "modExp: QAT modular exponentiation failed");
+    if (tuning_bits > 0)
+      updateTuning(op, tuning_bits, job.qat_size, job.qat_sec, ipp_size,
+                   ipp_sec);
     return res;
   }
 #endif  // IPCL_USE_OMP
@@ -736,6 +1227,37 @@ std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
 #endif  // IPCL_USE_QAT
 }
 
+std::vector<BigNumber> modExp(const std::vector<BigNumber>& base,
+                              const std::vector<BigNumber>& exp,
+                              const std::vector<BigNumber>& mod) {
+  return modExp(BigNumberView(base), BigNumberView(exp), BigNumberView(mod));
+}
+
+std::vector<BigNumber> ippModExp(const std::vector<BigNumber>& base,
+                                 const std::vector<BigNumber>& exp,
+                                 const std::vector<BigNumber>& mod) {
+  return ippModExp(BigNumberView(base), BigNumberView(exp),
+                   BigNumberView(mod));
+}
+
+std::vector<BigNumber> qatModExp(const std::vector<BigNumber>& base,
+                                 const std::vector<BigNumber>& exp,
+                                 const std::vector<BigNumber>& mod) {
+  return qatModExp(BigNumberView(base), BigNumberView(exp),
+                   BigNumberView(mod));
+}
+
+std::vector<BigNumber> modExp(const BigNumberView& base,
+                              const BigNumberView& exp, const BigNumber& mod) {
+  return modExp(base, exp, BigNumberView::broadcast(mod, base.size()));
+}
+
+std::vector<BigNumber> modExp(const BigNumberView& base, const BigNumber& exp,
+                              const BigNumber& mod) {
+  return modExp(base, BigNumberView::broadcast(exp, base.size()),
+                BigNumberView::broadcast(mod, base.size()));
+}
+
 BigNumber modExp(const BigNumber& base, const BigNumber& exp,
                  const BigNumber& mod) {
   // QAT mod exp is NOT needed, when there is only 1 BigNumber.
@@ -18,6 +18,9 @@ PlainText::PlainText(const BigNumber& bn) : BaseText(bn) {}
 
 PlainText::PlainText(const std::vector<BigNumber>& bn_v) : BaseText(bn_v) {}
 
+PlainText::PlainText(const PlainTextView& pt_view)
+    : BaseText(pt_view.getView()) {}
+
 PlainText::PlainText(const PlainText& pt) : BaseText(pt) {}
 
 PlainText& PlainText::operator=(const PlainText& other) {
@@ -56,20 +59,36 @@ PlainText::operator std::vector<BigNumber>() const {
 
 PlainText PlainText::rotate(int shift) const {
   ERROR_CHECK(m_size != 1, "rotate: Cannot rotate single CipherText");
-  ERROR_CHECK(shift >= -m_size && shift <= m_size,
+  int size = static_cast<int>(m_size);
+  ERROR_CHECK(shift >= -size && shift <= size,
               "rotate: Cannot shift more than the test size");
 
-  if (shift == 0 || shift == m_size || shift == -m_size)
-    return PlainText(m_texts);
+  if (shift == 0 || shift == size || shift == -size) return PlainText(m_texts);
+
+  return PlainText(PlainTextView(*this).rotate(shift));
+}
+
+PlainTextView::PlainTextView(const PlainText& pt) : m_view(pt.getView()) {}
+
+PlainTextView::PlainTextView(const PlainText& pt, std::size_t start,
+                             std::size_t size, std::size_t stride)
+    : m_view(pt.getView(start, size, stride)) {}
+
+PlainTextView PlainTextView::slice(std::size_t start, std::size_t size,
+                                   std::size_t stride) const {
+  return PlainTextView(m_view.slice(start, size, stride));
+}
+
+PlainTextView PlainTextView::rotate(int shift) const {
+  return PlainTextView(m_view.rotate(shift));
+}
 
-  if (shift > 0)
-    shift = m_size - shift;
-  else
-    shift = -shift;
+CipherText PlainTextView::operator+(const CipherTextView& other) const {
+  return other.operator+(*this);
+}
 
-  std::vector<BigNumber> new_bn = getTexts();
-  std::rotate(std::begin(new_bn), std::begin(new_bn) + shift, std::end(new_bn));
-  return PlainText(new_bn);
+CipherText PlainTextView::operator*(const CipherTextView& other) const {
+  return other.operator*(*this);
 }
 
 }  // namespace ipcl
@@ -6,6 +6,8 @@
 #include <cstring>
 
 #include "crypto_mb/exp.h"
+#include "ipcl/fixed_bignum.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -63,6 +65,10 @@ PrivateKey::PrivateKey(const BigNumber& n, const BigNumber& p,
 }
 
 PlainText PrivateKey::decrypt(const CipherText& ct) const {
+  return decrypt(CipherTextView(ct));
+}
+
+PlainText PrivateKey::decrypt(const CipherTextView& ct) const {
   ERROR_CHECK(m_isInitialized, "decrypt: Private key is NOT initialized.");
   ERROR_CHECK(*(ct.getPubKey()->getN()) == *(this->getN()),
               "decrypt: The value of N in public key mismatch.");
@@ -71,15 +77,10 @@ PlainText PrivateKey::decrypt(const CipherText& ct) const {
   ERROR_CHECK(ct_size > 0, "decrypt: Cannot decrypt empty CipherText");
 
   std::vector<BigNumber> pt_bn(ct_size);
-  std::vector<BigNumber> ct_bn = ct.getTexts();
+  const BigNumberView& ct_bn = ct.getView();
 
-  // If hybrid OPTIMAL mode is used, use a special ratio
-  if (isHybridOptimal()) {
-    float qat_ratio = (ct_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
-                          ? IPCL_HYBRID_MODEXP_RATIO_FULL
-                          : IPCL_HYBRID_MODEXP_RATIO_DECRYPT;
-    setHybridRatio(qat_ratio, false);
-  }
+  // If hybrid OPTIMAL mode is used, use the split tuned for decryption
+  HybridOpScope hybrid_scope(HybridOp::DECRYPT);
 
   if (m_enable_crt)
     decryptCRT(pt_bn, ct_bn);
@@ -90,59 +91,55 @@ PlainText PrivateKey::decrypt(const CipherText& ct) const {
 }
 
 void PrivateKey::decryptRAW(std::vector<BigNumber>& plaintext,
-                            const std::vector<BigNumber>& ciphertext) const {
+                            const BigNumberView& ciphertext) const {
   std::size_t v_size = plaintext.size();
 
-  std::vector<BigNumber> pow_lambda(v_size, m_lambda);
-  std::vector<BigNumber> modulo(v_size, *m_nsquare);
-  std::vector<BigNumber> res = modExp(ciphertext, pow_lambda, modulo);
-
-#ifdef IPCL_USE_OMP
-  int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
-#endif  // IPCL_USE_OMP
-  for (int i = 0; i < v_size; i++) {
-    BigNumber nn = *m_n;
-    BigNumber xx = m_x;
-    BigNumber m = ((res[i] - 1) / nn) * xx;
-    plaintext[i] = m % nn;
-  }
+  std::vector<BigNumber> res = modExp(ciphertext, m_lambda, *m_nsquare);
+
+  parallelFor(
+      v_size,
+      [&](std::size_t i) {
+        BigNumber m = ((res[i] - 1) / *m_n) * m_x;
+        plaintext[i] = m % *m_n;
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
 }
 
 // CRT to calculate base^exp mod n^2
 void PrivateKey::decryptCRT(std::vector<BigNumber>& plaintext,
-                            const std::vector<BigNumber>& ciphertext) const {
+                            const BigNumberView& ciphertext) const {
   std::size_t v_size = plaintext.size();
 
   std::vector<BigNumber> basep(v_size), baseq(v_size);
-  std::vector<BigNumber> pm1(v_size, m_pminusone), qm1(v_size, m_qminusone);
-  std::vector<BigNumber> psq(v_size, m_psquare), qsq(v_size, m_qsquare);
-
-#ifdef IPCL_USE_OMP
-  int omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
-#endif  // IPCL_USE_OMP
-  for (int i = 0; i < v_size; i++) {
-    basep[i] = ciphertext[i] % psq[i];
-    baseq[i] = ciphertext[i] % qsq[i];
-  }
+
+  parallelFor(
+      v_size,
+      [&](std::size_t i) {
+        basep[i] = ciphertext[i] % m_psquare;
+        baseq[i] = ciphertext[i] % m_qsquare;
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
 
   // Based on the fact a^b mod n = (a mod n)^b mod n
-  std::vector<BigNumber> resp = modExp(basep, pm1, psq);
-  std::vector<BigNumber> resq = modExp(baseq, qm1, qsq);
-
-#ifdef IPCL_USE_OMP
-  omp_remaining_threads = OMPUtilities::MaxThreads;
-#pragma omp parallel for num_threads( \
-    OMPUtilities::assignOMPThreads(omp_remaining_threads, v_size))
-#endif  // IPCL_USE_OMP
-  for (int i = 0; i < v_size; i++) {
-    BigNumber dp = computeLfun(resp[i], *m_p) * m_hp % (*m_p);
-    BigNumber dq = computeLfun(resq[i], *m_q) * m_hq % (*m_q);
-    plaintext[i] = computeCRT(dp, dq);
-  }
+  std::vector<BigNumber> resp = modExp(basep, m_pminusone, m_psquare);
+  std::vector<BigNumber> resq = modExp(baseq, m_qminusone, m_qsquare);
+
+  parallelFor(
+      v_size,
+      [&](std::size_t i) {
+        resp[i] = computeLfun(resp[i], *m_p);
+        resq[i] = computeLfun(resq[i], *m_q);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+
+  std::vector<BigNumber> dp =
+      modMul(resp, BigNumberView::broadcast(m_hp, v_size), *m_p);
+  std::vector<BigNumber> dq =
+      modMul(resq, BigNumberView::broadcast(m_hq, v_size), *m_q);
+
+  parallelFor(
+      v_size, [&](std::size_t i) { plaintext[i] = computeCRT(dp[i], dq[i]); },
+      IPCL_PARALLEL_GRAIN_SIZE);
 }
 
 BigNumber PrivateKey::computeCRT(const BigNumber& mp,
@@ -10,7 +10,9 @@
 
 #include "crypto_mb/exp.h"
 #include "ipcl/ciphertext.hpp"
+#include "ipcl/fixed_bignum.hpp"
 #include "ipcl/mod_exp.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
@@ -49,44 +51,30 @@ void PublicKey::enableDJN() {
 }
 
 std::vector<BigNumber> PublicKey::getDJNObfuscator(std::size_t sz) const {
-  std::vector<BigNumber> r(sz);
-  std::vector<BigNumber> base(sz, m_hs);
-  std::vector<BigNumber> sq(sz, *m_nsquare);
-
-  if (m_testv) {
-    r = m_r;
-  } else {
-    for (auto& r_ : r) {
-      r_ = getRandomBN(m_randbits);
-    }
-  }
-  return modExp(base, r, sq);
+  std::vector<BigNumber> r = m_testv ? m_r : getRandomBNs(sz, m_randbits);
+  return modExp(BigNumberView::broadcast(m_hs, sz), r, *m_nsquare);
 }
 
 std::vector<BigNumber> PublicKey::getNormalObfuscator(std::size_t sz) const {
-  std::vector<BigNumber> r(sz);
-  std::vector<BigNumber> sq(sz, *m_nsquare);
-  std::vector<BigNumber> pown(sz, *m_n);
+  std::vector<BigNumber> r;
 
   if (m_testv) {
     r = m_r;
   } else {
-    for (int i = 0; i < sz; i++) {
-      r[i] = getRandomBN(m_bits);
-      r[i] = r[i] % (*m_n - 1) + 1;
-    }
+    r = getRandomBNs(sz, m_bits);
+    const BigNumber n_minus_1 = *m_n - 1;
+    parallelFor(
+        sz, [&](std::size_t i) { r[i] = r[i] % n_minus_1 + 1; },
+        IPCL_PARALLEL_GRAIN_SIZE);
   }
-  return modExp(r, pown, sq);
+  return modExp(r, *m_n, *m_nsquare);
 }
 
 void PublicKey::applyObfuscator(std::vector<BigNumber>& ciphertext) const {
   std::size_t sz = ciphertext.size();
   std::vector<BigNumber> obfuscator =
       m_enable_DJN ? getDJNObfuscator(sz) : getNormalObfuscator(sz);
-  BigNumber sq = *m_nsquare;
-
-  for (std::size_t i = 0; i < sz; ++i)
-    ciphertext[i] = sq.ModMul(ciphertext[i], obfuscator[i]);
+  ciphertext = modMul(ciphertext, obfuscator, *m_nsquare);
 }
 
 void PublicKey::setRandom(const std::vector<BigNumber>& r) {
@@ -96,13 +84,35 @@ void PublicKey::setRandom(const std::vector<BigNumber>& r) {
 
 void PublicKey::setHS(const BigNumber& hs) { m_hs = hs; }
 
-std::vector<BigNumber> PublicKey::raw_encrypt(const std::vector<BigNumber>& pt,
+std::uint64_t PublicKey::getFingerprint() const {
+  ERROR_CHECK(m_isInitialized,
+              "getFingerprint: Public key is NOT initialized.");
+
+  // 64-bit FNV-1a over the key length and the little-endian words of n
+  constexpr std::uint64_t fnv_offset = 0xcbf29ce484222325ULL;
+  constexpr std::uint64_t fnv_prime = 0x100000001b3ULL;
+  auto mix = [&](std::uint64_t h, Ipp32u word) {
+    for (int i = 0; i < 4; i++) {
+      h ^= (word >> (8 * i)) & 0xff;
+      h *= fnv_prime;
+    }
+    return h;
+  };
+
+  int n_bits;
+  Ipp32u* n_data;
+  ippsRef_BN(nullptr, &n_bits, &n_data, *m_n);
+
+  std::uint64_t h = mix(fnv_offset, static_cast<Ipp32u>(m_bits));
+  for (int i = 0; i < BITSIZE_WORD(n_bits); i++) h = mix(h, n_data[i]);
+  return h;
+}
+
+std::vector<BigNumber> PublicKey::raw_encrypt(const BigNumberView& pt,
                                               bool make_secure) const {
   std::size_t pt_size = pt.size();
-  BigNumber nsq = *m_nsquare;
-  std::vector<BigNumber> ct(pt_size);
-
-  for (std::size_t i = 0; i < pt_size; i++) ct[i] = (*m_n * pt[i] + 1) % nsq;
+  // (n * m + 1) mod n^2, m_nsquare is computed as n * n
+  std::vector<BigNumber> ct = mulPlusOneMod(*m_n, pt, *m_nsquare, true);
 
   if (make_secure) applyObfuscator(ct);
 
@@ -110,21 +120,20 @@ std::vector<BigNumber> PublicKey::raw_encrypt(const std::vector<BigNumber>& pt,
 }
 
 CipherText PublicKey::encrypt(const PlainText& pt, bool make_secure) const {
+  return encrypt(PlainTextView(pt), make_secure);
+}
+
+CipherText PublicKey::encrypt(const PlainTextView& pt, bool make_secure) const {
   ERROR_CHECK(m_isInitialized, "encrypt: Public key is NOT initialized.");
 
   std::size_t pt_size = pt.getSize();
   ERROR_CHECK(pt_size > 0, "encrypt: Cannot encrypt empty PlainText");
   std::vector<BigNumber> ct_bn_v(pt_size);
 
-  // If hybrid OPTIMAL mode is used, use a special ratio
-  if (isHybridOptimal()) {
-    float qat_ratio = (pt_size <= IPCL_WORKLOAD_SIZE_THRESHOLD)
-                          ? IPCL_HYBRID_MODEXP_RATIO_FULL
-                          : IPCL_HYBRID_MODEXP_RATIO_ENCRYPT;
-    setHybridRatio(qat_ratio, false);
-  }
+  // If hybrid OPTIMAL mode is used, use the split tuned for encryption
+  HybridOpScope hybrid_scope(HybridOp::ENCRYPT);
 
-  ct_bn_v = raw_encrypt(pt.getTexts(), make_secure);
+  ct_bn_v = raw_encrypt(pt.getView(), make_secure);
   return CipherText(*this, ct_bn_v);
 }
 
@@ -0,0 +1,370 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/raw_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/thread_pool.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+static const unsigned char g_raw_magic[4] = {'I', 'P', 'C', 'R'};
+static const unsigned char g_chunked_magic[4] = {'I', 'P', 'C', 'K'};
+constexpr std::size_t IPCL_CHUNKED_FRAME_HEADER_SIZE = 8;
+
+static inline Ipp32u toLE32(Ipp32u v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return __builtin_bswap32(v);
+#else
+  return v;
+#endif
+}
+
+static void storeLE(unsigned char* buf, std::uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) buf[i] = (v >> (8 * i)) & 0xff;
+}
+
+static std::uint64_t loadLE(const unsigned char* buf, int bytes) {
+  std::uint64_t v = 0;
+  for (int i = 0; i < bytes; i++)
+    v |= static_cast<std::uint64_t>(buf[i]) << (8 * i);
+  return v;
+}
+
+static void encodeHeader(const unsigned char* magic, const RawHeader& header,
+                         unsigned char* buf) {
+  std::memset(buf, 0, IPCL_RAW_HEADER_SIZE);
+  std::memcpy(buf, magic, 4);
+  storeLE(buf + 4, header.version, 2);
+  storeLE(buf + 6, sizeof(Ipp32u), 2);
+  storeLE(buf + 8, header.width, 4);
+  storeLE(buf + 16, header.fingerprint, 8);
+  storeLE(buf + 24, header.count, 8);
+}
+
+static RawHeader decodeHeader(const unsigned char* magic,
+                              const unsigned char* buf) {
+  ERROR_CHECK(std::memcmp(buf, magic, 4) == 0,
+              "decodeRawHeader: not a raw ciphertext header");
+
+  RawHeader header;
+  header.version = loadLE(buf + 4, 2);
+  ERROR_CHECK(header.version == IPCL_RAW_FORMAT_VERSION,
+              "decodeRawHeader: unsupported format version");
+  ERROR_CHECK(loadLE(buf + 6, 2) == sizeof(Ipp32u),
+              "decodeRawHeader: unsupported limb size");
+  header.width = loadLE(buf + 8, 4);
+  header.fingerprint = loadLE(buf + 16, 8);
+  header.count = loadLE(buf + 24, 8);
+  ERROR_CHECK(header.width > 0, "decodeRawHeader: invalid value width");
+  return header;
+}
+
+void encodeRawHeader(const RawHeader& header, unsigned char* buf) {
+  encodeHeader(g_raw_magic, header, buf);
+}
+
+RawHeader decodeRawHeader(const unsigned char* buf) {
+  return decodeHeader(g_raw_magic, buf);
+}
+
+std::uint32_t getRawWidth(const PublicKey& pk) {
+  return BITSIZE_WORD(pk.getNSQ()->BitSize());
+}
+
+void packRaw(const BigNumberView& src, std::size_t width, Ipp32u* dst) {
+  parallelFor(
+      src.size(),
+      [&](std::size_t i) {
+        IppsBigNumSGN sgn;
+        int bits;
+        Ipp32u* data;
+        ippsRef_BN(&sgn, &bits, &data, src[i]);
+        std::size_t words = BITSIZE_WORD(bits);
+        ERROR_CHECK(sgn == IppsBigNumPOS && words <= width,
+                    "packRaw: value does not fit in the raw width");
+
+        Ipp32u* out = dst + i * width;
+        for (std::size_t j = 0; j < words; j++) out[j] = toLE32(data[j]);
+        std::fill(out + words, out + width, 0);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+static void unpackRawInto(const Ipp32u* src, std::size_t width,
+                          std::size_t count, BigNumber* dst) {
+  parallelFor(
+      count,
+      [&](std::size_t i) {
+        const Ipp32u* in = src + i * width;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::vector<Ipp32u> limbs(in, in + width);
+        for (auto& l : limbs) l = toLE32(l);
+        in = limbs.data();
+#endif
+        dst[i] = BigNumber(in, width);
+      },
+      IPCL_PARALLEL_GRAIN_SIZE);
+}
+
+std::vector<BigNumber> unpackRaw(const Ipp32u* src, std::size_t width,
+                                 std::size_t count) {
+  std::vector<BigNumber> res(count);
+  unpackRawInto(src, width, count, res.data());
+  return res;
+}
+
+ChunkedWriter::ChunkedWriter(std::ostream& os, const PublicKey& pk)
+    : m_os(os), m_n(pk.getN()), m_width(getRawWidth(pk)), m_finished(false) {
+  RawHeader header;
+  header.version = IPCL_RAW_FORMAT_VERSION;
+  header.width = m_width;
+  header.fingerprint = pk.getFingerprint();
+  header.count = 0;
+
+  unsigned char hbuf[IPCL_RAW_HEADER_SIZE];
+  encodeHeader(g_chunked_magic, header, hbuf);
+  m_os.write(reinterpret_cast<const char*>(hbuf), IPCL_RAW_HEADER_SIZE);
+}
+
+void ChunkedWriter::write(const CipherTextView& chunk) {
+  ERROR_CHECK(!m_finished, "ChunkedWriter: container is already finished");
+  std::size_t count = chunk.getSize();
+  if (count == 0) return;  // an empty frame would end the container
+  ERROR_CHECK(count <= IPCL_CHUNKED_MAX_FRAME_SIZE,
+              "ChunkedWriter: chunk is larger than the frame size limit");
+  ERROR_CHECK(*(chunk.getPubKey()->getN()) == *m_n,
+              "ChunkedWriter: different public keys detected");
+
+  unsigned char fbuf[IPCL_CHUNKED_FRAME_HEADER_SIZE] = {0};
+  storeLE(fbuf, count, 4);
+  m_os.write(reinterpret_cast<const char*>(fbuf), sizeof(fbuf));
+
+  m_buf.resize(count * m_width);
+  packRaw(chunk.getView(), m_width, m_buf.data());
+  m_os.write(reinterpret_cast<const char*>(m_buf.data()),
+             m_buf.size() * sizeof(Ipp32u));
+  ERROR_CHECK(m_os.good(), "ChunkedWriter: failed to write the stream");
+}
+
+void ChunkedWriter::finish() {
+  if (m_finished) return;
+  unsigned char fbuf[IPCL_CHUNKED_FRAME_HEADER_SIZE] = {0};
+  m_os.write(reinterpret_cast<const char*>(fbuf), sizeof(fbuf));
+  m_os.flush();
+  m_finished = true;
+  ERROR_CHECK(m_os.good(), "ChunkedWriter: failed to write the stream");
+}
+
+ChunkedDecoder::ChunkedDecoder(const PublicKey& pk)
+    : m_pk(std::make_shared<PublicKey>(pk)),
+      m_width(getRawWidth(pk)),
+      m_frame_count(0),
+      m_frame_have(0) {
+  expect(State::HEADER, m_head, IPCL_RAW_HEADER_SIZE);
+}
+
+void ChunkedDecoder::expect(State state, unsigned char* target,
+                            std::size_t bytes) {
+  m_state = state;
+  m_target = target;
+  m_need = bytes;
+  m_have = 0;
+}
+
+// The payload buffer grows by one block as the bytes of the frame arrive, so
+// that a forged frame header cannot force a huge allocation
+void ChunkedDecoder::expectPayload() {
+  std::size_t n = std::min<std::size_t>(IPCL_RAW_IO_BLOCK_SIZE,
+                                        m_frame_count - m_frame_have);
+  m_payload.resize((m_frame_have + n) * m_width);
+  auto payload = reinterpret_cast<unsigned char*>(m_payload.data() +
+                                                  m_frame_have * m_width);
+  expect(State::PAYLOAD, payload, n * m_width * sizeof(Ipp32u));
+  m_frame_have += n;
+}
+
+// Called once the bytes of the current state are complete
+void ChunkedDecoder::advance() {
+  switch (m_state) {
+    case State::HEADER: {
+      RawHeader header = decodeHeader(g_chunked_magic, m_head);
+      ERROR_CHECK(header.fingerprint == m_pk->getFingerprint(),
+                  "ChunkedDecoder: container was encrypted with another key");
+      ERROR_CHECK(header.width == m_width,
+                  "ChunkedDecoder: value width does not match the key");
+      expect(State::FRAME, m_head, IPCL_CHUNKED_FRAME_HEADER_SIZE);
+      break;
+    }
+    case State::FRAME: {
+      m_frame_count = loadLE(m_head, 4);
+      if (m_frame_count == 0) {
+        expect(State::DONE, nullptr, 0);
+        break;
+      }
+      ERROR_CHECK(m_frame_count <= IPCL_CHUNKED_MAX_FRAME_SIZE,
+                  "ChunkedDecoder: frame is larger than the size limit");
+      m_payload.clear();
+      m_frame_have = 0;
+      expectPayload();
+      break;
+    }
+    case State::PAYLOAD: {
+      if (m_frame_have < m_frame_count) {
+        expectPayload();
+        break;
+      }
+      m_ready.emplace_back(
+          *m_pk, unpackRaw(m_payload.data(), m_width, m_frame_count));
+      expect(State::FRAME, m_head, IPCL_CHUNKED_FRAME_HEADER_SIZE);
+      break;
+    }
+    case State::DONE:
+      break;
+  }
+}
+
+std::size_t ChunkedDecoder::feed(const void* data, std::size_t size) {
+  auto bytes = static_cast<const unsigned char*>(data);
+  std::size_t consumed = 0;
+  while (m_state != State::DONE && consumed < size) {
+    std::size_t n = std::min(m_need - m_have, size - consumed);
+    std::memcpy(m_target + m_have, bytes + consumed, n);
+    m_have += n;
+    consumed += n;
+    if (m_have == m_need) advance();
+  }
+  return consumed;
+}
+
+bool ChunkedDecoder::next(CipherText& chunk) {
+  if (m_ready.empty()) return false;
+  chunk = m_ready.front();
+  m_ready.pop_front();
+  return true;
+}
+
+namespace serializer {
+
+void serializeRaw(std::ostream& os, const CipherText& ct) {
+  ERROR_CHECK(ct.getPubKey() != nullptr,
+              "serializeRaw: CipherText has no public key");
+  const auto& pk = *ct.getPubKey();
+  RawHeader header;
+  header.version = IPCL_RAW_FORMAT_VERSION;
+  header.width = getRawWidth(pk);
+  header.fingerprint = pk.getFingerprint();
+  header.count = ct.getSize();
+
+  unsigned char hbuf[IPCL_RAW_HEADER_SIZE];
+  encodeRawHeader(header, hbuf);
+  os.write(reinterpret_cast<const char*>(hbuf), IPCL_RAW_HEADER_SIZE);
+
+  BigNumberView values = ct.getView();
+  std::size_t block = std::min<std::size_t>(IPCL_RAW_IO_BLOCK_SIZE,
+                                            values.size());
+  std::vector<Ipp32u> buf(block * header.width);
+  for (std::size_t off = 0; off < values.size(); off += block) {
+    std::size_t n = std::min(block, values.size() - off);
+    packRaw(values.slice(off, n), header.width, buf.data());
+    os.write(reinterpret_cast<const char*>(buf.data()),
+             n * header.width * sizeof(Ipp32u));
+  }
+  ERROR_CHECK(os.good(), "serializeRaw: failed to write the stream");
+}
+
+void deserializeRaw(std::istream& is, const PublicKey& pk, CipherText& ct) {
+  unsigned char hbuf[IPCL_RAW_HEADER_SIZE];
+  is.read(reinterpret_cast<char*>(hbuf), IPCL_RAW_HEADER_SIZE);
+  ERROR_CHECK(is.good(), "deserializeRaw: failed to read the header");
+
+  RawHeader header = decodeRawHeader(hbuf);
+  ERROR_CHECK(header.fingerprint == pk.getFingerprint(),
+              "deserializeRaw: ciphertext was encrypted with another key");
+  ERROR_CHECK(header.width == getRawWidth(pk),
+              "deserializeRaw: value width does not match the key");
+
+  // The count comes from the stream: values are only allocated for the
+  // blocks actually read, so a forged header cannot force a huge allocation
+  std::size_t count = header.count;
+  std::size_t block = std::min<std::size_t>(IPCL_RAW_IO_BLOCK_SIZE, count);
+  std::vector<BigNumber> values;
+  values.reserve(block);
+  std::vector<Ipp32u> buf(block * header.width);
+  for (std::size_t off = 0; off < count; off += block) {
+    std::size_t n = std::min(block, count - off);
+    is.read(reinterpret_cast<char*>(buf.data()),
+            n * header.width * sizeof(Ipp32u));
+    ERROR_CHECK(is.good(), "deserializeRaw: truncated ciphertext data");
+    values.resize(off + n);
+    unpackRawInto(buf.data(), header.width, n, values.data() + off);
+  }
+  ct = CipherText(pk, std::move(values));
+}
+
+bool serializeRawToFile(const std::string& fn, const CipherText& ct) {
+  std::ofstream ofs(fn, std::ios::out | std::ios::binary);
+  if (ofs.is_open()) {
+    serializeRaw(ofs, ct);
+    ofs.close();
+    return true;
+  }
+  return false;
+}
+
+bool deserializeRawFromFile(const std::string& fn, const PublicKey& pk,
+                            CipherText& ct) {
+  std::ifstream ifs(fn, std::ios::in | std::ios::binary);
+  if (ifs.is_open()) {
+    deserializeRaw(ifs, pk, ct);
+    ifs.close();
+    return true;
+  }
+  return false;
+}
+
+void serializeChunked(std::ostream& os, const CipherText& ct,
+                      std::size_t chunk_size) {
+  ERROR_CHECK(ct.getPubKey() != nullptr,
+              "serializeChunked: CipherText has no public key");
+  ERROR_CHECK(chunk_size > 0 && chunk_size <= IPCL_CHUNKED_MAX_FRAME_SIZE,
+              "serializeChunked: invalid chunk size");
+
+  ChunkedWriter writer(os, *ct.getPubKey());
+  std::size_t size = ct.getSize();
+  for (std::size_t off = 0; off < size; off += chunk_size)
+    writer.write(CipherTextView(ct, off, std::min(chunk_size, size - off)));
+  writer.finish();
+}
+
+std::size_t deserializeChunked(std::istream& is, const PublicKey& pk,
+                               const CipherTextSink& sink) {
+  ChunkedDecoder decoder(pk);
+  std::vector<char> buf;
+  std::size_t total = 0;
+  CipherText chunk;
+  // read exactly what the decoder needs, so that the stream is left right
+  // after the container
+  while (!decoder.isFinished()) {
+    buf.resize(decoder.getBytesNeeded());
+    is.read(buf.data(), buf.size());
+    ERROR_CHECK(is.good(), "deserializeChunked: truncated container");
+    decoder.feed(buf.data(), buf.size());
+    while (decoder.next(chunk)) {
+      sink(total, chunk);
+      total += chunk.getSize();
+    }
+  }
+  return total;
+}
+
+}  // namespace serializer
+
+}  // namespace ipcl
@@ -0,0 +1,192 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/stream.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>  // NOLINT [build/c++11]
+#include <utility>
+
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+namespace {
+
+template <typename T>
+struct StreamChunk {
+  std::size_t offset;
+  T data;
+};
+
+// Fixed-capacity queue between two pipeline stages. close() lets the
+// consumer drain what is left, abort() drops it and wakes everybody up.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(std::size_t capacity)
+      : m_capacity(capacity), m_closed(false), m_aborted(false) {}
+
+  bool push(T&& item) {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_not_full.wait(lock, [this] {
+      return m_aborted || m_closed || m_items.size() < m_capacity;
+    });
+    if (m_aborted || m_closed) return false;
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_not_empty.wait(lock, [this] {
+      return m_aborted || m_closed || !m_items.empty();
+    });
+    if (m_aborted || m_items.empty()) return false;
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+  void abort() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_aborted = true;
+    m_items.clear();
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+ private:
+  std::size_t m_capacity;
+  bool m_closed;
+  bool m_aborted;
+  std::deque<T> m_items;
+  std::mutex m_mtx;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+};
+
+}  // namespace
+
+// Three-stage pipeline: a reader thread fills the input queue, the calling
+// thread runs the computation (and with it the thread pool / QAT), and a
+// writer thread drains the output queue into the sink in stream order.
+template <typename Out>
+static std::size_t runStreamPipeline(
+    const BigNumberReader& reader,
+    const std::function<Out(const std::vector<BigNumber>&)>& compute,
+    const std::function<void(std::size_t, const Out&)>& sink,
+    const StreamOptions& options) {
+  ERROR_CHECK(reader && sink, "stream: reader and sink must be set");
+  ERROR_CHECK(options.chunk_size > 0, "stream: chunk size must be positive");
+
+  std::size_t chunk_size = (options.chunk_size + IPCL_CRYPTO_MB_SIZE - 1) /
+                           IPCL_CRYPTO_MB_SIZE * IPCL_CRYPTO_MB_SIZE;
+  std::size_t capacity = std::max<std::size_t>(options.max_in_flight, 1);
+
+  BoundedQueue<StreamChunk<std::vector<BigNumber>>> in_q(capacity);
+  BoundedQueue<StreamChunk<Out>> out_q(capacity);
+
+  std::mutex err_mtx;
+  std::exception_ptr first_error;
+  auto fail = [&](std::exception_ptr e) {
+    {
+      std::lock_guard<std::mutex> lock(err_mtx);
+      if (!first_error) first_error = e;
+    }
+    in_q.abort();
+    out_q.abort();
+  };
+
+  std::thread read_thread([&] {
+    try {
+      std::size_t offset = 0;
+      while (true) {
+        std::vector<BigNumber> values;
+        values.reserve(chunk_size);
+        std::size_t n = reader(values, chunk_size);
+        if (n == 0) break;
+        ERROR_CHECK(n <= chunk_size && n == values.size(),
+                    "stream: reader returned an invalid chunk");
+        if (!in_q.push({offset, std::move(values)})) break;
+        offset += n;
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+    in_q.close();
+  });
+
+  std::size_t total = 0;
+  std::thread write_thread([&] {
+    try {
+      StreamChunk<Out> chunk;
+      while (out_q.pop(chunk)) {
+        sink(chunk.offset, chunk.data);
+        total += chunk.data.getSize();
+        chunk.data = Out();
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+  });
+
+  try {
+    StreamChunk<std::vector<BigNumber>> chunk;
+    while (in_q.pop(chunk)) {
+      StreamChunk<Out> result{chunk.offset, compute(chunk.data)};
+      chunk.data.clear();
+      if (!out_q.push(std::move(result))) break;
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  out_q.close();
+
+  read_thread.join();
+  write_thread.join();
+
+  if (first_error) std::rethrow_exception(first_error);
+  return total;
+}
+
+std::size_t encryptStream(const PublicKey& pk, const BigNumberReader& reader,
+                          const CipherTextSink& sink,
+                          const StreamOptions& options) {
+  bool make_secure = options.make_secure;
+  return runStreamPipeline<CipherText>(
+      reader,
+      [&](const std::vector<BigNumber>& values) {
+        return pk.encrypt(PlainTextView(BigNumberView(values)), make_secure);
+      },
+      sink, options);
+}
+
+std::size_t decryptStream(const PrivateKey& sk, const PublicKey& pk,
+                          const BigNumberReader& reader,
+                          const PlainTextSink& sink,
+                          const StreamOptions& options) {
+  auto pk_ptr = std::make_shared<PublicKey>(pk);
+  return runStreamPipeline<PlainText>(
+      reader,
+      [&](const std::vector<BigNumber>& values) {
+        return sk.decrypt(CipherTextView(pk_ptr, BigNumberView(values)));
+      },
+      sink, options);
+}
+
+}  // namespace ipcl
@@ -3,11 +3,73 @@
 
 #include "ipcl/utils/common.hpp"
 
+#include <unistd.h>
+
 #include "crypto_mb/exp.h"
+#include "ipcl/utils/drbg.hpp"
+#include "ipcl/utils/thread_pool.hpp"
 #include "ipcl/utils/util.hpp"
 
 namespace ipcl {
 
+/**
+ * IPP pseudo random generator context owned by one thread. It is seeded on
+ * first use, reseeded every IPCL_PRNG_RESEED_INTERVAL draws and in a forked
+ * child.
+ */
+class ThreadPRNG {
+ public:
+  IppsPRNGState* get() {
+    if (m_state.empty()) {
+      int size;
+      ippsPRNGGetSize(&size);
+      m_state.resize(size);
+      ippsPRNGInit(kSeedBits, context());
+      m_draws = IPCL_PRNG_RESEED_INTERVAL;
+    }
+    // A forked child reseeds, so that it never draws its parent's values
+    if (m_draws >= IPCL_PRNG_RESEED_INTERVAL || getpid() != m_pid) {
+      reseed();
+      m_draws = 0;
+    }
+    m_draws++;
+    return context();
+  }
+
+ private:
+  static constexpr int kSeedBits = 160;
+
+  IppsPRNGState* context() {
+    return reinterpret_cast<IppsPRNGState*>(m_state.data());
+  }
+
+  void reseed() {
+    // Every word of the seed comes from the entropy source
+    std::random_device dev;
+    auto seed = std::vector<Ipp32u>(BITSIZE_WORD(kSeedBits));
+    for (auto& x : seed) x = dev();
+    BigNumber seed_bn(seed.data(), seed.size(), IppsBigNumPOS);
+    ippsPRNGSetSeed(BN(seed_bn), context());
+    m_pid = getpid();
+  }
+
+  std::vector<Ipp8u> m_state;
+  int m_draws = 0;
+  pid_t m_pid = 0;
+};
+
+static IppsPRNGState* getThreadPRNG() {
+  static thread_local ThreadPRNG prng;
+  return prng.get();
+}
+
+// Fill the words of a bits-bit random number from the DRBG of the thread
+static void genDrbgWords(Ipp32u* rand, int bits) {
+  int len = BITSIZE_WORD(bits);
+  getThreadDrbg().generate(rand, len * sizeof(Ipp32u));
+  if (bits % 32) rand[len - 1] &= (1u << (bits % 32)) - 1;
+}
+
 void rand32u(std::vector<Ipp32u>& addr) {
   std::random_device dev;
   std::mt19937 rng(dev());
@@ -30,7 +92,11 @@ IppStatus ippGenRandom(Ipp32u* rand, int bits, void* ctx) {
       break;
     }
     case RNGenType::PSEUDO:
-      stat = ippsPRNGen(rand, bits, ctx);
+      stat = ippsPRNGen(rand, bits, ctx ? ctx : getThreadPRNG());
+      break;
+    case RNGenType::AES_CTR:
+      genDrbgWords(rand, bits);
+      stat = ippStsNoErr;
       break;
     default:
       ERROR_CHECK(false, "ippGenRandom: RNGenType does not exist.");
@@ -53,20 +119,17 @@ IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx) {
       } while ((stat != ippStsNoErr) && (count < IPCL_RDRAND_RETRIES));
       break;
     }
-    case RNGenType::PSEUDO: {
-      int seed_size = 160;
-      int size;
-      ippsPRNGGetSize(&size);
-      auto prng = std::vector<Ipp8u>(size);
-      ippsPRNGInit(seed_size, reinterpret_cast<IppsPRNGState*>(prng.data()));
-
-      auto seed = std::vector<Ipp32u>(seed_size);
-      rand32u(seed);
-      BigNumber seed_bn(seed.data(), seed_size, IppsBigNumPOS);
-      ippsPRNGSetSeed(BN(seed_bn),
-                      reinterpret_cast<IppsPRNGState*>(prng.data()));
+    case RNGenType::PSEUDO:
       stat = ippsPRNGen_BN(rand, bits,
-                           reinterpret_cast<IppsPRNGState*>(prng.data()));
+                           ctx ? reinterpret_cast<IppsPRNGState*>(ctx)
+                               : getThreadPRNG());
+      break;
+    case RNGenType::AES_CTR: {
+      static thread_local std::vector<Ipp32u> words;
+      int len = BITSIZE_WORD(bits);
+      if (words.size() < static_cast<std::size_t>(len)) words.resize(len);
+      genDrbgWords(words.data(), bits);
+      stat = ippsSet_BN(IppsBigNumPOS, len, words.data(), rand);
       break;
     }
     default:
@@ -76,28 +139,33 @@ IppStatus ippGenRandomBN(IppsBigNumState* rand, int bits, void* ctx) {
   return stat;
 }
 
-BigNumber getRandomBN(int bits) {
-  IppStatus stat;
-  int bn_buf_size;
-
-  int bn_len = BITSIZE_WORD(bits);
-  stat = ippsBigNumGetSize(bn_len, &bn_buf_size);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "getRandomBN: get IppsBigNumState context error.");
-
-  IppsBigNumState* pBN =
-      reinterpret_cast<IppsBigNumState*>(alloca(bn_buf_size));
-  ERROR_CHECK(pBN != nullptr, "getRandomBN: big number alloca error");
-
-  stat = ippsBigNumInit(bn_len, pBN);
-  ERROR_CHECK(stat == ippStsNoErr,
-              "getRandomBN: init big number context error.");
+static void fillRandomBN(BigNumber& bn, int bits) {
+  // word buffer of the calling thread, grown to the largest size requested
+  static thread_local std::vector<Ipp32u> words;
+  int len = BITSIZE_WORD(bits);
+  if (words.size() < static_cast<std::size_t>(len)) words.resize(len);
 
-  stat = ippGenRandomBN(pBN, bits, NULL);
+  IppStatus stat = ippGenRandom(words.data(), bits, nullptr);
   ERROR_CHECK(stat == ippStsNoErr,
               "getRandomBN:  generate random big number error.");
+  if (bits % 32) words[len - 1] &= (1u << (bits % 32)) - 1;
+  bn.Assign(words.data(), len);
+}
+
+BigNumber getRandomBN(int bits) {
+  ERROR_CHECK(bits > 0, "getRandomBN: bits must be positive");
+  BigNumber bn;
+  fillRandomBN(bn, bits);
+  return bn;
+}
 
-  return BigNumber{pBN};
+std::vector<BigNumber> getRandomBNs(std::size_t count, int bits) {
+  ERROR_CHECK(bits > 0, "getRandomBNs: bits must be positive");
+  std::vector<BigNumber> res(count);
+  parallelFor(
+      count, [&](std::size_t i) { fillRandomBN(res[i], bits); },
+      IPCL_PARALLEL_GRAIN_SIZE);
+  return res;
 }
 
 }  // namespace ipcl
@@ -3,9 +3,12 @@
 
 #include "ipcl/utils/context.hpp"
 
+#include <algorithm>
 #include <map>
 #include <string>
 
+#include "ipcl/utils/common.hpp"
+
 #ifdef IPCL_USE_QAT
 #include <heqat/context.h>
 #endif
@@ -27,31 +30,73 @@ const std::map<std::string, FeatureValue> hasFeatureMap = {
     {"4xxx", FeatureValue::QAT4XXX},
     {"qat_4xxx", FeatureValue::QAT4XXX}};
 
+static unsigned int qatBatchSize = IPCL_QAT_MODEXP_BATCH_SIZE;
+
 #ifdef IPCL_USE_QAT
 bool hasQAT = false;
 static bool isUsingQAT = false;
-static bool initializeQATContext() {
-  if (!isUsingQAT && HE_QAT_STATUS_SUCCESS == acquire_qat_devices())
-    return (isUsingQAT = true);
+static bool initializeQATContext(const HE_QAT_Limits* limits) {
+  if (isUsingQAT) return false;
+  HE_QAT_STATUS status = (nullptr == limits)
+                             ? acquire_qat_devices()
+                             : acquire_qat_devices_with_limits(limits);
+  if (HE_QAT_STATUS_SUCCESS == status) return (isUsingQAT = true);
   return false;
 }
-#endif
 
-bool initializeContext(const std::string runtime_choice) {
-#ifdef IPCL_USE_QAT
+static bool initializeRuntime(const std::string& runtime_choice,
+                              const HE_QAT_Limits* limits) {
   hasQAT = true;
   switch (runtimeMap.at(runtime_choice)) {
     case RuntimeValue::QAT:
-      return initializeQATContext();
+      return initializeQATContext(limits);
     case RuntimeValue::CPU:
     case RuntimeValue::HYBRID:
     case RuntimeValue::DEFAULT:
     default:
       return true;
   }
-#else   // Default behavior: CPU choice
+}
+#endif
+
+bool initializeContext(const std::string runtime_choice) {
+#ifdef IPCL_USE_QAT
+  if (!initializeRuntime(runtime_choice, nullptr)) return false;
+#endif  // IPCL_USE_QAT
+  qatBatchSize = IPCL_QAT_MODEXP_BATCH_SIZE;
   return true;
+}
+
+bool initializeContext(const std::string runtime_choice,
+                       const QATLimits& qat_limits) {
+  unsigned int batch_size = qat_limits.batch_size ? qat_limits.batch_size
+                                                  : IPCL_QAT_MODEXP_BATCH_SIZE;
+#ifdef IPCL_USE_QAT
+  HE_QAT_Limits limits = {qat_limits.num_instances, qat_limits.buffer_size,
+                          qat_limits.buffer_count};
+  unsigned int buffer_size =
+      qat_limits.buffer_size ? qat_limits.buffer_size : HE_QAT_BUFFER_SIZE;
+  if (std::min(batch_size, buffer_size) < 4) return false;
+  if (!initializeRuntime(runtime_choice, &limits)) return false;
+#else   // Default behavior: CPU choice
+  if (batch_size < 4) return false;
 #endif  // IPCL_USE_QAT
+  // A failed call keeps the batch size of the context already running
+  qatBatchSize = batch_size;
+  return true;
+}
+
+QATLimits getQATLimits() {
+  QATLimits limits;
+#ifdef IPCL_USE_QAT
+  HE_QAT_Limits qat_limits;
+  get_qat_limits(&qat_limits);
+  limits.num_instances = qat_limits.num_instances;
+  limits.buffer_size = qat_limits.buffer_size;
+  limits.buffer_count = qat_limits.buffer_count;
+#endif
+  limits.batch_size = qatBatchSize;
+  return limits;
 }
 
 bool terminateContext() {
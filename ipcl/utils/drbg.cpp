@@ -0,0 +1,248 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/drbg.hpp"
+
+#include <immintrin.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "ipcl/utils/common.hpp"
+#include "ipcl/utils/util.hpp"
+
+#define IPCL_TARGET_AES __attribute__((target("aes,sse4.1")))
+#define IPCL_TARGET_VAES __attribute__((target("aes,vaes,avx512f")))
+
+namespace ipcl {
+
+constexpr int kRounds = 14;  // AES-256
+constexpr int kRdseedRetries = 64;
+
+static const bool has_aesni = __builtin_cpu_supports("aes");
+static const bool has_vaes =
+    __builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512f");
+static const bool has_rdseed = __builtin_cpu_supports("rdseed");
+static const bool has_rdrand = __builtin_cpu_supports("rdrnd");
+
+__attribute__((target("rdseed"))) static bool rdseed64(
+    unsigned long long* val) {  // NOLINT [runtime/int]
+  for (int i = 0; i < kRdseedRetries; i++) {
+    if (_rdseed64_step(val)) return true;
+    _mm_pause();
+  }
+  return false;
+}
+
+__attribute__((target("rdrnd"))) static bool rdrand64(
+    unsigned long long* val) {  // NOLINT [runtime/int]
+  for (int i = 0; i < IPCL_RDRAND_RETRIES; i++) {
+    if (_rdrand64_step(val)) return true;
+  }
+  return false;
+}
+
+// Fill out with len bytes of entropy for (re)seeding
+static void getEntropy(unsigned char* out, std::size_t len) {
+  std::random_device dev;
+  for (std::size_t off = 0; off < len; off += 8) {
+    unsigned long long val;  // NOLINT [runtime/int]
+    if (!(has_rdseed && rdseed64(&val)) && !(has_rdrand && rdrand64(&val)))
+      val = (static_cast<std::uint64_t>(dev()) << 32) | dev();
+    std::memcpy(out + off, &val, std::min<std::size_t>(8, len - off));
+  }
+}
+
+static void secureZero(void* ptr, std::size_t len) {
+  volatile unsigned char* p = static_cast<volatile unsigned char*>(ptr);
+  while (len--) *p++ = 0;
+}
+
+IPCL_TARGET_AES static inline __m128i expandEven(__m128i key,
+                                                 __m128i assist) {
+  assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+IPCL_TARGET_AES static inline __m128i expandOdd(__m128i key, __m128i assist) {
+  return expandEven(key, _mm_shuffle_epi32(assist, _MM_SHUFFLE(2, 2, 2, 2)));
+}
+
+// AES-256 key schedule of FIPS 197
+IPCL_TARGET_AES static void expandKey256(const unsigned char* key,
+                                         unsigned char* round_keys) {
+  __m128i* rk = reinterpret_cast<__m128i*>(round_keys);
+  rk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+  rk[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 16));
+#define IPCL_EXPAND_ROUND(i, rcon)                                          \
+  rk[i] = expandEven(rk[i - 2], _mm_aeskeygenassist_si128(rk[i - 1], rcon)); \
+  rk[i + 1] = expandOdd(rk[i - 1], _mm_aeskeygenassist_si128(rk[i], 0x00));
+  IPCL_EXPAND_ROUND(2, 0x01)
+  IPCL_EXPAND_ROUND(4, 0x02)
+  IPCL_EXPAND_ROUND(6, 0x04)
+  IPCL_EXPAND_ROUND(8, 0x08)
+  IPCL_EXPAND_ROUND(10, 0x10)
+  IPCL_EXPAND_ROUND(12, 0x20)
+#undef IPCL_EXPAND_ROUND
+  rk[14] = expandEven(rk[12], _mm_aeskeygenassist_si128(rk[13], 0x40));
+}
+
+// Encrypt blocks with AES-NI, 8 independent blocks in flight
+IPCL_TARGET_AES static void encryptAESNI(const unsigned char* round_keys,
+                                         const __m128i* in, unsigned char* out,
+                                         std::size_t blocks) {
+  const __m128i* rk = reinterpret_cast<const __m128i*>(round_keys);
+  __m128i* dst = reinterpret_cast<__m128i*>(out);
+  std::size_t i = 0;
+  for (; i + 8 <= blocks; i += 8) {
+    __m128i b[8];
+    for (int j = 0; j < 8; j++) b[j] = _mm_xor_si128(in[i + j], rk[0]);
+    for (int r = 1; r < kRounds; r++)
+      for (int j = 0; j < 8; j++) b[j] = _mm_aesenc_si128(b[j], rk[r]);
+    for (int j = 0; j < 8; j++)
+      _mm_storeu_si128(dst + i + j, _mm_aesenclast_si128(b[j], rk[kRounds]));
+  }
+  for (; i < blocks; i++) {
+    __m128i b = _mm_xor_si128(in[i], rk[0]);
+    for (int r = 1; r < kRounds; r++) b = _mm_aesenc_si128(b, rk[r]);
+    _mm_storeu_si128(dst + i, _mm_aesenclast_si128(b, rk[kRounds]));
+  }
+}
+
+// Round key in all four lanes. The zero-masked form is used because the
+// unmasked broadcast reads an undefined passthrough register.
+IPCL_TARGET_VAES static inline __m512i broadcastKey(const __m128i* rk) {
+  return _mm512_maskz_broadcast_i32x4(0xffff, _mm_load_si128(rk));
+}
+
+// Encrypt 16 blocks with VAES, 4 blocks per 512-bit register
+IPCL_TARGET_VAES static void encrypt16VAES(const unsigned char* round_keys,
+                                           const __m128i* in,
+                                           unsigned char* out) {
+  const __m128i* rk = reinterpret_cast<const __m128i*>(round_keys);
+  __m512i k = broadcastKey(rk);
+  __m512i b[4];
+  for (int j = 0; j < 4; j++)
+    b[j] = _mm512_xor_si512(_mm512_loadu_si512(in + 4 * j), k);
+  for (int r = 1; r < kRounds; r++) {
+    k = broadcastKey(rk + r);
+    for (int j = 0; j < 4; j++) b[j] = _mm512_aesenc_epi128(b[j], k);
+  }
+  k = broadcastKey(rk + kRounds);
+  for (int j = 0; j < 4; j++)
+    _mm512_storeu_si512(out + 64 * j, _mm512_aesenclast_epi128(b[j], k));
+}
+
+bool AesCtrDrbg::isSupported() { return has_aesni; }
+
+AesCtrDrbg::AesCtrDrbg() {
+  ERROR_CHECK(isSupported(), "AesCtrDrbg: CPU does not support AES-NI");
+  unsigned char seed[kSeedLen];
+  getEntropy(seed, kSeedLen);
+  instantiate(seed);
+  secureZero(seed, kSeedLen);
+}
+
+AesCtrDrbg::AesCtrDrbg(const unsigned char* seed) {
+  ERROR_CHECK(isSupported(), "AesCtrDrbg: CPU does not support AES-NI");
+  instantiate(seed);
+}
+
+AesCtrDrbg::~AesCtrDrbg() {
+  secureZero(m_round_keys, sizeof(m_round_keys));
+  m_v_hi = m_v_lo = 0;
+}
+
+void AesCtrDrbg::instantiate(const unsigned char* seed) {
+  const unsigned char zero_key[kKeyLen] = {0};
+  expandKey256(zero_key, m_round_keys);
+  m_v_hi = m_v_lo = 0;
+  update(seed);
+  m_reseed_counter = 1;
+  m_pid = getpid();
+}
+
+void AesCtrDrbg::reseed() {
+  unsigned char seed[kSeedLen];
+  getEntropy(seed, kSeedLen);
+  reseed(seed);
+  secureZero(seed, kSeedLen);
+}
+
+void AesCtrDrbg::reseed(const unsigned char* seed) {
+  update(seed);
+  m_reseed_counter = 1;
+  m_pid = getpid();
+}
+
+void AesCtrDrbg::generateBlocks(unsigned char* out, std::size_t blocks) {
+  constexpr std::size_t kBatch = 16;
+  alignas(64) __m128i ctr[kBatch];
+  while (blocks > 0) {
+    std::size_t n = std::min(blocks, kBatch);
+    // V = (V + 1) mod 2^128, encrypted as a big-endian block
+    for (std::size_t i = 0; i < n; i++) {
+      m_v_hi += (++m_v_lo == 0);
+      ctr[i] = _mm_set_epi64x(__builtin_bswap64(m_v_lo),
+                              __builtin_bswap64(m_v_hi));
+    }
+    if (n == kBatch && has_vaes)
+      encrypt16VAES(m_round_keys, ctr, out);
+    else
+      encryptAESNI(m_round_keys, ctr, out, n);
+    out += n * kBlockLen;
+    blocks -= n;
+  }
+}
+
+// CTR_DRBG_Update of SP 800-90A 10.2.1.2
+void AesCtrDrbg::update(const unsigned char* provided) {
+  unsigned char temp[kSeedLen];
+  generateBlocks(temp, kSeedLen / kBlockLen);
+  for (int i = 0; i < kSeedLen; i++) temp[i] ^= provided[i];
+  expandKey256(temp, m_round_keys);
+
+  std::uint64_t hi, lo;
+  std::memcpy(&hi, temp + kKeyLen, 8);
+  std::memcpy(&lo, temp + kKeyLen + 8, 8);
+  m_v_hi = __builtin_bswap64(hi);
+  m_v_lo = __builtin_bswap64(lo);
+  secureZero(temp, kSeedLen);
+}
+
+void AesCtrDrbg::generate(void* out, std::size_t len) {
+  const unsigned char zeros[kSeedLen] = {0};
+  unsigned char* dst = static_cast<unsigned char*>(out);
+  while (len > 0) {
+    // A forked child reseeds, so that it never repeats its parent's stream
+    if (m_reseed_counter > IPCL_DRBG_RESEED_INTERVAL || getpid() != m_pid)
+      reseed();
+
+    std::size_t n = std::min(len, kMaxRequest);
+    std::size_t full = n / kBlockLen;
+    generateBlocks(dst, full);
+    if (n % kBlockLen) {
+      unsigned char tail[kBlockLen];
+      generateBlocks(tail, 1);
+      std::memcpy(dst + full * kBlockLen, tail, n % kBlockLen);
+      secureZero(tail, kBlockLen);
+    }
+    update(zeros);
+    m_reseed_counter++;
+
+    dst += n;
+    len -= n;
+  }
+}
+
+AesCtrDrbg& getThreadDrbg() {
+  static thread_local AesCtrDrbg drbg;
+  return drbg;
+}
+
+}  // namespace ipcl
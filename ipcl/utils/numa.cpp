@@ -0,0 +1,106 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/numa.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace ipcl {
+
+// Allocations below this size stay on the heap; pinned workers already get
+// node-local pages for them through first-touch.
+constexpr std::size_t IPCL_NUMA_MIN_ALLOC_BYTES = 4096;
+// mbind policy from <linux/mempolicy.h>
+constexpr int IPCL_MPOL_PREFERRED = 1;
+
+const linuxCPUTopology& getCPUTopology() {
+  static const linuxCPUTopology topology = getLinuxCPUTopologyImpl();
+  return topology;
+}
+
+bool isNUMAEnabled() {
+  static const bool enabled = (std::getenv("IPCL_DISABLE_NUMA") == nullptr) &&
+                              (getCPUTopology().nodes.size() > 1);
+  return enabled;
+}
+
+int getCurrentNode() {
+  const auto& nodes = getCPUTopology().nodes;
+  if (nodes.size() < 2) return 0;
+
+  int cpu = sched_getcpu();
+  for (std::size_t i = 0; i < nodes.size(); i++) {
+    if (std::find(nodes[i].cpus.begin(), nodes[i].cpus.end(), cpu) !=
+        nodes[i].cpus.end())
+      return i;
+  }
+  return 0;
+}
+
+bool bindThreadToNode(int node) {
+  const auto& nodes = getCPUTopology().nodes;
+  if (node < 0 || node >= static_cast<int>(nodes.size())) return false;
+
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : nodes[node].cpus)
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpuset);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+static bool useNodeAlloc(std::size_t bytes) {
+  return isNUMAEnabled() && bytes >= IPCL_NUMA_MIN_ALLOC_BYTES;
+}
+
+void* allocOnNode(std::size_t bytes, int node) {
+  if (!useNodeAlloc(bytes)) return ::operator new(bytes);
+
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) throw std::bad_alloc();
+
+  // Preferred (not strict) policy: fall back to other nodes when full. A
+  // failed mbind only loses placement, so its result is ignored.
+  const auto& nodes = getCPUTopology().nodes;
+  if (node >= 0 && node < static_cast<int>(nodes.size())) {
+    constexpr std::size_t bits = 8 * sizeof(unsigned long);  // NOLINT
+    int id = nodes[node].id;
+    std::vector<unsigned long> mask(id / bits + 1, 0);  // NOLINT
+    mask[id / bits] = 1UL << (id % bits);
+    syscall(SYS_mbind, ptr, bytes, IPCL_MPOL_PREFERRED, mask.data(),
+            mask.size() * bits + 1, 0);
+  }
+  return ptr;
+}
+
+void freeOnNode(void* ptr, std::size_t bytes) {
+  if (ptr == nullptr) return;
+  if (!useNodeAlloc(bytes))
+    ::operator delete(ptr);
+  else
+    munmap(ptr, bytes);
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> partitionByNode(
+    std::size_t size, std::size_t num_nodes, std::size_t align) {
+  if (num_nodes == 0) num_nodes = 1;
+  if (align == 0) align = 1;
+
+  std::size_t units = (size + align - 1) / align;
+  std::vector<std::pair<std::size_t, std::size_t>> slices(num_nodes);
+  for (std::size_t i = 0; i < num_nodes; i++) {
+    std::size_t begin = std::min(size, units * i / num_nodes * align);
+    std::size_t end = std::min(size, units * (i + 1) / num_nodes * align);
+    slices[i] = {begin, end};
+  }
+  return slices;
+}
+
+}  // namespace ipcl
@@ -3,7 +3,10 @@
 
 #include "ipcl/utils/parse_cpuinfo.hpp"
 
+#include <sched.h>
+
 #include <fstream>
+#include <set>
 #include <sstream>
 
 ipcl::linuxCPUInfo ipcl::getLinuxCPUInfoImpl(void) {
@@ -11,3 +14,73 @@ ipcl::linuxCPUInfo ipcl::getLinuxCPUInfoImpl(void) {
   ipcl::parseCPUInfo(info);
   return info;
 }
+
+static bool readSysfsLine(const std::string& path, std::string& line) {
+  std::ifstream ifs(path, std::ios::in);
+  return ifs.is_open() && std::getline(ifs, line);
+}
+
+ipcl::linuxCPUTopology ipcl::getLinuxCPUTopologyImpl(void) {
+  const std::string sys_cpu = "/sys/devices/system/cpu/";
+  const std::string sys_node = "/sys/devices/system/node/";
+
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  bool has_mask = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  auto usable = [&](int cpu) {
+    if (cpu < 0) return false;
+    return !has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+  };
+
+  ipcl::linuxCPUTopology topo;
+  std::string line;
+
+  if (readSysfsLine(sys_node + "online", line)) {
+    for (int id : ipcl::parseCPUList(line)) {
+      std::string cpulist;
+      if (!readSysfsLine(sys_node + "node" + std::to_string(id) + "/cpulist",
+                         cpulist))
+        continue;
+      ipcl::linuxNUMANode node;
+      node.id = id;
+      for (int cpu : ipcl::parseCPUList(cpulist))
+        if (usable(cpu)) node.cpus.push_back(cpu);
+      if (!node.cpus.empty()) topo.nodes.push_back(node);
+    }
+  }
+
+  // no NUMA information: one node holding every usable cpu
+  if (topo.nodes.empty()) {
+    ipcl::linuxNUMANode node;
+    node.id = 0;
+    std::vector<int> online;
+    if (readSysfsLine(sys_cpu + "online", line))
+      online = ipcl::parseCPUList(line);
+    for (int cpu : online)
+      if (usable(cpu)) node.cpus.push_back(cpu);
+    if (node.cpus.empty()) node.cpus.push_back(0);
+    topo.nodes.push_back(node);
+  }
+
+  topo.n_processors = 0;
+  topo.n_cores = 0;
+  for (auto& node : topo.nodes) {
+    std::set<int> seen;
+    for (int cpu : node.cpus) {
+      int primary = cpu;
+      std::string siblings;
+      if (readSysfsLine(sys_cpu + "cpu" + std::to_string(cpu) +
+                            "/topology/thread_siblings_list",
+                        siblings)) {
+        auto ids = ipcl::parseCPUList(siblings);
+        if (!ids.empty()) primary = *std::min_element(ids.begin(), ids.end());
+      }
+      if (seen.insert(primary).second) node.primary_cpus.push_back(cpu);
+    }
+    topo.n_processors += node.cpus.size();
+    topo.n_cores += node.primary_cpus.size();
+  }
+  topo.n_smt = std::max(1, topo.n_processors / std::max(1, topo.n_cores));
+
+  return topo;
+}
@@ -0,0 +1,311 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ipcl/utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+#include "ipcl/utils/numa.hpp"
+#include "ipcl/utils/util.hpp"
+
+namespace ipcl {
+
+struct ThreadPool::Job {
+  Job(const std::function<void(std::size_t, std::size_t)>& f, std::size_t b,
+      std::size_t n, std::size_t g)
+      : func(&f),
+        offset(b),
+        size(n),
+        grain(g),
+        num_chunks((n + g - 1) / g),
+        next(0),
+        done(0),
+        failed(false) {}
+
+  const std::function<void(std::size_t, std::size_t)>* func;
+  const std::size_t offset;
+  const std::size_t size;
+  const std::size_t grain;
+  const std::size_t num_chunks;
+  std::atomic<std::size_t> next;
+  std::atomic<std::size_t> done;
+  std::atomic<bool> failed;
+  std::exception_ptr error;
+  std::mutex mtx;
+  std::condition_variable cv;
+};
+
+// Worker identity of the calling thread, used to push nested tasks onto the
+// worker's own deque.
+static thread_local ThreadPool* tls_pool = nullptr;
+static thread_local std::size_t tls_worker_id = 0;
+
+ThreadPool::ThreadPool(std::size_t num_workers) : m_pending(0), m_stop(false) {
+  start({num_workers}, false);
+}
+
+ThreadPool::ThreadPool(const std::vector<std::size_t>& workers_per_node,
+                       bool bind)
+    : m_pending(0), m_stop(false) {
+  start(workers_per_node, bind);
+}
+
+void ThreadPool::start(const std::vector<std::size_t>& workers_per_node,
+                       bool bind) {
+  std::size_t num_workers = 0;
+  for (std::size_t g = 0; g < workers_per_node.size(); g++) {
+    auto group = std::make_unique<WorkerGroup>();
+    group->first = num_workers;
+    group->count = workers_per_node[g];
+    group->next = 0;
+    m_groups.push_back(std::move(group));
+    m_worker_group.insert(m_worker_group.end(), workers_per_node[g], g);
+    num_workers += workers_per_node[g];
+  }
+  if (m_groups.empty()) {
+    m_groups.push_back(std::make_unique<WorkerGroup>());
+    m_groups[0]->first = m_groups[0]->count = 0;
+    m_groups[0]->next = 0;
+  }
+
+  for (std::size_t i = 0; i < num_workers; i++)
+    m_queues.emplace_back(std::make_unique<WorkQueue>());
+  for (std::size_t i = 0; i < num_workers; i++)
+    m_workers.emplace_back(&ThreadPool::workerLoop, this, i, m_worker_group[i],
+                           bind);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  for (auto& worker : m_workers) worker.join();
+}
+
+void ThreadPool::push(std::function<void()> task, std::size_t group) {
+  std::size_t id;
+  const auto& g = *m_groups[group];
+  if (tls_pool == this && m_worker_group[tls_worker_id] == group)
+    id = tls_worker_id;
+  else if (g.count > 0)
+    id = g.first + m_groups[group]->next.fetch_add(1) % g.count;
+  else
+    id = m_groups[group]->next.fetch_add(1) % m_queues.size();
+  {
+    std::lock_guard<std::mutex> lock(m_queues[id]->mtx);
+    m_queues[id]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_pending++;
+  }
+  m_cv.notify_one();
+}
+
+bool ThreadPool::tryPop(std::size_t id, std::function<void()>& task) {
+  // own deque first (LIFO), then steal (FIFO) from the same node before
+  // crossing to remote nodes
+  {
+    std::lock_guard<std::mutex> lock(m_queues[id]->mtx);
+    if (!m_queues[id]->tasks.empty()) {
+      task = std::move(m_queues[id]->tasks.back());
+      m_queues[id]->tasks.pop_back();
+      return true;
+    }
+  }
+  std::size_t n = m_queues.size();
+  for (int local = 1; local >= 0; local--) {
+    for (std::size_t k = 1; k < n; k++) {
+      std::size_t victim_id = (id + k) % n;
+      if ((m_worker_group[victim_id] == m_worker_group[id]) != (local == 1))
+        continue;
+      auto& victim = *m_queues[victim_id];
+      std::lock_guard<std::mutex> lock(victim.mtx);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ThreadPool::workerLoop(std::size_t id, std::size_t group, bool bind) {
+  if (bind) bindThreadToNode(group);
+  tls_pool = this;
+  tls_worker_id = id;
+  for (;;) {
+    std::function<void()> task;
+    if (tryPop(id, task)) {
+      m_pending--;
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock, [this] { return m_stop || m_pending.load() > 0; });
+    if (m_stop && m_pending.load() == 0) return;
+  }
+}
+
+std::size_t ThreadPool::callerGroup() const {
+  if (tls_pool == this) return m_worker_group[tls_worker_id];
+  if (m_groups.size() < 2) return 0;
+  return std::min<std::size_t>(getCurrentNode(), m_groups.size() - 1);
+}
+
+void ThreadPool::runChunks(Job& job) {
+  for (;;) {
+    std::size_t chunk = job.next.fetch_add(1);
+    if (chunk >= job.num_chunks) return;
+
+    if (!job.failed.load()) {
+      std::size_t begin = chunk * job.grain;
+      std::size_t end = std::min(job.size, begin + job.grain);
+      try {
+        (*job.func)(job.offset + begin, job.offset + end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(job.mtx);
+        if (!job.error) job.error = std::current_exception();
+        job.failed = true;
+      }
+    }
+
+    if (job.done.fetch_add(1) + 1 == job.num_chunks) {
+      std::lock_guard<std::mutex> lock(job.mtx);
+      job.cv.notify_all();
+    }
+  }
+}
+
+void ThreadPool::parallelFor(
+    std::size_t size, const std::function<void(std::size_t, std::size_t)>& func,
+    std::size_t grain, std::size_t max_concurrency) {
+  if (size == 0) return;
+  if (grain == 0) grain = 1;
+
+  std::size_t num_chunks = (size + grain - 1) / grain;
+  std::size_t num_threads = m_workers.size() + 1;
+  if (max_concurrency > 0)
+    num_threads = std::min(num_threads, max_concurrency);
+  num_threads = std::min(num_threads, num_chunks);
+
+  // Small batches run inline without any fork/join cost
+  if (num_threads <= 1) {
+    func(0, size);
+    return;
+  }
+
+  std::size_t num_groups = m_groups.size();
+  std::size_t home = callerGroup();
+  bool split_by_node =
+      (num_groups > 1) && (max_concurrency == 0) &&
+      (num_chunks >= num_groups * IPCL_NUMA_PARTITION_MIN_CHUNKS);
+
+  // one job per node slice, or a single job pushed to the caller's node
+  std::vector<std::shared_ptr<Job>> jobs(num_groups);
+  if (split_by_node) {
+    auto slices = partitionByNode(size, num_groups, grain);
+    for (std::size_t g = 0; g < num_groups; g++) {
+      std::size_t len = slices[g].second - slices[g].first;
+      if (len == 0) continue;
+      auto job = std::make_shared<Job>(func, slices[g].first, len, grain);
+      // The caller already stands in for the worker makeThreadPool() left
+      // out, so every worker of the group helps
+      std::size_t helpers = std::min(m_groups[g]->count, job->num_chunks);
+      for (std::size_t i = 0; i < helpers; i++)
+        push([job] { runChunks(*job); }, g);
+      jobs[g] = job;
+    }
+  } else {
+    auto job = std::make_shared<Job>(func, 0, size, grain);
+    for (std::size_t i = 1; i < num_threads; i++)
+      push([job] { runChunks(*job); }, home);
+    jobs[home] = job;
+  }
+
+  // The caller works on its own node's slice first, then helps with the
+  // rest, and finally waits for chunks claimed by others
+  for (std::size_t k = 0; k < num_groups; k++) {
+    auto& job = jobs[(home + k) % num_groups];
+    if (job) runChunks(*job);
+  }
+  std::exception_ptr error;
+  for (auto& job : jobs) {
+    if (!job) continue;
+    std::unique_lock<std::mutex> lock(job->mtx);
+    job->cv.wait(lock, [&job] { return job->done.load() == job->num_chunks; });
+    if (!error) error = job->error;
+  }
+
+  if (error) std::rethrow_exception(error);
+}
+
+static std::mutex g_pool_mtx;
+static std::shared_ptr<ThreadPool> g_pool;
+
+std::size_t getDefaultNumThreads() {
+  const char* env = std::getenv("IPCL_NUM_THREADS");
+  if (env != nullptr) {
+    int n = std::atoi(env);
+    if (n > 0) return n;
+  }
+#ifdef IPCL_USE_OMP
+  std::size_t per_node = std::max(1, OMPUtilities::MaxThreads);
+  return isNUMAEnabled() ? per_node * getCPUTopology().nodes.size() : per_node;
+#else
+  return 1;
+#endif  // IPCL_USE_OMP
+}
+
+static std::shared_ptr<ThreadPool> makeThreadPool(std::size_t num_threads) {
+  if (num_threads <= 1 || !isNUMAEnabled())
+    return std::make_shared<ThreadPool>(num_threads - 1);
+
+  // Spread the threads over the nodes in proportion to their cpus. The
+  // caller takes the place of one worker of its own node's group.
+  const auto& nodes = getCPUTopology().nodes;
+  std::size_t total_cpus = 0;
+  for (const auto& node : nodes) total_cpus += node.cpus.size();
+
+  std::vector<std::size_t> workers_per_node(nodes.size());
+  std::size_t assigned = 0;
+  for (std::size_t i = 0; i < nodes.size(); i++) {
+    workers_per_node[i] = num_threads * nodes[i].cpus.size() / total_cpus;
+    assigned += workers_per_node[i];
+  }
+  for (std::size_t i = 0; assigned < num_threads; i = (i + 1) % nodes.size()) {
+    workers_per_node[i]++;
+    assigned++;
+  }
+  std::size_t home = std::min<std::size_t>(getCurrentNode(), nodes.size() - 1);
+  if (workers_per_node[home] > 1) workers_per_node[home]--;
+
+  return std::make_shared<ThreadPool>(workers_per_node, true);
+}
+
+std::shared_ptr<ThreadPool> getThreadPool() {
+  std::lock_guard<std::mutex> lock(g_pool_mtx);
+  if (!g_pool) g_pool = makeThreadPool(getDefaultNumThreads());
+  return g_pool;
+}
+
+void setNumThreads(std::size_t num_threads) {
+  if (num_threads == 0) num_threads = getDefaultNumThreads();
+  auto pool = makeThreadPool(num_threads);
+  std::shared_ptr<ThreadPool> old_pool;
+  {
+    std::lock_guard<std::mutex> lock(g_pool_mtx);
+    old_pool = std::move(g_pool);
+    g_pool = std::move(pool);
+  }
+  // old_pool is joined here, or by the last call still using it
+}
+
+std::size_t getNumThreads() { return getThreadPool()->getNumWorkers() + 1; }
+
+}  // namespace ipcl
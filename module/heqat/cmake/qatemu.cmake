@@ -0,0 +1,13 @@
+# Copyright (C) 2022 Intel Corporation
+# SPDX-License-Identifier: Apache-2.0
+
+# Software QAT device model: provides the QAT Library calls used by HE QAT
+# Lib on top of OpenSSL, in place of ICP_ROOT headers and libraries.
+message(STATUS "Using the software QAT device model, QAT hardware is not used.")
+
+set(ICP_INC_DIR ${HE_QAT_ROOT_DIR}/emulator/include)
+set(HE_QAT_EMU_SRC ${HE_QAT_ROOT_DIR}/emulator/qat_emu.c)
+
+add_definitions(-DHE_QAT_EMULATOR)
+add_definitions(-DUSER_SPACE)
+add_compile_options(-fPIC)
@@ -0,0 +1,84 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/cpa.h
+///
+/// Subset of the QAT API base types used by HE QAT Lib, for building against
+/// the software QAT device model (HE_QAT_EMULATOR). Names and layouts follow
+/// the QAT Library headers.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_CPA_H_
+#define _HE_QAT_EMU_CPA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t Cpa8U;
+typedef int8_t Cpa8S;
+typedef uint16_t Cpa16U;
+typedef int16_t Cpa16S;
+typedef uint32_t Cpa32U;
+typedef int32_t Cpa32S;
+typedef uint64_t Cpa64U;
+typedef int64_t Cpa64S;
+
+typedef enum _CpaBoolean { CPA_FALSE = 0, CPA_TRUE = 1 } CpaBoolean;
+
+typedef Cpa32S CpaStatus;
+#define CPA_STATUS_SUCCESS (0)
+#define CPA_STATUS_FAIL (-1)
+#define CPA_STATUS_RETRY (-2)
+#define CPA_STATUS_RESOURCE (-3)
+#define CPA_STATUS_INVALID_PARAM (-4)
+#define CPA_STATUS_UNSUPPORTED (-6)
+
+#define CPA_INST_VENDOR_NAME_SIZE (256)
+#define CPA_INST_PART_NAME_SIZE (256)
+#define CPA_INST_SW_VERSION_SIZE (64)
+#define CPA_INST_NAME_SIZE (256)
+#define CPA_INST_ID_SIZE (256)
+
+typedef void* CpaInstanceHandle;
+typedef Cpa64U CpaPhysicalAddr;
+typedef CpaPhysicalAddr (*CpaVirtualToPhysical)(void* pVirtualAddr);
+
+typedef enum _CpaAccelerationServiceType {
+    CPA_ACC_SVC_TYPE_CRYPTO = 1
+} CpaAccelerationServiceType;
+
+typedef struct _CpaFlatBuffer {
+    Cpa32U dataLenInBytes;
+    Cpa8U* pData;
+} CpaFlatBuffer;
+
+typedef struct _CpaPhysicalInstanceId {
+    Cpa16U packageId;
+    Cpa16U acceleratorId;
+    Cpa16U executionEngineId;
+    Cpa16U busAddress;
+    Cpa32U kptAcHandle;
+} CpaPhysicalInstanceId;
+
+typedef struct _CpaInstanceInfo2 {
+    CpaAccelerationServiceType accelerationServiceType;
+    Cpa8U vendorName[CPA_INST_VENDOR_NAME_SIZE];
+    Cpa8U partName[CPA_INST_PART_NAME_SIZE];
+    Cpa8U swVersion[CPA_INST_SW_VERSION_SIZE];
+    Cpa8U instName[CPA_INST_NAME_SIZE];
+    Cpa8U instID[CPA_INST_ID_SIZE];
+    CpaPhysicalInstanceId physInstId;
+    CpaBoolean isPolled;
+    CpaBoolean isOffloaded;
+    Cpa32U nodeAffinity;
+} CpaInstanceInfo2;
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_CPA_H_
@@ -0,0 +1,41 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/cpa_cy_im.h
+///
+/// Crypto instance management calls of the software QAT device model.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_CPA_CY_IM_H_
+#define _HE_QAT_EMU_CPA_CY_IM_H_
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Start an instance and its engine threads. Starting an instance
+/// that is already running only increments its start count.
+CpaStatus cpaCyStartInstance(CpaInstanceHandle instanceHandle);
+
+/// @brief Stop an instance once every start has been matched by a stop.
+/// Requests not delivered by then are dropped.
+CpaStatus cpaCyStopInstance(CpaInstanceHandle instanceHandle);
+
+CpaStatus cpaCyGetNumInstances(Cpa16U* pNumInstances);
+
+CpaStatus cpaCyGetInstances(Cpa16U numInstances,
+                            CpaInstanceHandle* cyInstances);
+
+CpaStatus cpaCyInstanceGetInfo2(const CpaInstanceHandle instanceHandle,
+                                CpaInstanceInfo2* pInstanceInfo2);
+
+CpaStatus cpaCySetAddressTranslation(const CpaInstanceHandle instanceHandle,
+                                     CpaVirtualToPhysical virtual2Physical);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_CPA_CY_IM_H_
@@ -0,0 +1,44 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/cpa_cy_ln.h
+///
+/// Large number operations of the software QAT device model.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_CPA_CY_LN_H_
+#define _HE_QAT_EMU_CPA_CY_LN_H_
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Operands of result = base ^ exponent mod modulus, big endian.
+typedef struct _CpaCyLnModExpOpData {
+    CpaFlatBuffer modulus;
+    CpaFlatBuffer base;
+    CpaFlatBuffer exponent;
+} CpaCyLnModExpOpData;
+
+typedef void (*CpaCyGenFlatBufCbFunc)(void* pCallbackTag, CpaStatus status,
+                                      void* pOpdata, CpaFlatBuffer* pOut);
+
+/// @brief Queue a modular exponentiation on an instance.
+/// @details The result is written to pResult, zero padded to its length, and
+/// pLnModExpCb is called from icp_sal_CyPollInstance() once the request has
+/// completed.
+/// @retval CPA_STATUS_RETRY The instance ring is full.
+/// @retval CPA_STATUS_FAIL The instance is not started.
+CpaStatus cpaCyLnModExp(const CpaInstanceHandle instanceHandle,
+                        const CpaCyGenFlatBufCbFunc pLnModExpCb,
+                        void* pCallbackTag,
+                        const CpaCyLnModExpOpData* pLnModExpOpData,
+                        CpaFlatBuffer* pResult);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_CPA_CY_LN_H_
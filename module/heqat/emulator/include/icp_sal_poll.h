@@ -0,0 +1,40 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/icp_sal_poll.h
+///
+/// Response polling of the software QAT device model.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_ICP_SAL_POLL_H_
+#define _HE_QAT_EMU_ICP_SAL_POLL_H_
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Deliver completed requests of an instance to their callbacks, in
+/// the calling thread.
+/// @param[in] response_quota Maximum number of responses, 0 for all.
+/// @retval CPA_STATUS_RETRY No response was pending.
+CpaStatus icp_sal_CyPollInstance(CpaInstanceHandle instanceHandle,
+                                 Cpa32U response_quota);
+
+/// @brief Get a file descriptor that is readable while responses of an
+/// instance are waiting to be polled (epoll mode of the instance).
+/// @param[out] fd File descriptor to wait on with poll() or epoll.
+/// @retval CPA_STATUS_UNSUPPORTED The instance has no event descriptor.
+CpaStatus icp_sal_CyGetFileDescriptor(CpaInstanceHandle instanceHandle,
+                                      int* fd);
+
+/// @brief Release a descriptor obtained with icp_sal_CyGetFileDescriptor().
+CpaStatus icp_sal_CyPutFileDescriptor(CpaInstanceHandle instanceHandle,
+                                      int fd);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_ICP_SAL_POLL_H_
@@ -0,0 +1,32 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/icp_sal_user.h
+///
+/// User process registration of the software QAT device model.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_ICP_SAL_USER_H_
+#define _HE_QAT_EMU_ICP_SAL_USER_H_
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Create the emulated instances with the current configuration,
+/// see qat_emu.h. Further calls only add a reference. The process name and
+/// device access flag are ignored.
+CpaStatus icp_sal_userStartMultiProcess(const char* pProcessName,
+                                        CpaBoolean limitDevAccess);
+
+/// @brief Stop any running instance and release them, once every start has
+/// been matched by a stop.
+CpaStatus icp_sal_userStop(void);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_ICP_SAL_USER_H_
@@ -0,0 +1,36 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/qae_mem.h
+///
+/// USDM memory calls of the software QAT device model. Memory comes from the
+/// process heap and its "physical" address is its virtual address.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_QAE_MEM_H_
+#define _HE_QAT_EMU_QAE_MEM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+CpaStatus qaeMemInit(void);
+
+void qaeMemDestroy(void);
+
+void* qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte);
+
+void qaeMemFreeNUMA(void** ptr);
+
+uint64_t qaeVirtToPhysNUMA(void* pVirtAddress);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_QAE_MEM_H_
@@ -0,0 +1,72 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/include/qat_emu.h
+///
+/// Software QAT device model. It stands in for the QAT Library calls HE QAT
+/// Lib makes (instance management, cpaCyLnModExp, polling and USDM memory),
+/// computing requests on CPU threads so the scheduler can be exercised and
+/// benchmarked on machines without QAT hardware.
+///
+/// Each instance owns a ring of at most ring_depth requests in flight and
+/// num_engines engine threads computing the requests with OpenSSL. A result
+/// is held back until latency_us has elapsed since its submission; its
+/// callback is then delivered by the next icp_sal_CyPollInstance() call, as
+/// with polled hardware instances. The engines bound the throughput of an
+/// instance and latency_us models the pipeline delay of the device.
+
+#pragma once
+
+#ifndef _HE_QAT_EMU_H_
+#define _HE_QAT_EMU_H_
+
+#include "cpa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HE_QAT_EMU_DEFAULT_INSTANCES 8
+#define HE_QAT_EMU_DEFAULT_RING_DEPTH 64
+#define HE_QAT_EMU_DEFAULT_ENGINES 1
+#define HE_QAT_EMU_DEFAULT_LATENCY_US 0
+#define HE_QAT_EMU_DEFAULT_NODES 1
+
+/// @brief Device model parameters. The defaults can be overridden with the
+/// environment variables HE_QAT_EMU_INSTANCES, HE_QAT_EMU_RING_DEPTH,
+/// HE_QAT_EMU_ENGINES, HE_QAT_EMU_LATENCY_US and HE_QAT_EMU_NODES.
+typedef struct {
+    unsigned int num_instances;  ///< Crypto instances exposed
+    unsigned int ring_depth;     ///< Requests in flight per instance
+    unsigned int num_engines;    ///< Engine threads per instance
+    unsigned int latency_us;     ///< Minimum latency of a request
+    unsigned int num_nodes;      ///< NUMA nodes the instances are spread over
+} QatEmuConfig;
+
+/// @brief Request counters, accumulated over all instances.
+typedef struct {
+    unsigned long long submitted;  ///< Requests accepted by cpaCyLnModExp
+    unsigned long long retried;    ///< Requests refused with a full ring
+    unsigned long long completed;  ///< Callbacks delivered by polling
+} QatEmuStats;
+
+/// @brief Set the device model parameters. They apply from the next
+/// icp_sal_userStartMultiProcess() call.
+/// @retval CPA_STATUS_INVALID_PARAM A parameter other than latency_us is
+/// zero.
+/// @retval CPA_STATUS_FAIL The instances are already created.
+CpaStatus qatEmuSetConfig(const QatEmuConfig* config);
+
+/// @brief Read the device model parameters in effect.
+void qatEmuGetConfig(QatEmuConfig* config);
+
+/// @brief Read the request counters.
+void qatEmuGetStats(QatEmuStats* stats);
+
+/// @brief Reset the request counters.
+void qatEmuResetStats(void);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // _HE_QAT_EMU_H_
@@ -0,0 +1,556 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file emulator/qat_emu.c
+
+#define _GNU_SOURCE
+
+#include <cpa.h>
+#include <cpa_cy_im.h>
+#include <cpa_cy_ln.h>
+#include <icp_sal_poll.h>
+#include <icp_sal_user.h>
+#include <qae_mem.h>
+#include <qat_emu.h>
+
+#include <openssl/bn.h>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/// @brief Request queued on an emulated instance.
+typedef struct QatEmuRequest {
+    CpaCyGenFlatBufCbFunc callback;
+    void* tag;
+    const CpaCyLnModExpOpData* op_data;
+    CpaFlatBuffer* result;
+    CpaStatus status;
+    uint64_t deadline_ns;  ///< Earliest time the response can be polled
+    struct QatEmuRequest* next;
+} QatEmuRequest;
+
+/// @brief Singly linked FIFO of requests.
+typedef struct {
+    QatEmuRequest* head;
+    QatEmuRequest* tail;
+} QatEmuQueue;
+
+/// @brief Emulated crypto instance; its address is the instance handle.
+typedef struct {
+    unsigned int id;
+    unsigned int starts;    ///< Unmatched cpaCyStartInstance() calls
+    unsigned int inflight;  ///< Requests submitted and not yet polled
+    int running;
+    QatEmuQueue pending;  ///< Requests waiting for an engine
+    QatEmuQueue done;     ///< Computed requests waiting to be polled
+    pthread_mutex_t mutex;
+    pthread_cond_t work;
+    pthread_t* engines;
+    unsigned int num_engines;
+    unsigned int ring_depth;
+    uint64_t latency_ns;
+    CpaVirtualToPhysical virt2phys;
+    int event_fd;  ///< Readable while responses are waiting to be polled
+} QatEmuInstance;
+
+static pthread_mutex_t emu_lock = PTHREAD_MUTEX_INITIALIZER;
+static QatEmuConfig emu_config;
+static int emu_config_loaded = 0;
+static QatEmuInstance* emu_instances = NULL;
+static unsigned int emu_num_instances = 0;
+static unsigned int emu_process_starts = 0;
+static QatEmuStats emu_stats = {0, 0, 0};
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void queue_push(QatEmuQueue* queue, QatEmuRequest* request) {
+    request->next = NULL;
+    if (NULL == queue->tail)
+        queue->head = request;
+    else
+        queue->tail->next = request;
+    queue->tail = request;
+}
+
+static QatEmuRequest* queue_pop(QatEmuQueue* queue) {
+    QatEmuRequest* request = queue->head;
+    if (NULL != request) {
+        queue->head = request->next;
+        if (NULL == queue->head) queue->tail = NULL;
+    }
+    return request;
+}
+
+static void queue_clear(QatEmuQueue* queue) {
+    QatEmuRequest* request;
+    while (NULL != (request = queue_pop(queue))) free(request);
+}
+
+/// @brief Read an integer of at least min_value from the environment.
+static unsigned int env_uint(const char* name, unsigned int value,
+                             unsigned int min_value) {
+    const char* str = getenv(name);
+    if (NULL == str || '\0' == *str) return value;
+    char* end = NULL;
+    unsigned long parsed = strtoul(str, &end, 10);
+    if ('\0' != *end || parsed < min_value || parsed > UINT32_MAX) {
+        fprintf(stderr, "[QAT_EMU] Ignoring invalid %s=%s\n", name, str);
+        return value;
+    }
+    return (unsigned int)parsed;
+}
+
+/// @brief Load the defaults and their environment overrides, once.
+/// Requires emu_lock.
+static void load_config() {
+    if (emu_config_loaded) return;
+    emu_config.num_instances =
+        env_uint("HE_QAT_EMU_INSTANCES", HE_QAT_EMU_DEFAULT_INSTANCES, 1);
+    emu_config.ring_depth =
+        env_uint("HE_QAT_EMU_RING_DEPTH", HE_QAT_EMU_DEFAULT_RING_DEPTH, 1);
+    emu_config.num_engines =
+        env_uint("HE_QAT_EMU_ENGINES", HE_QAT_EMU_DEFAULT_ENGINES, 1);
+    emu_config.latency_us =
+        env_uint("HE_QAT_EMU_LATENCY_US", HE_QAT_EMU_DEFAULT_LATENCY_US, 0);
+    emu_config.num_nodes =
+        env_uint("HE_QAT_EMU_NODES", HE_QAT_EMU_DEFAULT_NODES, 1);
+    emu_config_loaded = 1;
+}
+
+/// @brief Compute result = base ^ exponent mod modulus.
+static CpaStatus emu_mod_exp(const CpaCyLnModExpOpData* op,
+                             CpaFlatBuffer* result, BN_CTX* ctx, BIGNUM* r,
+                             BIGNUM* b, BIGNUM* e, BIGNUM* m) {
+    if (NULL == ctx || NULL == r || NULL == b || NULL == e || NULL == m)
+        return CPA_STATUS_RESOURCE;
+    if (!BN_bin2bn(op->base.pData, op->base.dataLenInBytes, b) ||
+        !BN_bin2bn(op->exponent.pData, op->exponent.dataLenInBytes, e) ||
+        !BN_bin2bn(op->modulus.pData, op->modulus.dataLenInBytes, m))
+        return CPA_STATUS_FAIL;
+    if (BN_is_zero(m)) return CPA_STATUS_INVALID_PARAM;
+    if (!BN_mod_exp(r, b, e, m, ctx)) return CPA_STATUS_FAIL;
+    if (BN_bn2binpad(r, result->pData, result->dataLenInBytes) < 0)
+        return CPA_STATUS_FAIL;
+    return CPA_STATUS_SUCCESS;
+}
+
+/// @brief Make the event file descriptor of an instance readable.
+static void notify_event(QatEmuInstance* inst) {
+    uint64_t one = 1;
+    if (inst->event_fd >= 0 && write(inst->event_fd, &one, sizeof(one)) < 0)
+        return;  // the counter is already set
+}
+
+/// @brief Engine thread: compute pending requests of an instance until it
+/// is stopped.
+static void* emu_engine(void* arg) {
+    QatEmuInstance* inst = (QatEmuInstance*)arg;
+    BN_CTX* ctx = BN_CTX_new();
+    BIGNUM* r = BN_new();
+    BIGNUM* b = BN_new();
+    BIGNUM* e = BN_new();
+    BIGNUM* m = BN_new();
+
+    pthread_mutex_lock(&inst->mutex);
+    while (1) {
+        while (inst->running && NULL == inst->pending.head)
+            pthread_cond_wait(&inst->work, &inst->mutex);
+        if (!inst->running) break;
+
+        QatEmuRequest* request = queue_pop(&inst->pending);
+        pthread_mutex_unlock(&inst->mutex);
+
+        request->status =
+            emu_mod_exp(request->op_data, request->result, ctx, r, b, e, m);
+
+        pthread_mutex_lock(&inst->mutex);
+        queue_push(&inst->done, request);
+        notify_event(inst);
+    }
+    pthread_mutex_unlock(&inst->mutex);
+
+    BN_free(m);
+    BN_free(e);
+    BN_free(b);
+    BN_free(r);
+    BN_CTX_free(ctx);
+    return NULL;
+}
+
+/// @brief Stop the engines of an instance and drop its requests.
+/// Requires inst->mutex, which is released.
+static void stop_engines(QatEmuInstance* inst) {
+    inst->running = 0;
+    pthread_cond_broadcast(&inst->work);
+    pthread_mutex_unlock(&inst->mutex);
+
+    for (unsigned int i = 0; i < inst->num_engines; i++)
+        if (0 != inst->engines[i]) pthread_join(inst->engines[i], NULL);
+    free(inst->engines);
+
+    pthread_mutex_lock(&inst->mutex);
+    inst->engines = NULL;
+    queue_clear(&inst->pending);
+    queue_clear(&inst->done);
+    inst->inflight = 0;
+    pthread_mutex_unlock(&inst->mutex);
+}
+
+/***********          Device model configuration      ***********/
+
+CpaStatus qatEmuSetConfig(const QatEmuConfig* config) {
+    if (NULL == config || 0 == config->num_instances ||
+        0 == config->ring_depth || 0 == config->num_engines ||
+        0 == config->num_nodes)
+        return CPA_STATUS_INVALID_PARAM;
+
+    pthread_mutex_lock(&emu_lock);
+    if (NULL != emu_instances) {
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_FAIL;
+    }
+    emu_config = *config;
+    emu_config_loaded = 1;
+    pthread_mutex_unlock(&emu_lock);
+    return CPA_STATUS_SUCCESS;
+}
+
+void qatEmuGetConfig(QatEmuConfig* config) {
+    if (NULL == config) return;
+    pthread_mutex_lock(&emu_lock);
+    load_config();
+    *config = emu_config;
+    pthread_mutex_unlock(&emu_lock);
+}
+
+void qatEmuGetStats(QatEmuStats* stats) {
+    if (NULL == stats) return;
+    stats->submitted = __atomic_load_n(&emu_stats.submitted, __ATOMIC_RELAXED);
+    stats->retried = __atomic_load_n(&emu_stats.retried, __ATOMIC_RELAXED);
+    stats->completed = __atomic_load_n(&emu_stats.completed, __ATOMIC_RELAXED);
+}
+
+void qatEmuResetStats(void) {
+    __atomic_store_n(&emu_stats.submitted, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&emu_stats.retried, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&emu_stats.completed, 0, __ATOMIC_RELAXED);
+}
+
+/***********          SAL user process      ***********/
+
+CpaStatus icp_sal_userStartMultiProcess(const char* pProcessName,
+                                        CpaBoolean limitDevAccess) {
+    (void)pProcessName;
+    (void)limitDevAccess;
+
+    pthread_mutex_lock(&emu_lock);
+    if (emu_process_starts++ > 0) {
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_SUCCESS;
+    }
+    load_config();
+
+    emu_instances = (QatEmuInstance*)calloc(emu_config.num_instances,
+                                            sizeof(QatEmuInstance));
+    if (NULL == emu_instances) {
+        emu_process_starts = 0;
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_RESOURCE;
+    }
+    for (unsigned int i = 0; i < emu_config.num_instances; i++) {
+        QatEmuInstance* inst = &emu_instances[i];
+        inst->id = i;
+        inst->num_engines = emu_config.num_engines;
+        inst->ring_depth = emu_config.ring_depth;
+        inst->latency_ns = (uint64_t)emu_config.latency_us * 1000;
+        pthread_mutex_init(&inst->mutex, NULL);
+        pthread_cond_init(&inst->work, NULL);
+        inst->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    emu_num_instances = emu_config.num_instances;
+    pthread_mutex_unlock(&emu_lock);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_userStop(void) {
+    pthread_mutex_lock(&emu_lock);
+    if (0 == emu_process_starts) {
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_FAIL;
+    }
+    if (--emu_process_starts > 0) {
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_SUCCESS;
+    }
+    for (unsigned int i = 0; i < emu_num_instances; i++) {
+        QatEmuInstance* inst = &emu_instances[i];
+        pthread_mutex_lock(&inst->mutex);
+        if (inst->starts > 0) {
+            inst->starts = 0;
+            stop_engines(inst);
+        } else {
+            pthread_mutex_unlock(&inst->mutex);
+        }
+        pthread_cond_destroy(&inst->work);
+        pthread_mutex_destroy(&inst->mutex);
+        if (inst->event_fd >= 0) close(inst->event_fd);
+    }
+    free(emu_instances);
+    emu_instances = NULL;
+    emu_num_instances = 0;
+    pthread_mutex_unlock(&emu_lock);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/***********          Instance management      ***********/
+
+CpaStatus cpaCyGetNumInstances(Cpa16U* pNumInstances) {
+    if (NULL == pNumInstances) return CPA_STATUS_INVALID_PARAM;
+    pthread_mutex_lock(&emu_lock);
+    *pNumInstances = (Cpa16U)emu_num_instances;
+    pthread_mutex_unlock(&emu_lock);
+    return (0 == *pNumInstances) ? CPA_STATUS_FAIL : CPA_STATUS_SUCCESS;
+}
+
+CpaStatus cpaCyGetInstances(Cpa16U numInstances,
+                            CpaInstanceHandle* cyInstances) {
+    if (NULL == cyInstances || 0 == numInstances)
+        return CPA_STATUS_INVALID_PARAM;
+    pthread_mutex_lock(&emu_lock);
+    if (numInstances > emu_num_instances) {
+        pthread_mutex_unlock(&emu_lock);
+        return CPA_STATUS_INVALID_PARAM;
+    }
+    for (unsigned int i = 0; i < numInstances; i++)
+        cyInstances[i] = (CpaInstanceHandle)&emu_instances[i];
+    pthread_mutex_unlock(&emu_lock);
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus cpaCyInstanceGetInfo2(const CpaInstanceHandle instanceHandle,
+                                CpaInstanceInfo2* pInstanceInfo2) {
+    if (NULL == instanceHandle || NULL == pInstanceInfo2)
+        return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+
+    memset(pInstanceInfo2, 0, sizeof(CpaInstanceInfo2));
+    pInstanceInfo2->accelerationServiceType = CPA_ACC_SVC_TYPE_CRYPTO;
+    snprintf((char*)pInstanceInfo2->vendorName, CPA_INST_VENDOR_NAME_SIZE,
+             "Intel(R)");
+    snprintf((char*)pInstanceInfo2->partName, CPA_INST_PART_NAME_SIZE,
+             "QAT software device model");
+    snprintf((char*)pInstanceInfo2->swVersion, CPA_INST_SW_VERSION_SIZE,
+             "emulator");
+    snprintf((char*)pInstanceInfo2->instName, CPA_INST_NAME_SIZE, "SSL%u",
+             inst->id);
+    snprintf((char*)pInstanceInfo2->instID, CPA_INST_ID_SIZE, "emu_%u",
+             inst->id);
+    pInstanceInfo2->physInstId.executionEngineId = (Cpa16U)inst->id;
+    pInstanceInfo2->isPolled = CPA_TRUE;
+    pInstanceInfo2->isOffloaded = CPA_FALSE;
+    pInstanceInfo2->nodeAffinity = inst->id % emu_config.num_nodes;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus cpaCySetAddressTranslation(const CpaInstanceHandle instanceHandle,
+                                     CpaVirtualToPhysical virtual2Physical) {
+    if (NULL == instanceHandle || NULL == virtual2Physical)
+        return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+    pthread_mutex_lock(&inst->mutex);
+    inst->virt2phys = virtual2Physical;
+    pthread_mutex_unlock(&inst->mutex);
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus cpaCyStartInstance(CpaInstanceHandle instanceHandle) {
+    if (NULL == instanceHandle) return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+
+    pthread_mutex_lock(&inst->mutex);
+    if (inst->starts++ > 0) {
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_SUCCESS;
+    }
+
+    inst->running = 1;
+    inst->engines = (pthread_t*)calloc(inst->num_engines, sizeof(pthread_t));
+    for (unsigned int i = 0; NULL != inst->engines && i < inst->num_engines;
+         i++) {
+        if (0 != pthread_create(&inst->engines[i], NULL, emu_engine, inst)) {
+            inst->engines[i] = 0;
+            inst->starts = 0;
+            stop_engines(inst);
+            return CPA_STATUS_RESOURCE;
+        }
+    }
+    if (NULL == inst->engines) {
+        inst->starts = 0;
+        inst->running = 0;
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_RESOURCE;
+    }
+    pthread_mutex_unlock(&inst->mutex);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus cpaCyStopInstance(CpaInstanceHandle instanceHandle) {
+    if (NULL == instanceHandle) return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+
+    pthread_mutex_lock(&inst->mutex);
+    if (0 == inst->starts) {
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_FAIL;
+    }
+    if (--inst->starts > 0) {
+        pthread_mutex_unlock(&inst->mutex);
+        return CPA_STATUS_SUCCESS;
+    }
+    stop_engines(inst);
+
+    return CPA_STATUS_SUCCESS;
+}
+
+/***********          Large number operations      ***********/
+
+CpaStatus cpaCyLnModExp(const CpaInstanceHandle instanceHandle,
+                        const CpaCyGenFlatBufCbFunc pLnModExpCb,
+                        void* pCallbackTag,
+                        const CpaCyLnModExpOpData* pLnModExpOpData,
+                        CpaFlatBuffer* pResult) {
+    // Synchronous mode (no callback) is not modeled
+    if (NULL == instanceHandle || NULL == pLnModExpCb ||
+        NULL == pLnModExpOpData || NULL == pResult || NULL == pResult->pData)
+        return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+
+    QatEmuRequest* request = (QatEmuRequest*)malloc(sizeof(QatEmuRequest));
+    if (NULL == request) return CPA_STATUS_RESOURCE;
+    request->callback = pLnModExpCb;
+    request->tag = pCallbackTag;
+    request->op_data = pLnModExpOpData;
+    request->result = pResult;
+    request->status = CPA_STATUS_FAIL;
+    request->deadline_ns = now_ns() + inst->latency_ns;
+
+    pthread_mutex_lock(&inst->mutex);
+    if (!inst->running) {
+        pthread_mutex_unlock(&inst->mutex);
+        free(request);
+        return CPA_STATUS_FAIL;
+    }
+    if (inst->inflight >= inst->ring_depth) {
+        pthread_mutex_unlock(&inst->mutex);
+        free(request);
+        __atomic_add_fetch(&emu_stats.retried, 1, __ATOMIC_RELAXED);
+        return CPA_STATUS_RETRY;
+    }
+    inst->inflight++;
+    queue_push(&inst->pending, request);
+    pthread_cond_signal(&inst->work);
+    pthread_mutex_unlock(&inst->mutex);
+
+    __atomic_add_fetch(&emu_stats.submitted, 1, __ATOMIC_RELAXED);
+    return CPA_STATUS_SUCCESS;
+}
+
+/***********          Polling      ***********/
+
+CpaStatus icp_sal_CyPollInstance(CpaInstanceHandle instanceHandle,
+                                 Cpa32U response_quota) {
+    if (NULL == instanceHandle) return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+    QatEmuQueue ready = {NULL, NULL};
+    Cpa32U count = 0;
+    uint64_t now = now_ns();
+
+    // Detach the responses due by now, keeping the others in order
+    pthread_mutex_lock(&inst->mutex);
+    uint64_t events;
+    if (inst->event_fd >= 0 &&
+        read(inst->event_fd, &events, sizeof(events)) < 0)
+        events = 0;  // nothing signaled
+    QatEmuQueue done = inst->done;
+    inst->done.head = inst->done.tail = NULL;
+    QatEmuRequest* request;
+    while (NULL != (request = queue_pop(&done))) {
+        if (request->deadline_ns <= now &&
+            (0 == response_quota || count < response_quota)) {
+            queue_push(&ready, request);
+            count++;
+        } else {
+            queue_push(&inst->done, request);
+        }
+    }
+    inst->inflight -= count;
+    // Responses not due yet keep the descriptor readable
+    if (NULL != inst->done.head) notify_event(inst);
+    pthread_mutex_unlock(&inst->mutex);
+
+    // Deliver the responses through the caller's callbacks
+    while (NULL != (request = queue_pop(&ready))) {
+        request->callback(request->tag, request->status,
+                          (void*)request->op_data, request->result);
+        free(request);
+    }
+
+    if (0 == count) return CPA_STATUS_RETRY;
+    __atomic_add_fetch(&emu_stats.completed, count, __ATOMIC_RELAXED);
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_CyGetFileDescriptor(CpaInstanceHandle instanceHandle,
+                                      int* fd) {
+    if (NULL == instanceHandle || NULL == fd) return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+    if (inst->event_fd < 0) return CPA_STATUS_UNSUPPORTED;
+    *fd = inst->event_fd;
+    return CPA_STATUS_SUCCESS;
+}
+
+CpaStatus icp_sal_CyPutFileDescriptor(CpaInstanceHandle instanceHandle,
+                                      int fd) {
+    if (NULL == instanceHandle) return CPA_STATUS_INVALID_PARAM;
+    QatEmuInstance* inst = (QatEmuInstance*)instanceHandle;
+    return (fd == inst->event_fd) ? CPA_STATUS_SUCCESS : CPA_STATUS_FAIL;
+}
+
+/***********          USDM memory      ***********/
+
+CpaStatus qaeMemInit(void) { return CPA_STATUS_SUCCESS; }
+
+void qaeMemDestroy(void) {}
+
+void* qaeMemAllocNUMA(size_t size, int node, size_t phys_alignment_byte) {
+    (void)node;
+    size_t alignment = phys_alignment_byte;
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    if (0 != (alignment & (alignment - 1))) return NULL;
+
+    void* ptr = NULL;
+    if (0 != posix_memalign(&ptr, alignment, size)) return NULL;
+    return ptr;
+}
+
+void qaeMemFreeNUMA(void** ptr) {
+    if (NULL == ptr) return;
+    free(*ptr);
+    *ptr = NULL;
+}
+
+uint64_t qaeVirtToPhysNUMA(void* pVirtAddress) {
+    return (uint64_t)(uintptr_t)pVirtAddress;
+}
@@ -9,6 +9,8 @@
 
 #include "heqat/bnops.h"
 #include "heqat/common/consts.h"
+#include "heqat/common/ring.h"
+#include "heqat/common/slab.h"
 #include "heqat/common/types.h"
 #include "heqat/common/utils.h"
 
@@ -17,6 +19,7 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <pthread.h>
 #include <assert.h>
 #include <string.h>
@@ -29,14 +32,21 @@
 #endif
 
 // Global buffer for the runtime environment
+extern HE_QAT_Limits qat_limits;
 extern HE_QAT_RequestBuffer he_qat_buffer;
 extern HE_QAT_OutstandingBuffer outstanding;
+extern HE_QAT_RequestSlab* request_slab;
+
+// Slab of the single interface, after those backing the outstanding buffers
+#define HE_QAT_SINGLE_SLAB (outstanding.count)
 
 // Callback functions
 extern void HE_QAT_BIGNUMModExpCallback(void* pCallbackTag, CpaStatus status,
                                         void* pOpData, CpaFlatBuffer* pOut);
 extern void HE_QAT_bnModExpCallback(void* pCallbackTag, CpaStatus status,
                                     void* pOpData, CpaFlatBuffer* pOut);
+extern void HE_QAT_bnModExpAsyncCallback(void* pCallbackTag, CpaStatus status,
+                                         void* pOpData, CpaFlatBuffer* pOut);
 
 /// @brief Thread-safe producer implementation for the shared request buffer.
 /// @details Fill internal or outstanding buffer with incoming work requests.
@@ -61,38 +71,9 @@ HE_QAT_STATUS HE_QAT_bnModExp(unsigned char* r, unsigned char* b,
     if (NULL == e) return HE_QAT_STATUS_INVALID_PARAM;
     if (NULL == m) return HE_QAT_STATUS_INVALID_PARAM;
 
-    Cpa8U* pBase = NULL;
-    Cpa8U* pModulus = NULL;
-    Cpa8U* pExponent = NULL;
-
-    HE_QAT_STATUS status = HE_QAT_STATUS_FAIL;
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pBase, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pBase) {
-        memcpy(pBase, b, len);
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pExponent, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pExponent) {
-        memcpy(pExponent, e, len);
-    } else {
-        printf("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pModulus, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pModulus) {
-        memcpy(pModulus, m, len);
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
     // Pack it as a QAT Task Request
     HE_QAT_TaskRequest* request =
-        (HE_QAT_TaskRequest*)calloc(1, sizeof(HE_QAT_TaskRequest));
+        HE_QAT_slabAcquire(&request_slab[HE_QAT_SINGLE_SLAB], len);
     if (NULL == request) {
         HE_QAT_PRINT_ERR(
             "HE_QAT_TaskRequest memory allocation failed in "
@@ -100,43 +81,17 @@ HE_QAT_STATUS HE_QAT_bnModExp(unsigned char* r, unsigned char* b,
         return HE_QAT_STATUS_FAIL;
     }
 
-    CpaCyLnModExpOpData* op_data =
-        (CpaCyLnModExpOpData*)calloc(1, sizeof(CpaCyLnModExpOpData));
-    if (NULL == op_data) {
-        HE_QAT_PRINT_ERR(
-            "Cpa memory allocation failed in bnModExpPerformOp.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-    op_data->base.pData = pBase;
-    op_data->base.dataLenInBytes = len;
-    op_data->exponent.pData = pExponent;
-    op_data->exponent.dataLenInBytes = len;
-    op_data->modulus.pData = pModulus;
-    op_data->modulus.dataLenInBytes = len;
-    request->op_data = (void*)op_data;
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&request->op_result.pData, len,
-                                     BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != request->op_result.pData) {
-        request->op_result.dataLenInBytes = len;
-    } else {
-        HE_QAT_PRINT_ERR(
-            "CpaFlatBuffer.pData memory allocation failed in "
-            "bnModExpPerformOp.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    memcpy(op_data->base.pData, b, len);
+    memcpy(op_data->exponent.pData, e, len);
+    memcpy(op_data->modulus.pData, m, len);
 
     request->op_type = HE_QAT_OP_MODEXP;
     request->callback_func = (void*)HE_QAT_bnModExpCallback;
-    request->op_status = status;
     request->op_output = (void*)r;
 
     request->id = req_count++;
 
-    // Ensure calls are synchronized at exit (blocking)
-    pthread_mutex_init(&request->mutex, NULL);
-    pthread_cond_init(&request->ready, NULL);
-
     HE_QAT_PRINT_DBG("BN ModExp interface call for request #%llu\n", req_count);
 
     // Submit request using producer function
@@ -152,12 +107,9 @@ HE_QAT_STATUS HE_QAT_BIGNUMModExp(BIGNUM* r, BIGNUM* b, BIGNUM* e, BIGNUM* m,
     // Unpack data and copy to QAT friendly memory space
     int len = (nbits + 7) >> 3;
 
-    Cpa8U* pBase = NULL;
-    Cpa8U* pModulus = NULL;
-    Cpa8U* pExponent = NULL;
-
+    // Pack it as a QAT Task Request
     HE_QAT_TaskRequest* request =
-        (HE_QAT_TaskRequest*)calloc(1, sizeof(HE_QAT_TaskRequest));
+        HE_QAT_slabAcquire(&request_slab[HE_QAT_SINGLE_SLAB], len);
     if (NULL == request) {
         HE_QAT_PRINT_ERR(
             "HE_QAT_TaskRequest memory allocation failed in "
@@ -165,82 +117,30 @@ HE_QAT_STATUS HE_QAT_BIGNUMModExp(BIGNUM* r, BIGNUM* b, BIGNUM* e, BIGNUM* m,
         return HE_QAT_STATUS_FAIL;
     }
 
-    HE_QAT_STATUS status = HE_QAT_STATUS_FAIL;
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pBase, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pBase) {
-        if (!BN_bn2binpad(b, pBase, len)) {
-            HE_QAT_PRINT_ERR(
-                "BN_bn2binpad (base) failed in bnModExpPerformOp.\n");
-            HE_QAT_MEM_FREE_CONTIG(pBase);
-            return HE_QAT_STATUS_FAIL;
-        }
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    if (!BN_bn2binpad(b, op_data->base.pData, len)) {
+        HE_QAT_PRINT_ERR("BN_bn2binpad (base) failed in bnModExpPerformOp.\n");
+        HE_QAT_slabRelease(request);
         return HE_QAT_STATUS_FAIL;
     }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pExponent, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pExponent) {
-        if (!BN_bn2binpad(e, pExponent, len)) {
-            HE_QAT_PRINT_ERR(
-                "BN_bn2binpad (exponent) failed in bnModExpPerformOp.\n");
-            HE_QAT_MEM_FREE_CONTIG(pExponent);
-            return HE_QAT_STATUS_FAIL;
-        }
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pModulus, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pModulus) {
-        if (!BN_bn2binpad(m, pModulus, len)) {
-            HE_QAT_PRINT_ERR("BN_bn2binpad failed in bnModExpPerformOp.\n");
-            HE_QAT_MEM_FREE_CONTIG(pModulus);
-            return HE_QAT_STATUS_FAIL;
-        }
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    // Pack it as a QAT Task Request
-    CpaCyLnModExpOpData* op_data =
-        (CpaCyLnModExpOpData*)calloc(1, sizeof(CpaCyLnModExpOpData));
-    if (NULL == op_data) {
-        printf("Cpa memory allocation failed in bnModExpPerformOp.\n");
+    if (!BN_bn2binpad(e, op_data->exponent.pData, len)) {
+        HE_QAT_PRINT_ERR(
+            "BN_bn2binpad (exponent) failed in bnModExpPerformOp.\n");
+        HE_QAT_slabRelease(request);
         return HE_QAT_STATUS_FAIL;
     }
-    op_data->base.pData = pBase;
-    op_data->base.dataLenInBytes = len;
-    op_data->exponent.pData = pExponent;
-    op_data->exponent.dataLenInBytes = len;
-    op_data->modulus.pData = pModulus;
-    op_data->modulus.dataLenInBytes = len;
-    request->op_data = (void*)op_data;
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&request->op_result.pData, len,
-                                     BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != request->op_result.pData) {
-        request->op_result.dataLenInBytes = len;
-    } else {
-        HE_QAT_PRINT_ERR(
-            "CpaFlatBuffer.pData memory allocation failed in "
-            "bnModExpPerformOp.\n");
+    if (!BN_bn2binpad(m, op_data->modulus.pData, len)) {
+        HE_QAT_PRINT_ERR("BN_bn2binpad failed in bnModExpPerformOp.\n");
+        HE_QAT_slabRelease(request);
         return HE_QAT_STATUS_FAIL;
     }
 
     request->op_type = HE_QAT_OP_MODEXP;
     request->callback_func = (void*)HE_QAT_BIGNUMModExpCallback;
-    request->op_status = status;
     request->op_output = (void*)r;
 
     request->id = req_count++;
 
-    // Ensure calls are synchronized at exit (blocking)
-    pthread_mutex_init(&request->mutex, NULL);
-    pthread_cond_init(&request->ready, NULL);
-
     // Submit request using producer function
     submit_request(&he_qat_buffer, (void*)request);
 
@@ -278,26 +178,14 @@ void getBnModExpRequest(unsigned int batch_size) {
         HE_QAT_PRINT("%u time: %.1lfus\n", j, time_taken);
 #endif
 
-        // Free up QAT temporary memory
-        CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)task->op_data;
-        if (op_data) {
-            HE_QAT_MEM_FREE_CONTIG(op_data->base.pData);
-            HE_QAT_MEM_FREE_CONTIG(op_data->exponent.pData);
-            HE_QAT_MEM_FREE_CONTIG(op_data->modulus.pData);
-        }
-        free(task->op_data);
-        task->op_data = NULL;
-        if (task->op_result.pData) {
-            HE_QAT_MEM_FREE_CONTIG(task->op_result.pData);
-        }
-
         // Move forward to wait for the next request that will be offloaded
         pthread_mutex_unlock(&task->mutex);
 
-        free(he_qat_buffer.data[block_at_index]);
+        // Recycle the request and its QAT memory
+        HE_QAT_slabRelease(task);
         he_qat_buffer.data[block_at_index] = NULL;
 
-        block_at_index = (block_at_index + 1) % HE_QAT_BUFFER_SIZE;
+        block_at_index = (block_at_index + 1) % he_qat_buffer.capacity;
     } while (++j < batch_size);
 
 #ifdef HE_QAT_PERF
@@ -316,51 +204,15 @@ void getBnModExpRequest(unsigned int batch_size) {
  * **************************************************************************
  */
 
-HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
-                                 unsigned char* b, unsigned char* e,
-                                 unsigned char* m, int nbits) {
-    static unsigned long long req_count = 0;
+HE_QAT_STATUS HE_QAT_bnModExpReserve_MT(unsigned int _buffer_id, int nbits,
+                                        HE_QAT_BnModExpOperands* ops) {
+    if (NULL == ops) return HE_QAT_STATUS_INVALID_PARAM;
+    if (_buffer_id >= outstanding.count) return HE_QAT_STATUS_INVALID_PARAM;
 
-    // Unpack data and copy to QAT friendly memory space
     int len = (nbits + 7) >> 3;
 
-    if (NULL == r) return HE_QAT_STATUS_INVALID_PARAM;
-    if (NULL == b) return HE_QAT_STATUS_INVALID_PARAM;
-    if (NULL == e) return HE_QAT_STATUS_INVALID_PARAM;
-    if (NULL == m) return HE_QAT_STATUS_INVALID_PARAM;
-
-    Cpa8U* pBase = NULL;
-    Cpa8U* pModulus = NULL;
-    Cpa8U* pExponent = NULL;
-
-    HE_QAT_STATUS status = HE_QAT_STATUS_FAIL;
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pBase, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pBase) {
-        memcpy(pBase, b, len);
-    } else {
-        HE_QAT_PRINT("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pExponent, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pExponent) {
-        memcpy(pExponent, e, len);
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&pModulus, len, BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != pModulus) {
-        memcpy(pModulus, m, len);
-    } else {
-        HE_QAT_PRINT_ERR("Contiguous memory allocation failed for pBase.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
-    // Pack it as a QAT Task Request
     HE_QAT_TaskRequest* request =
-        (HE_QAT_TaskRequest*)calloc(1, sizeof(HE_QAT_TaskRequest));
+        HE_QAT_slabAcquire(&request_slab[_buffer_id], len);
     if (NULL == request) {
         HE_QAT_PRINT_ERR(
             "HE_QAT_TaskRequest memory allocation failed in "
@@ -368,43 +220,47 @@ HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
         return HE_QAT_STATUS_FAIL;
     }
 
-    CpaCyLnModExpOpData* op_data =
-        (CpaCyLnModExpOpData*)calloc(1, sizeof(CpaCyLnModExpOpData));
-    if (NULL == op_data) {
-        printf("Cpa memory allocation failed in bnModExpPerformOp.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-    op_data->base.pData = pBase;
-    op_data->base.dataLenInBytes = len;
-    op_data->exponent.pData = pExponent;
-    op_data->exponent.dataLenInBytes = len;
-    op_data->modulus.pData = pModulus;
-    op_data->modulus.dataLenInBytes = len;
-    request->op_data = (void*)op_data;
-
-    status = HE_QAT_MEM_ALLOC_CONTIG(&request->op_result.pData, len,
-                                     BYTE_ALIGNMENT_8);
-    if (HE_QAT_STATUS_SUCCESS == status && NULL != request->op_result.pData) {
-        request->op_result.dataLenInBytes = len;
-    } else {
-        HE_QAT_PRINT_ERR(
-            "CpaFlatBuffer.pData memory allocation failed in "
-            "bnModExpPerformOp.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    ops->base = op_data->base.pData;
+    ops->exponent = op_data->exponent.pData;
+    ops->modulus = op_data->modulus.pData;
+    ops->result = request->op_result.pData;
+    ops->request = (void*)request;
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+HE_QAT_STATUS HE_QAT_bnModExpSubmit_MT(unsigned int _buffer_id,
+                                       unsigned char* r,
+                                       HE_QAT_BnModExpOperands* ops) {
+    static unsigned long long req_count = 0;
+
+    if (NULL == ops || NULL == ops->request)
+        return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == r) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == ops->base || NULL == ops->exponent || NULL == ops->modulus ||
+        NULL == ops->result)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_TaskRequest* request = (HE_QAT_TaskRequest*)ops->request;
+    ops->request = NULL;
+
+    // Operands and result may have been redirected to other QAT memory, e.g.
+    // a modulus shared by the whole batch
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    op_data->base.pData = ops->base;
+    op_data->exponent.pData = ops->exponent;
+    op_data->modulus.pData = ops->modulus;
+    request->op_result.pData = ops->result;
 
     request->op_type = HE_QAT_OP_MODEXP;
     request->callback_func = (void*)HE_QAT_bnModExpCallback;
-    request->op_status = status;
     request->op_output = (void*)r;
 
-    request->id = req_count++;
-
-    // Ensure calls are synchronized at exit (blocking)
-    pthread_mutex_init(&request->mutex, NULL);
-    pthread_cond_init(&request->ready, NULL);
+    request->id = __atomic_fetch_add(&req_count, 1, __ATOMIC_RELAXED);
 
-    HE_QAT_PRINT_DBG("BN ModExp interface call for request #%llu\n", req_count);
+    HE_QAT_PRINT_DBG("BN ModExp interface call for request #%llu\n",
+                     request->id);
 
     // Submit request using producer function
     submit_request(&outstanding.buffer[_buffer_id], (void*)request);
@@ -412,6 +268,28 @@ HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
     return HE_QAT_STATUS_SUCCESS;
 }
 
+HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
+                                 unsigned char* b, unsigned char* e,
+                                 unsigned char* m, int nbits) {
+    // Unpack data and copy to QAT friendly memory space
+    int len = (nbits + 7) >> 3;
+
+    if (NULL == r) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == b) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == e) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == m) return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_BnModExpOperands ops;
+    HE_QAT_STATUS status = HE_QAT_bnModExpReserve_MT(_buffer_id, nbits, &ops);
+    if (HE_QAT_STATUS_SUCCESS != status) return status;
+
+    memcpy(ops.base, b, len);
+    memcpy(ops.exponent, e, len);
+    memcpy(ops.modulus, m, len);
+
+    return HE_QAT_bnModExpSubmit_MT(_buffer_id, r, &ops);
+}
+
 HE_QAT_STATUS acquire_bnModExp_buffer(unsigned int* _buffer_id) {
     if (NULL == _buffer_id) return HE_QAT_STATUS_INVALID_PARAM;
 
@@ -420,23 +298,23 @@ HE_QAT_STATUS acquire_bnModExp_buffer(unsigned int* _buffer_id) {
     pthread_mutex_lock(&outstanding.mutex);
 
     // Wait until next outstanding buffer becomes available for use
-    while (outstanding.busy_count >= HE_QAT_BUFFER_COUNT)
+    while (outstanding.busy_count >= outstanding.count)
         pthread_cond_wait(&outstanding.any_free_buffer, &outstanding.mutex);
 
-    assert(outstanding.busy_count < HE_QAT_BUFFER_COUNT);
+    assert(outstanding.busy_count < outstanding.count);
 
     // Find next outstanding buffer available
     unsigned int next_free_buffer = outstanding.next_free_buffer;
-    for (unsigned int i = 0; i < HE_QAT_BUFFER_COUNT; i++) {
+    for (unsigned int i = 0; i < outstanding.count; i++) {
         if (outstanding.free_buffer[next_free_buffer]) {
             outstanding.free_buffer[next_free_buffer] = 0;
             *_buffer_id = next_free_buffer;
             break;
         }
-        next_free_buffer = (next_free_buffer + 1) % HE_QAT_BUFFER_COUNT;
+        next_free_buffer = (next_free_buffer + 1) % outstanding.count;
     }
 
-    outstanding.next_free_buffer = (*_buffer_id + 1) % HE_QAT_BUFFER_COUNT;
+    outstanding.next_free_buffer = (*_buffer_id + 1) % outstanding.count;
     outstanding.next_ready_buffer = *_buffer_id;
     outstanding.ready_buffer[*_buffer_id] = 1;
     outstanding.busy_count++;
@@ -449,6 +327,27 @@ HE_QAT_STATUS acquire_bnModExp_buffer(unsigned int* _buffer_id) {
     return HE_QAT_STATUS_SUCCESS;
 }
 
+void wait_bnModExp_buffer(unsigned int _buffer_id, unsigned int _batch_size) {
+    unsigned int next_data_out = outstanding.buffer[_buffer_id].next_data_out;
+
+    HE_QAT_PRINT_DBG("wait_bnModExp_buffer #%u\n", _buffer_id);
+
+    for (unsigned int j = 0; j < _batch_size; j++) {
+        HE_QAT_TaskRequest* task =
+            (HE_QAT_TaskRequest*)outstanding.buffer[_buffer_id]
+                .data[next_data_out];
+        next_data_out =
+            (next_data_out + 1) % outstanding.buffer[_buffer_id].capacity;
+
+        if (NULL == task) continue;
+
+        pthread_mutex_lock(&task->mutex);
+        while (HE_QAT_STATUS_READY != task->request_status)
+            pthread_cond_wait(&task->ready, &task->mutex);
+        pthread_mutex_unlock(&task->mutex);
+    }
+}
+
 void release_bnModExp_buffer(unsigned int _buffer_id,
                              unsigned int _batch_size) {
     unsigned int next_data_out = outstanding.buffer[_buffer_id].next_data_out;
@@ -486,31 +385,18 @@ void release_bnModExp_buffer(unsigned int _buffer_id,
         HE_QAT_PRINT("%u time: %.1lfus\n", j, time_taken);
 #endif
 
-        // Free up QAT temporary memory
-        CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)task->op_data;
-        if (op_data) {
-            HE_QAT_MEM_FREE_CONTIG(op_data->base.pData);
-            HE_QAT_MEM_FREE_CONTIG(op_data->exponent.pData);
-            HE_QAT_MEM_FREE_CONTIG(op_data->modulus.pData);
-        }
-        free(task->op_data);
-        task->op_data = NULL;
-        if (task->op_result.pData) {
-            HE_QAT_MEM_FREE_CONTIG(task->op_result.pData);
-        }
-
         // Move forward to wait for the next request that will be offloaded
         pthread_mutex_unlock(&task->mutex);
 
         HE_QAT_PRINT_DBG("Buffer #%u Request #%u Completed\n", _buffer_id, j);
 
-        // outstanding.buffer[_buffer_id].count--;
-
-        free(outstanding.buffer[_buffer_id].data[next_data_out]);
+        // Recycle the request and its QAT memory
+        HE_QAT_slabRelease(task);
         outstanding.buffer[_buffer_id].data[next_data_out] = NULL;
 
         // Update for next thread on the next external iteration
-        next_data_out = (next_data_out + 1) % HE_QAT_BUFFER_SIZE;
+        next_data_out =
+            (next_data_out + 1) % outstanding.buffer[_buffer_id].capacity;
 
         j++;
     }
@@ -538,3 +424,232 @@ void release_bnModExp_buffer(unsigned int _buffer_id,
 
     return;
 }
+
+/*
+ * **************************************************************************
+ *  Implementation of Functions for the Asynchronous Interface Support
+ * **************************************************************************
+ */
+
+HE_QAT_STATUS create_completion_queue(HE_QAT_CompletionQueue** _cq) {
+    if (NULL == _cq) return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_CompletionQueue* cq =
+        (HE_QAT_CompletionQueue*)malloc(sizeof(HE_QAT_CompletionQueue));
+    if (NULL == cq) {
+        HE_QAT_PRINT_ERR("HE_QAT_CompletionQueue memory allocation failed.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+
+    // Sized by the limits of the acquired devices
+    if (HE_QAT_STATUS_SUCCESS !=
+        HE_QAT_ringInit(&cq->done, qat_limits.buffer_size)) {
+        free(cq);
+        return HE_QAT_STATUS_FAIL;
+    }
+    cq->harvested = (HE_QAT_TaskRequest**)malloc(cq->done.capacity *
+                                                 sizeof(HE_QAT_TaskRequest*));
+    if (NULL == cq->harvested) {
+        HE_QAT_PRINT_ERR("HE_QAT_CompletionQueue memory allocation failed.\n");
+        HE_QAT_ringDestroy(&cq->done);
+        free(cq);
+        return HE_QAT_STATUS_FAIL;
+    }
+    cq->num_harvested = 0;
+    cq->outstanding = 0;
+    cq->next_ticket = 0;
+
+    *_cq = cq;
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+// Recycle the requests returned by the previous harvest
+static void recycle_harvested(HE_QAT_CompletionQueue* cq) {
+    for (unsigned int i = 0; i < cq->num_harvested; i++)
+        HE_QAT_slabRelease(cq->harvested[i]);
+    cq->outstanding -= cq->num_harvested;
+    cq->num_harvested = 0;
+}
+
+HE_QAT_STATUS destroy_completion_queue(HE_QAT_CompletionQueue* cq) {
+    if (NULL == cq) return HE_QAT_STATUS_INVALID_PARAM;
+
+    recycle_harvested(cq);
+    if (cq->outstanding > 0) {
+        HE_QAT_PRINT_ERR("Completion queue has %u requests outstanding.\n",
+                         cq->outstanding);
+        return HE_QAT_STATUS_FAIL;
+    }
+
+    HE_QAT_ringDestroy(&cq->done);
+    free(cq->harvested);
+    free(cq);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+HE_QAT_STATUS HE_QAT_bnModExpReserve_Async(HE_QAT_CompletionQueue* cq,
+                                           int nbits,
+                                           HE_QAT_BnModExpOperands* ops) {
+    if (NULL == cq || NULL == ops) return HE_QAT_STATUS_INVALID_PARAM;
+
+    // Bounding the outstanding requests keeps the done ring from filling up,
+    // so callbacks never block on it
+    if (cq->outstanding >= cq->done.capacity) return HE_QAT_STATUS_BUSY;
+
+    int len = (nbits + 7) >> 3;
+
+    HE_QAT_TaskRequest* request =
+        HE_QAT_slabAcquire(&request_slab[HE_QAT_SINGLE_SLAB], len);
+    if (NULL == request) {
+        HE_QAT_PRINT_ERR(
+            "HE_QAT_TaskRequest memory allocation failed in "
+            "bnModExpPerformOp.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+    request->completion_queue = (void*)cq;
+    cq->outstanding++;
+
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    ops->base = op_data->base.pData;
+    ops->exponent = op_data->exponent.pData;
+    ops->modulus = op_data->modulus.pData;
+    ops->result = request->op_result.pData;
+    ops->request = (void*)request;
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+HE_QAT_STATUS HE_QAT_bnModExpSubmit_Async(HE_QAT_CompletionQueue* cq,
+                                          unsigned char* r,
+                                          HE_QAT_BnModExpOperands* ops,
+                                          void* user_data,
+                                          HE_QAT_Ticket* ticket) {
+    if (NULL == cq) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == ops || NULL == ops->request)
+        return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == ops->base || NULL == ops->exponent || NULL == ops->modulus ||
+        NULL == ops->result)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_TaskRequest* request = (HE_QAT_TaskRequest*)ops->request;
+    if (request->completion_queue != (void*)cq)
+        return HE_QAT_STATUS_INVALID_PARAM;
+    ops->request = NULL;
+
+    CpaCyLnModExpOpData* op_data = (CpaCyLnModExpOpData*)request->op_data;
+    op_data->base.pData = ops->base;
+    op_data->exponent.pData = ops->exponent;
+    op_data->modulus.pData = ops->modulus;
+    request->op_result.pData = ops->result;
+
+    request->op_type = HE_QAT_OP_MODEXP;
+    request->callback_func = (void*)HE_QAT_bnModExpAsyncCallback;
+    // Without a destination the remainder stays where the device wrote it
+    request->op_output = (NULL == r) ? (void*)ops->result : (void*)r;
+    request->user_data = user_data;
+
+    request->id = cq->next_ticket++;
+    if (NULL != ticket) *ticket = request->id;
+
+    HE_QAT_PRINT_DBG("BN ModExp async call for request #%llu\n", request->id);
+
+    // Submit request using producer function
+    submit_request(&he_qat_buffer, (void*)request);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+HE_QAT_STATUS HE_QAT_bnModExpCancel_Async(HE_QAT_CompletionQueue* cq,
+                                          HE_QAT_BnModExpOperands* ops) {
+    if (NULL == cq) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == ops || NULL == ops->request)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_TaskRequest* request = (HE_QAT_TaskRequest*)ops->request;
+    if (request->completion_queue != (void*)cq)
+        return HE_QAT_STATUS_INVALID_PARAM;
+    ops->request = NULL;
+
+    HE_QAT_slabRelease(request);
+    cq->outstanding--;
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+HE_QAT_STATUS HE_QAT_bnModExp_Async(HE_QAT_CompletionQueue* cq,
+                                    unsigned char* r, unsigned char* b,
+                                    unsigned char* e, unsigned char* m,
+                                    int nbits, void* user_data,
+                                    HE_QAT_Ticket* ticket) {
+    int len = (nbits + 7) >> 3;
+
+    if (NULL == b) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == e) return HE_QAT_STATUS_INVALID_PARAM;
+    if (NULL == m) return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_BnModExpOperands ops;
+    HE_QAT_STATUS status = HE_QAT_bnModExpReserve_Async(cq, nbits, &ops);
+    if (HE_QAT_STATUS_SUCCESS != status) return status;
+
+    memcpy(ops.base, b, len);
+    memcpy(ops.exponent, e, len);
+    memcpy(ops.modulus, m, len);
+
+    return HE_QAT_bnModExpSubmit_Async(cq, r, &ops, user_data, ticket);
+}
+
+// Report the requests taken from the done ring and keep them until the next
+// harvest, so results left in QAT memory stay readable
+static unsigned int harvest(HE_QAT_CompletionQueue* cq,
+                            HE_QAT_Completion* completions,
+                            unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        HE_QAT_TaskRequest* request = cq->harvested[i];
+        completions[i].ticket = request->id;
+        completions[i].status = (HE_QAT_STATUS_READY == request->request_status)
+                                    ? HE_QAT_STATUS_SUCCESS
+                                    : HE_QAT_STATUS_FAIL;
+        completions[i].user_data = request->user_data;
+        completions[i].result = (unsigned char*)request->op_output;
+    }
+    cq->num_harvested = count;
+    return count;
+}
+
+unsigned int poll_completion_queue(HE_QAT_CompletionQueue* cq,
+                                   HE_QAT_Completion* completions,
+                                   unsigned int max_completions) {
+    if (NULL == cq || NULL == completions) return 0;
+
+    recycle_harvested(cq);
+    if (max_completions > cq->done.capacity)
+        max_completions = cq->done.capacity;
+
+    unsigned int count = HE_QAT_ringTryPop(
+        &cq->done, (void**)cq->harvested, max_completions);
+    return harvest(cq, completions, count);
+}
+
+unsigned int wait_completion_queue(HE_QAT_CompletionQueue* cq,
+                                   HE_QAT_Completion* completions,
+                                   unsigned int min_completions,
+                                   unsigned int max_completions) {
+    if (NULL == cq || NULL == completions) return 0;
+
+    recycle_harvested(cq);
+    if (max_completions > cq->done.capacity)
+        max_completions = cq->done.capacity;
+    if (min_completions > max_completions) min_completions = max_completions;
+    // Never wait for more than what has been reserved
+    if (min_completions > cq->outstanding) min_completions = cq->outstanding;
+
+    unsigned int count = 0;
+    while (count < min_completions)
+        count += HE_QAT_ringPop(&cq->done, (void**)(cq->harvested + count),
+                                max_completions - count);
+    count += HE_QAT_ringTryPop(&cq->done, (void**)(cq->harvested + count),
+                               max_completions - count);
+    return harvest(cq, completions, count);
+}
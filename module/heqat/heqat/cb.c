@@ -11,16 +11,38 @@
 #include <openssl/bn.h>
 
 // Local headers
+#include "heqat/common/ring.h"
 #include "heqat/common/types.h"
 #include "heqat/common/utils.h"
 
 // Global variables
-static pthread_mutex_t
+extern pthread_mutex_t
     response_mutex;  ///< It protects against race condition on response_count
                      ///< due to concurrent callback events.
 extern volatile unsigned long
     response_count;  ///< It counts the number of requests completed by the
                      ///< accelerator.
+extern volatile unsigned long long
+    response_latency_ns;  ///< Sum of the submission-to-callback latencies.
+extern pthread_cond_t response_ready;  ///< Wakes a throttled scheduler.
+extern volatile int response_waiters;  ///< Threads waiting on response_ready.
+extern __thread unsigned long
+    polled_responses;  ///< Responses delivered in the polling thread.
+
+/// @brief Account for a response of the accelerator.
+/// @param[in] request Work request whose response is being delivered.
+static void HE_QAT_countResponse(HE_QAT_TaskRequest* request) {
+    unsigned long long latency_ns = HE_QAT_getTimeNs() - request->submit_ns;
+
+    pthread_mutex_lock(&response_mutex);
+    // Global track of responses by accelerator
+    response_count += 1;
+    response_latency_ns += latency_ns;
+    if (response_waiters) pthread_cond_signal(&response_ready);
+    pthread_mutex_unlock(&response_mutex);
+
+    polled_responses++;
+}
 
 /// @brief Callback implementation for the API HE_QAT_BIGNUMModExp(...)
 /// Callback function for the interface HE_QAT_BIGNUMModExp(). It performs
@@ -41,10 +63,7 @@ void HE_QAT_BIGNUMModExpCallback(void* pCallbackTag, CpaStatus status,
         // Read request data
         request = (HE_QAT_TaskRequest*)pCallbackTag;
 
-        pthread_mutex_lock(&response_mutex);
-        // Global track of responses by accelerator
-        response_count += 1;
-        pthread_mutex_unlock(&response_mutex);
+        HE_QAT_countResponse(request);
 
         pthread_mutex_lock(&request->mutex);
         // Collect the device output in pOut
@@ -95,10 +114,7 @@ void HE_QAT_bnModExpCallback(void* pCallbackTag, CpaStatus status,
         // Read request data
         request = (HE_QAT_TaskRequest*)pCallbackTag;
 
-        pthread_mutex_lock(&response_mutex);
-        // Global track of responses by accelerator
-        response_count += 1;
-        pthread_mutex_unlock(&response_mutex);
+        HE_QAT_countResponse(request);
 
         pthread_mutex_lock(&request->mutex);
         // Collect the device output in pOut
@@ -107,9 +123,11 @@ void HE_QAT_bnModExpCallback(void* pCallbackTag, CpaStatus status,
             if (pOpData == request->op_data) {
                 // Mark request as complete or ready to be used
                 request->request_status = HE_QAT_STATUS_READY;
-                // Copy compute results to output destination
-                memcpy(request->op_output, request->op_result.pData,
-                       request->op_result.dataLenInBytes);
+                // Copy compute results to output destination, unless the
+                // device wrote them there already
+                if (request->op_output != (void*)request->op_result.pData)
+                    memcpy(request->op_output, request->op_result.pData,
+                           request->op_result.dataLenInBytes);
 #ifdef HE_QAT_PERF
                 gettimeofday(&request->end, NULL);
 #endif
@@ -127,3 +145,49 @@ void HE_QAT_bnModExpCallback(void* pCallbackTag, CpaStatus status,
 
     return;
 }
+
+/// @brief Hand an asynchronous request over to its completion queue.
+/// @details Never blocks: a queue has at most as many requests reserved and
+/// not yet harvested as its done ring has slots.
+/// @param[in] request Request submitted with HE_QAT_bnModExpSubmit_Async().
+/// @param[in] status HE_QAT_STATUS_READY if the result is available.
+void HE_QAT_completeAsyncRequest(HE_QAT_TaskRequest* request,
+                                 HE_QAT_STATUS status) {
+    request->request_status = status;
+    HE_QAT_ringPush(
+        &((HE_QAT_CompletionQueue*)request->completion_queue)->done,
+        (void*)request);
+}
+
+/// @brief Callback implementation for the API HE_QAT_bnModExpSubmit_Async(...)
+/// Callback function for the asynchronous interface. It copies the result to
+/// the caller's destination, if any, and posts the request to the completion
+/// queue it was submitted to.
+/// @param[in] pCallbackTag work request package containing the original input
+/// data and other resources for post-processing.
+/// @param[in] status CPA_STATUS of the performed operation, e.g. CyLnModExp().
+/// @param[in] pOpData original input data passed to accelerator to perform the
+/// target operation (cannot be NULL).
+/// @param[out] pOut output returned by the accelerator after executing the
+/// target operation.
+void HE_QAT_bnModExpAsyncCallback(void* pCallbackTag, CpaStatus status,
+                                  void* pOpData, CpaFlatBuffer* pOut) {
+    if (NULL == pCallbackTag) return;
+
+    HE_QAT_TaskRequest* request = (HE_QAT_TaskRequest*)pCallbackTag;
+    HE_QAT_countResponse(request);
+
+    request->op_status = status;
+    HE_QAT_STATUS request_status = HE_QAT_STATUS_FAIL;
+    if (CPA_STATUS_SUCCESS == status && pOpData == request->op_data) {
+        if (request->op_output != (void*)request->op_result.pData)
+            memcpy(request->op_output, request->op_result.pData,
+                   request->op_result.dataLenInBytes);
+        request_status = HE_QAT_STATUS_READY;
+    }
+#ifdef HE_QAT_PERF
+    gettimeofday(&request->end, NULL);
+#endif
+
+    HE_QAT_completeAsyncRequest(request, request_status);
+}
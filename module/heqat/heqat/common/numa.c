@@ -0,0 +1,68 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/numa.c
+
+#define _GNU_SOURCE
+
+#include "heqat/common/numa.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "heqat/common/consts.h"
+
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+static cpu_set_t node_cpus[HE_QAT_MAX_NUMA_NODES];
+static unsigned char cpu_node[CPU_SETSIZE];  ///< 0 for CPUs of unknown nodes
+
+/// @brief Parse a sysfs CPU list such as "0-3,8-11".
+static void parse_cpulist(FILE* file, cpu_set_t* cpus) {
+    int first = 0;
+    int last = 0;
+    char sep = 0;
+    while (fscanf(file, "%d", &first) == 1) {
+        last = first;
+        sep = (char)fgetc(file);
+        if ('-' == sep) {
+            if (fscanf(file, "%d", &last) != 1) break;
+            sep = (char)fgetc(file);
+        }
+        for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, cpus);
+        if (',' != sep) break;
+    }
+}
+
+static void load_topology() {
+    char path[64];
+    for (int node = 0; node < HE_QAT_MAX_NUMA_NODES; node++) {
+        CPU_ZERO(&node_cpus[node]);
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+                 node);
+        FILE* file = fopen(path, "r");
+        if (NULL == file) continue;
+        parse_cpulist(file, &node_cpus[node]);
+        fclose(file);
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &node_cpus[node]))
+                cpu_node[cpu] = (unsigned char)node;
+    }
+}
+
+int HE_QAT_getCpuNode(int cpu) {
+    pthread_once(&topology_once, load_topology);
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return 0;
+    return cpu_node[cpu];
+}
+
+int HE_QAT_getNumaNode() { return HE_QAT_getCpuNode(sched_getcpu()); }
+
+int HE_QAT_getNodeCpus(int node, cpu_set_t* cpus) {
+    pthread_once(&topology_once, load_topology);
+    CPU_ZERO(cpus);
+    if (node < 0 || node >= HE_QAT_MAX_NUMA_NODES) return 0;
+    CPU_OR(cpus, cpus, &node_cpus[node]);
+    return CPU_COUNT(cpus);
+}
@@ -0,0 +1,207 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/ring.c
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "heqat/common/consts.h"
+#include "heqat/common/ring.h"
+#include "heqat/common/types.h"
+#include "heqat/common/utils.h"
+
+#define HE_QAT_RING_MASK(ring) ((ring)->capacity - 1)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HE_QAT_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define HE_QAT_CPU_RELAX() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+
+HE_QAT_STATUS HE_QAT_ringInit(HE_QAT_RequestBuffer* _ring,
+                              unsigned int capacity) {
+    if (NULL == _ring || 0 == capacity || capacity > HE_QAT_MAX_BUFFER_SIZE)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    unsigned long size = 1;
+    while (size < capacity) size <<= 1;
+
+    _ring->data = (void**)malloc(size * sizeof(void*));
+    _ring->seq = (unsigned long*)malloc(size * sizeof(unsigned long));
+    if (NULL == _ring->data || NULL == _ring->seq) {
+        free(_ring->data);
+        free(_ring->seq);
+        _ring->data = NULL;
+        _ring->seq = NULL;
+        _ring->capacity = 0;
+        HE_QAT_PRINT_ERR("Failed to allocate request buffer.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+    _ring->capacity = size;
+
+    for (unsigned long i = 0; i < size; i++) {
+        _ring->data[i] = NULL;
+        _ring->seq[i] = i;
+    }
+    _ring->next_free_slot = 0;
+    _ring->next_data_slot = 0;
+    _ring->next_data_out = 0;
+    // Spinning cannot help when the thread to wait for shares the only CPU
+    _ring->spin_limit =
+        (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? HE_QAT_MIN_SPIN_COUNT : 0;
+    _ring->data_waiters = 0;
+    _ring->slot_waiters = 0;
+    pthread_mutex_init(&_ring->mutex, NULL);
+    pthread_cond_init(&_ring->any_more_data, NULL);
+    pthread_cond_init(&_ring->any_free_slot, NULL);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+void HE_QAT_ringDestroy(HE_QAT_RequestBuffer* _ring) {
+    if (NULL == _ring || NULL == _ring->data) return;
+
+    free(_ring->data);
+    free(_ring->seq);
+    _ring->data = NULL;
+    _ring->seq = NULL;
+    _ring->capacity = 0;
+    pthread_mutex_destroy(&_ring->mutex);
+    pthread_cond_destroy(&_ring->any_more_data);
+    pthread_cond_destroy(&_ring->any_free_slot);
+}
+
+// The slot at the enqueue position is free
+static int has_free_slot(HE_QAT_RequestBuffer* _ring) {
+    unsigned long pos =
+        __atomic_load_n(&_ring->next_free_slot, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&_ring->seq[pos & HE_QAT_RING_MASK(_ring)],
+                           __ATOMIC_SEQ_CST) == pos;
+}
+
+// The slot at the dequeue position holds a request
+static int has_data(HE_QAT_RequestBuffer* _ring) {
+    unsigned long pos =
+        __atomic_load_n(&_ring->next_data_slot, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&_ring->seq[pos & HE_QAT_RING_MASK(_ring)],
+                           __ATOMIC_SEQ_CST) == pos + 1;
+}
+
+/// @brief Wait until ready(_ring) holds.
+/// @details Spins for up to spin_limit iterations first, then parks on cond.
+/// A spin_limit of 0 disables spinning.
+/// The spin budget doubles when spinning succeeds and halves when the thread
+/// has to park, so waits that are usually short stay off the mutex while
+/// long ones do not burn a core.
+static void wait_until(HE_QAT_RequestBuffer* _ring,
+                       int (*ready)(HE_QAT_RequestBuffer*), int* waiters,
+                       pthread_cond_t* cond) {
+    unsigned int limit =
+        __atomic_load_n(&_ring->spin_limit, __ATOMIC_RELAXED);
+    for (unsigned int i = 0; i < limit; i++) {
+        if (ready(_ring)) {
+            if (limit < HE_QAT_MAX_SPIN_COUNT)
+                __atomic_store_n(&_ring->spin_limit, 2 * limit,
+                                 __ATOMIC_RELAXED);
+            return;
+        }
+        HE_QAT_CPU_RELAX();
+    }
+    if (limit > HE_QAT_MIN_SPIN_COUNT)
+        __atomic_store_n(&_ring->spin_limit, limit / 2, __ATOMIC_RELAXED);
+
+    // Registering as a waiter before the last check pairs with the fence in
+    // wake_waiters(), so a wake-up cannot be missed
+    pthread_mutex_lock(&_ring->mutex);
+    __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    while (!ready(_ring)) pthread_cond_wait(cond, &_ring->mutex);
+    __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&_ring->mutex);
+}
+
+static void wake_waiters(HE_QAT_RequestBuffer* _ring, int* waiters,
+                         pthread_cond_t* cond) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (0 == __atomic_load_n(waiters, __ATOMIC_SEQ_CST)) return;
+    pthread_mutex_lock(&_ring->mutex);
+    pthread_cond_broadcast(cond);
+    pthread_mutex_unlock(&_ring->mutex);
+}
+
+int HE_QAT_ringTryPush(HE_QAT_RequestBuffer* _ring, void* item) {
+    unsigned long pos =
+        __atomic_load_n(&_ring->next_free_slot, __ATOMIC_RELAXED);
+    while (1) {
+        unsigned long* seq = &_ring->seq[pos & HE_QAT_RING_MASK(_ring)];
+        long diff = (long)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - pos);
+        if (0 == diff) {
+            // Claim the slot, pos is reloaded on failure
+            if (__atomic_compare_exchange_n(&_ring->next_free_slot, &pos,
+                                            pos + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                _ring->data[pos & HE_QAT_RING_MASK(_ring)] = item;
+                __atomic_store_n(seq, pos + 1, __ATOMIC_RELEASE);
+                wake_waiters(_ring, &_ring->data_waiters,
+                             &_ring->any_more_data);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0;  // full: the slot still holds the previous lap
+        } else {
+            pos = __atomic_load_n(&_ring->next_free_slot, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+void HE_QAT_ringPush(HE_QAT_RequestBuffer* _ring, void* item) {
+    while (!HE_QAT_ringTryPush(_ring, item))
+        wait_until(_ring, has_free_slot, &_ring->slot_waiters,
+                   &_ring->any_free_slot);
+}
+
+unsigned int HE_QAT_ringTryPop(HE_QAT_RequestBuffer* _ring, void** items,
+                               unsigned int max_items) {
+    unsigned int count = 0;
+    unsigned long pos =
+        __atomic_load_n(&_ring->next_data_slot, __ATOMIC_RELAXED);
+    while (count < max_items) {
+        unsigned long* seq = &_ring->seq[pos & HE_QAT_RING_MASK(_ring)];
+        long diff = (long)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (0 == diff) {
+            if (__atomic_compare_exchange_n(&_ring->next_data_slot, &pos,
+                                            pos + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                // The request stays in data[] for the waiting caller
+                items[count++] = _ring->data[pos & HE_QAT_RING_MASK(_ring)];
+                __atomic_store_n(seq, pos + _ring->capacity,
+                                 __ATOMIC_RELEASE);
+                pos++;
+            }
+        } else if (diff < 0) {
+            break;  // empty
+        } else {
+            pos = __atomic_load_n(&_ring->next_data_slot, __ATOMIC_RELAXED);
+        }
+    }
+    if (count > 0)
+        wake_waiters(_ring, &_ring->slot_waiters, &_ring->any_free_slot);
+    return count;
+}
+
+unsigned int HE_QAT_ringPop(HE_QAT_RequestBuffer* _ring, void** items,
+                            unsigned int max_items) {
+    unsigned int count;
+    while (0 == (count = HE_QAT_ringTryPop(_ring, items, max_items)))
+        wait_until(_ring, has_data, &_ring->data_waiters,
+                   &_ring->any_more_data);
+    return count;
+}
+
+unsigned int HE_QAT_ringSize(HE_QAT_RequestBuffer* _ring) {
+    unsigned long head =
+        __atomic_load_n(&_ring->next_data_slot, __ATOMIC_ACQUIRE);
+    unsigned long tail =
+        __atomic_load_n(&_ring->next_free_slot, __ATOMIC_ACQUIRE);
+    return (tail > head) ? (unsigned int)(tail - head) : 0;
+}
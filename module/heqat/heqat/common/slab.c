@@ -0,0 +1,136 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/slab.c
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heqat/common/consts.h"
+#include "heqat/common/numa.h"
+#include "heqat/common/ring.h"
+#include "heqat/common/slab.h"
+#include "heqat/common/types.h"
+#include "heqat/common/utils.h"
+
+static void init_slot(HE_QAT_RequestSlot* slot, HE_QAT_RequestSlab* slab) {
+    memset(slot, 0, sizeof(*slot));
+    slot->slab = (void*)slab;
+    pthread_mutex_init(&slot->request.mutex, NULL);
+    pthread_cond_init(&slot->request.ready, NULL);
+}
+
+static void destroy_slot(HE_QAT_RequestSlot* slot) {
+    HE_QAT_MEM_FREE_CONTIG(slot->mem);
+    slot->mem_len = 0;
+    pthread_mutex_destroy(&slot->request.mutex);
+    pthread_cond_destroy(&slot->request.ready);
+}
+
+HE_QAT_STATUS HE_QAT_slabInit(HE_QAT_RequestSlab* _slab,
+                              unsigned int capacity) {
+    if (NULL == _slab) return HE_QAT_STATUS_INVALID_PARAM;
+
+    HE_QAT_STATUS status = HE_QAT_ringInit(&_slab->free_list, capacity);
+    if (HE_QAT_STATUS_SUCCESS != status) return status;
+
+    _slab->slots = (HE_QAT_RequestSlot*)calloc(_slab->free_list.capacity,
+                                               sizeof(HE_QAT_RequestSlot));
+    if (NULL == _slab->slots) {
+        HE_QAT_ringDestroy(&_slab->free_list);
+        HE_QAT_PRINT_ERR("Failed to allocate request slab.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+
+    for (unsigned int i = 0; i < _slab->free_list.capacity; i++) {
+        init_slot(&_slab->slots[i], _slab);
+        HE_QAT_ringTryPush(&_slab->free_list, &_slab->slots[i]);
+    }
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+void HE_QAT_slabDestroy(HE_QAT_RequestSlab* _slab) {
+    if (NULL == _slab || NULL == _slab->slots) return;
+
+    for (unsigned int i = 0; i < _slab->free_list.capacity; i++)
+        destroy_slot(&_slab->slots[i]);
+    free(_slab->slots);
+    _slab->slots = NULL;
+
+    HE_QAT_ringDestroy(&_slab->free_list);
+}
+
+HE_QAT_TaskRequest* HE_QAT_slabAcquire(HE_QAT_RequestSlab* _slab, int len) {
+    HE_QAT_RequestSlot* slot = NULL;
+
+    if (NULL == _slab ||
+        0 == HE_QAT_ringTryPop(&_slab->free_list, (void**)&slot, 1)) {
+        HE_QAT_PRINT_DBG("Request slab exhausted.\n");
+        slot = (HE_QAT_RequestSlot*)malloc(sizeof(HE_QAT_RequestSlot));
+        if (NULL == slot) {
+            HE_QAT_PRINT_ERR("HE_QAT_RequestSlot memory allocation failed.\n");
+            return NULL;
+        }
+        init_slot(slot, NULL);
+    }
+
+    // Memory and routing follow the NUMA node of the submitting thread
+    int node = HE_QAT_getNumaNode();
+
+    // Each operand starts on an 8-byte boundary
+    Cpa32U stride = ((Cpa32U)len + BYTE_ALIGNMENT_8 - 1) &
+                    ~(Cpa32U)(BYTE_ALIGNMENT_8 - 1);
+    if (slot->mem_len < stride) {
+        HE_QAT_MEM_FREE_CONTIG(slot->mem);
+        slot->mem_len = 0;
+        if (HE_QAT_STATUS_SUCCESS !=
+                HE_QAT_memAllocContig((void**)&slot->mem, 4 * stride,
+                                      BYTE_ALIGNMENT_64, node) ||
+            NULL == slot->mem) {
+            HE_QAT_PRINT_ERR("Contiguous memory allocation failed.\n");
+            HE_QAT_slabRelease(&slot->request);
+            return NULL;
+        }
+        slot->mem_len = stride;
+    }
+    stride = slot->mem_len;
+
+    slot->op_data.base.pData = slot->mem;
+    slot->op_data.base.dataLenInBytes = len;
+    slot->op_data.exponent.pData = slot->mem + stride;
+    slot->op_data.exponent.dataLenInBytes = len;
+    slot->op_data.modulus.pData = slot->mem + 2 * stride;
+    slot->op_data.modulus.dataLenInBytes = len;
+
+    HE_QAT_TaskRequest* request = &slot->request;
+    request->id = 0;
+    request->op_type = HE_QAT_OP_NONE;
+    request->op_status = CPA_STATUS_SUCCESS;
+    request->op_data = (void*)&slot->op_data;
+    request->op_result.pData = slot->mem + 3 * stride;
+    request->op_result.dataLenInBytes = len;
+    request->op_output = NULL;
+    request->callback_func = NULL;
+    request->request_status = HE_QAT_STATUS_SUCCESS;
+    request->node = node;
+    request->completion_queue = NULL;
+    request->user_data = NULL;
+
+    return request;
+}
+
+void HE_QAT_slabRelease(HE_QAT_TaskRequest* request) {
+    if (NULL == request) return;
+
+    HE_QAT_RequestSlot* slot = (HE_QAT_RequestSlot*)request;
+    HE_QAT_RequestSlab* slab = (HE_QAT_RequestSlab*)slot->slab;
+    if (NULL == slab) {
+        destroy_slot(slot);
+        free(slot);
+        return;
+    }
+
+    // Never full: the free list has room for every slot of the slab
+    HE_QAT_ringTryPush(&slab->free_list, slot);
+}
@@ -9,10 +9,15 @@
 #include <qae_mem.h>
 
 #include <pthread.h>
+#include <sched.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include "heqat/common/types.h"
+#include "heqat/common/numa.h"
+#include "heqat/common/ring.h"
+#include "heqat/common/slab.h"
 #include "heqat/common/utils.h"
 #include "heqat/context.h"
 
@@ -31,14 +36,27 @@ static pthread_mutex_t context_lock;
 
 // Global variable declarations
 static pthread_t buffer_manager;
+static int buffer_manager_started = 0;
 static pthread_t he_qat_runner;
-static pthread_attr_t he_qat_inst_attr[HE_QAT_NUM_ACTIVE_INSTANCES];
-static HE_QAT_InstConfig he_qat_inst_config[HE_QAT_NUM_ACTIVE_INSTANCES];
+static pthread_attr_t* he_qat_inst_attr = NULL;
+static HE_QAT_InstConfig* he_qat_inst_config = NULL;
 static HE_QAT_Config* he_qat_config = NULL;
 
 // External global variables
+extern HE_QAT_Limits qat_limits;
 extern HE_QAT_RequestBuffer he_qat_buffer;
 extern HE_QAT_OutstandingBuffer outstanding;
+extern HE_QAT_RequestSlab* request_slab;
+extern HE_QAT_PollConfig poll_config;
+extern volatile unsigned long inflight_limit;
+extern volatile unsigned long throttle_waits;
+extern pthread_mutex_t response_mutex;
+extern volatile unsigned long response_count;
+extern volatile unsigned long long response_latency_ns;
+
+// Values of the response counters at the last reset_qat_poll_stats()
+static unsigned long stats_response_count = 0;
+static unsigned long long stats_latency_ns = 0;
 
 /***********           Internal Services          ***********/
 // Start scheduler of work requests (consumer)
@@ -59,34 +77,85 @@ extern void* start_perform_op(void* _inst_config);
 static Cpa16U numInstances = 0;
 static Cpa16U nextInstance = 0;
 
-static CpaInstanceHandle get_qat_instance() {
+/// @brief Select the instances to use among those found.
+/// @details Takes instances from each NUMA node in turn, so that the devices
+/// of every socket are used, and lists the selected ones grouped by node.
+/// @param[in] found Instances found.
+/// @param[in] found_node NUMA node of each instance found.
+/// @param[in] num_found Number of instances found.
+/// @param[out] handles Selected instances.
+/// @param[out] nodes NUMA node of each selected instance.
+/// @param[in] num_selected Number of instances to select.
+static void select_instances(const CpaInstanceHandle* found,
+                             const Cpa32U* found_node, unsigned int num_found,
+                             CpaInstanceHandle* handles, Cpa32U* nodes,
+                             unsigned int num_selected) {
+    static unsigned char taken[MAX_INSTANCES];
+    unsigned int cursor[HE_QAT_MAX_NUMA_NODES] = {0};
+
+    for (unsigned int i = 0; i < num_found; i++) taken[i] = 0;
+    for (unsigned int count = 0; count < num_selected;) {
+        for (Cpa32U node = 0;
+             node < HE_QAT_MAX_NUMA_NODES && count < num_selected; node++) {
+            while (cursor[node] < num_found &&
+                   found_node[cursor[node]] != node)
+                cursor[node]++;
+            if (cursor[node] < num_found) {
+                taken[cursor[node]++] = 1;
+                count++;
+            }
+        }
+    }
+
+    unsigned int next = 0;
+    for (Cpa32U node = 0; node < HE_QAT_MAX_NUMA_NODES; node++) {
+        for (unsigned int i = 0; i < num_found; i++) {
+            if (taken[i] && found_node[i] == node) {
+                handles[next] = found[i];
+                nodes[next++] = node;
+            }
+        }
+    }
+}
+
+/// @brief Get the next instance to use, cycling through the selected ones.
+/// @param[in] max_instances Number of instances to select on the first call,
+/// 0 for every instance found.
+/// @param[out] node NUMA node the instance's device is attached to.
+static CpaInstanceHandle get_qat_instance(unsigned int max_instances,
+                                          Cpa32U* node) {
     static CpaInstanceHandle cyInstHandles[MAX_INSTANCES];
+    static Cpa32U cyInstNodes[MAX_INSTANCES];
     CpaStatus status = CPA_STATUS_SUCCESS;
     CpaInstanceInfo2 info = {0};
 
     if (0 == numInstances) {
-        status = cpaCyGetNumInstances(&numInstances);
-        if (numInstances >= MAX_INSTANCES) {
-            numInstances = MAX_INSTANCES;
-        }
-        if (numInstances >= HE_QAT_NUM_ACTIVE_INSTANCES) {
-            numInstances = HE_QAT_NUM_ACTIVE_INSTANCES;
+        static CpaInstanceHandle found[MAX_INSTANCES];
+        static Cpa32U found_node[MAX_INSTANCES];
+        Cpa16U num_found = 0;
+
+        status = cpaCyGetNumInstances(&num_found);
+        if (num_found >= MAX_INSTANCES) {
+            num_found = MAX_INSTANCES;
         }
 
         if (CPA_STATUS_SUCCESS != status) {
-            HE_QAT_PRINT_ERR("No CyInstances Found (%d).\n", numInstances);
+            HE_QAT_PRINT_ERR("No CyInstances Found (%d).\n", num_found);
             return NULL;
         }
 
-        HE_QAT_PRINT_DBG("Found %d CyInstances.\n", numInstances);
+        HE_QAT_PRINT_DBG("Found %d CyInstances.\n", num_found);
 
-        if ((status == CPA_STATUS_SUCCESS) && (numInstances > 0)) {
-            status = cpaCyGetInstances(numInstances, cyInstHandles);
+        if ((status == CPA_STATUS_SUCCESS) && (num_found > 0)) {
+            status = cpaCyGetInstances(num_found, found);
 
             // List instances and their characteristics
-            for (unsigned int i = 0; i < numInstances; i++) {
-                status = cpaCyInstanceGetInfo2(cyInstHandles[i], &info);
+            for (unsigned int i = 0; i < num_found; i++) {
+                status = cpaCyInstanceGetInfo2(found[i], &info);
                 if (CPA_STATUS_SUCCESS != status) return NULL;
+                found_node[i] = (info.nodeAffinity < HE_QAT_MAX_NUMA_NODES)
+                                    ? info.nodeAffinity
+                                    : 0;
 #ifdef HE_QAT_DEBUG
                 HE_QAT_PRINT("Vendor Name: %s\n", info.vendorName);
                 HE_QAT_PRINT("Part Name: %s\n", info.partName);
@@ -104,13 +173,22 @@ static CpaInstanceHandle get_qat_instance() {
                              info.physInstId.kptAcHandle);
 #endif
             }
+
+            // Keep the devices of every node busy, grouped by node
+            numInstances = (0 == max_instances || num_found < max_instances)
+                               ? num_found
+                               : max_instances;
+            select_instances(found, found_node, num_found, cyInstHandles,
+                             cyInstNodes, numInstances);
             HE_QAT_PRINT_DBG("Next Instance: %d.\n", nextInstance);
 
-            if (status == CPA_STATUS_SUCCESS)
+            if (status == CPA_STATUS_SUCCESS) {
+                *node = cyInstNodes[nextInstance];
                 return cyInstHandles[nextInstance];
+            }
         }
 
-        if (0 == numInstances) {
+        if (0 == num_found) {
             HE_QAT_PRINT_ERR("No instances found for 'SSL'\n");
             HE_QAT_PRINT_ERR("Please check your section names");
             HE_QAT_PRINT_ERR(" in the config file.\n");
@@ -123,19 +201,145 @@ static CpaInstanceHandle get_qat_instance() {
     nextInstance = ((nextInstance + 1) % numInstances);
     HE_QAT_PRINT_DBG("Next Instance: %d.\n", nextInstance);
 
+    *node = cyInstNodes[nextInstance];
     return cyInstHandles[nextInstance];
 }
 
+/// @brief Select the CPU to pin the polling thread of an instance to.
+/// @details The local_id-th CPU of the instance's NUMA node the process may
+/// run on, wrapping around on nodes with fewer CPUs than instances. Falls
+/// back to all the CPUs the process may run on if it has none on that node.
+/// @param[in] node NUMA node of the instance.
+/// @param[in] local_id Index of the instance among those of its node.
+static int get_inst_cpu(Cpa32U node, int local_id) {
+    cpu_set_t allowed;
+    cpu_set_t local;
+    CPU_ZERO(&allowed);
+    if (0 != sched_getaffinity(0, sizeof(cpu_set_t), &allowed))
+        return local_id;
+
+    HE_QAT_getNodeCpus(node, &local);
+    CPU_AND(&local, &local, &allowed);
+    if (CPU_COUNT(&local) > 0) allowed = local;
+
+    int n = local_id % CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && 0 == n--) return cpu;
+    }
+    return local_id;
+}
+
+/// @brief Free the buffers allocated by init_context_buffers().
+static void free_context_buffers() {
+    HE_QAT_ringDestroy(&he_qat_buffer);
+
+    if (NULL != outstanding.buffer) {
+        for (unsigned int i = 0; i < outstanding.count; i++)
+            HE_QAT_ringDestroy(&outstanding.buffer[i]);
+    }
+    free(outstanding.buffer);
+    free(outstanding.free_buffer);
+    free(outstanding.ready_buffer);
+    outstanding.buffer = NULL;
+    outstanding.free_buffer = NULL;
+    outstanding.ready_buffer = NULL;
+
+    if (NULL != request_slab) {
+        for (unsigned int i = 0; i <= outstanding.count; i++)
+            HE_QAT_slabDestroy(&request_slab[i]);
+    }
+    free(request_slab);
+    request_slab = NULL;
+    outstanding.count = 0;
+
+    free(he_qat_inst_attr);
+    free(he_qat_inst_config);
+    free(he_qat_config);
+    he_qat_inst_attr = NULL;
+    he_qat_inst_config = NULL;
+    he_qat_config = NULL;
+}
+
+/// @brief Allocate the request buffers, work requests and instance
+/// configurations sized by qat_limits.
+/// @details Rounds qat_limits.buffer_size up to the capacity of the buffers.
+/// Work requests get their QAT memory on first use.
+static HE_QAT_STATUS init_context_buffers() {
+    if (HE_QAT_STATUS_SUCCESS !=
+        HE_QAT_ringInit(&he_qat_buffer, qat_limits.buffer_size))
+        return HE_QAT_STATUS_FAIL;
+    qat_limits.buffer_size = he_qat_buffer.capacity;
+
+    unsigned int count = qat_limits.buffer_count;
+    outstanding.buffer =
+        (HE_QAT_RequestBuffer*)calloc(count, sizeof(HE_QAT_RequestBuffer));
+    outstanding.free_buffer = (int*)calloc(count, sizeof(int));
+    outstanding.ready_buffer = (int*)calloc(count, sizeof(int));
+    request_slab =
+        (HE_QAT_RequestSlab*)calloc(count + 1, sizeof(HE_QAT_RequestSlab));
+    outstanding.count = count;
+    he_qat_inst_attr = (pthread_attr_t*)calloc(qat_limits.num_instances,
+                                               sizeof(pthread_attr_t));
+    he_qat_inst_config = (HE_QAT_InstConfig*)calloc(
+        qat_limits.num_instances, sizeof(HE_QAT_InstConfig));
+    he_qat_config = (HE_QAT_Config*)malloc(sizeof(HE_QAT_Config));
+    if (NULL == outstanding.buffer || NULL == outstanding.free_buffer ||
+        NULL == outstanding.ready_buffer || NULL == request_slab ||
+        NULL == he_qat_inst_attr || NULL == he_qat_inst_config ||
+        NULL == he_qat_config)
+        return HE_QAT_STATUS_FAIL;
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (HE_QAT_STATUS_SUCCESS !=
+            HE_QAT_ringInit(&outstanding.buffer[i], qat_limits.buffer_size))
+            return HE_QAT_STATUS_FAIL;
+    }
+    for (unsigned int i = 0; i <= count; i++) {
+        if (HE_QAT_STATUS_SUCCESS !=
+            HE_QAT_slabInit(&request_slab[i], qat_limits.buffer_size))
+            return HE_QAT_STATUS_FAIL;
+    }
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+/// @brief Forget the instances selected and the limits set, so that the next
+/// acquire_qat_devices() starts over.
+static void reset_qat_limits() {
+    qat_limits.num_instances = HE_QAT_NUM_ACTIVE_INSTANCES;
+    qat_limits.buffer_size = HE_QAT_BUFFER_SIZE;
+    qat_limits.buffer_count = HE_QAT_BUFFER_COUNT;
+
+    numInstances = 0;
+    nextInstance = 0;
+}
+
 /// @brief
-/// Acquire QAT instances and set up QAT execution environment.
+/// Acquire QAT instances and set up QAT execution environment with the
+/// default limits.
 HE_QAT_STATUS acquire_qat_devices() {
+    HE_QAT_Limits limits = {HE_QAT_NUM_ACTIVE_INSTANCES, HE_QAT_BUFFER_SIZE,
+                            HE_QAT_BUFFER_COUNT};
+    return acquire_qat_devices_with_limits(&limits);
+}
+
+/// @brief
+/// Acquire QAT instances and set up QAT execution environment.
+/// @details If fewer instances are found than requested, the instances found
+/// are shared round-robin. The limits are ignored if the environment is
+/// already set up.
+/// @param[in] limits Number of instances and capacity of the buffers.
+HE_QAT_STATUS acquire_qat_devices_with_limits(const HE_QAT_Limits* limits) {
     CpaStatus status = CPA_STATUS_FAIL;
 
+    if (NULL == limits || limits->buffer_size > HE_QAT_MAX_BUFFER_SIZE)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
     pthread_mutex_lock(&context_lock);
 
     // Handle cases where acquire_qat_devices() is called when already active
     // and running
-    if (HE_QAT_STATUS_ACTIVE == context_state) {
+    if (HE_QAT_STATUS_INACTIVE != context_state) {
         pthread_mutex_unlock(&context_lock);
         return HE_QAT_STATUS_SUCCESS;
     }
@@ -151,62 +355,70 @@ HE_QAT_STATUS acquire_qat_devices() {
 
     status = icp_sal_userStartMultiProcess("SSL", CPA_FALSE);
     if (CPA_STATUS_SUCCESS != status) {
+        qaeMemDestroy();
         pthread_mutex_unlock(&context_lock);
         HE_QAT_PRINT_ERR("Failed to start SAL user process SSL\n");
-        qaeMemDestroy();
         return HE_QAT_STATUS_FAIL;
     }
     HE_QAT_PRINT_DBG("SAL user process successfully started.\n");
 
-    CpaInstanceHandle _inst_handle[HE_QAT_NUM_ACTIVE_INSTANCES];
-    for (unsigned int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
-        _inst_handle[i] = get_qat_instance();
-        if (_inst_handle[i] == NULL) {
-            pthread_mutex_unlock(&context_lock);
-            HE_QAT_PRINT_ERR("Failed to find QAT endpoints.\n");
-            return HE_QAT_STATUS_FAIL;
-        }
+    // The first call selects the instances, every instance found unless
+    // limited
+    Cpa32U first_node = 0;
+    CpaInstanceHandle first_handle =
+        get_qat_instance(limits->num_instances, &first_node);
+    if (first_handle == NULL) {
+        reset_qat_limits();
+        icp_sal_userStop();
+        qaeMemDestroy();
+        pthread_mutex_unlock(&context_lock);
+        HE_QAT_PRINT_ERR("Failed to find QAT endpoints.\n");
+        return HE_QAT_STATUS_FAIL;
     }
 
     HE_QAT_PRINT_DBG("Found QAT endpoints.\n");
 
-    // Initialize QAT buffer synchronization attributes
-    he_qat_buffer.count = 0;
-    he_qat_buffer.next_free_slot = 0;
-    he_qat_buffer.next_data_slot = 0;
-
-    // Initialize QAT memory buffer
-    for (int i = 0; i < HE_QAT_BUFFER_SIZE; i++) {
-        he_qat_buffer.data[i] = NULL;
+    qat_limits.num_instances =
+        limits->num_instances ? limits->num_instances : numInstances;
+    qat_limits.buffer_size =
+        limits->buffer_size ? limits->buffer_size : HE_QAT_BUFFER_SIZE;
+    qat_limits.buffer_count =
+        limits->buffer_count ? limits->buffer_count : HE_QAT_BUFFER_COUNT;
+
+    // Allocate QAT internal buffer, outstanding buffers and work requests
+    if (HE_QAT_STATUS_SUCCESS != init_context_buffers()) {
+        free_context_buffers();
+        reset_qat_limits();
+        icp_sal_userStop();
+        qaeMemDestroy();
+        pthread_mutex_unlock(&context_lock);
+        HE_QAT_PRINT_ERR("Failed to allocate work requests.\n");
+        return HE_QAT_STATUS_FAIL;
     }
 
     // Initialize QAT outstanding buffers
     outstanding.busy_count = 0;
     outstanding.next_free_buffer = 0;
     outstanding.next_ready_buffer = 0;
-    for (int i = 0; i < HE_QAT_BUFFER_COUNT; i++) {
+    for (unsigned int i = 0; i < outstanding.count; i++) {
         outstanding.free_buffer[i] = 1;
         outstanding.ready_buffer[i] = 0;
-        outstanding.buffer[i].count = 0;
-        outstanding.buffer[i].next_free_slot = 0;
-        outstanding.buffer[i].next_data_slot = 0;
-        outstanding.buffer[i].next_data_out = 0;
-        for (int j = 0; j < HE_QAT_BUFFER_SIZE; j++) {
-            outstanding.buffer[i].data[j] = NULL;
-        }
-        pthread_mutex_init(&outstanding.buffer[i].mutex, NULL);
-        pthread_cond_init(&outstanding.buffer[i].any_more_data, NULL);
-        pthread_cond_init(&outstanding.buffer[i].any_free_slot, NULL);
     }
     pthread_mutex_init(&outstanding.mutex, NULL);
     pthread_cond_init(&outstanding.any_free_buffer, NULL);
     pthread_cond_init(&outstanding.any_ready_buffer, NULL);
 
-    // Creating QAT instances (consumer threads) to process op requests
+    // Creating QAT instances (consumer threads) to process op requests, their
+    // threads run on the NUMA node of the device
     cpu_set_t cpus;
-    for (int i = 0; i < HE_QAT_NUM_ACTIVE_INSTANCES; i++) {
+    int local_id[HE_QAT_MAX_NUMA_NODES] = {0};
+    for (unsigned int i = 0; i < qat_limits.num_instances; i++) {
+        Cpa32U node = first_node;
+        CpaInstanceHandle handle =
+            (0 == i) ? first_handle : get_qat_instance(0, &node);
+
         CPU_ZERO(&cpus);
-        CPU_SET(i, &cpus);
+        CPU_SET(get_inst_cpu(node, local_id[node]++), &cpus);
         pthread_attr_init(&he_qat_inst_attr[i]);
         pthread_attr_setaffinity_np(&he_qat_inst_attr[i], sizeof(cpu_set_t),
                                     &cpus);
@@ -218,30 +430,45 @@ HE_QAT_STATUS acquire_qat_devices() {
         he_qat_inst_config[i].status = CPA_STATUS_FAIL;
         pthread_mutex_init(&he_qat_inst_config[i].mutex, NULL);
         pthread_cond_init(&he_qat_inst_config[i].ready, NULL);
-        he_qat_inst_config[i].inst_handle = _inst_handle[i];
+        pthread_cond_init(&he_qat_inst_config[i].work, NULL);
+        he_qat_inst_config[i].idle = 0;
+        he_qat_inst_config[i].submitted = 0;
+        he_qat_inst_config[i].completed = 0;
+        he_qat_inst_config[i].polls = 0;
+        he_qat_inst_config[i].empty_polls = 0;
+        he_qat_inst_config[i].idle_waits = 0;
+        he_qat_inst_config[i].inst_handle = handle;
         he_qat_inst_config[i].inst_id = i;
+        he_qat_inst_config[i].node = node;
         he_qat_inst_config[i].attr = &he_qat_inst_attr[i];
     }
 
-    he_qat_config = (HE_QAT_Config*)malloc(sizeof(HE_QAT_Config));
+    // Adaptive policies start from the in-flight limit of the fixed policy
+    inflight_limit = 2 * NUM_PKE_SLICES * qat_limits.num_instances;
+    throttle_waits = 0;
+    pthread_mutex_lock(&response_mutex);
+    stats_response_count = response_count;
+    stats_latency_ns = response_latency_ns;
+    pthread_mutex_unlock(&response_mutex);
+
     he_qat_config->inst_config = he_qat_inst_config;
-    he_qat_config->count = HE_QAT_NUM_ACTIVE_INSTANCES;
-    he_qat_config->running = 0;
+    he_qat_config->count = qat_limits.num_instances;
+    he_qat_config->running = 1;
     he_qat_config->active = 0;
 
+    // The processing thread runs the qat instances in the background until
+    // release_qat_devices() joins it
     pthread_create(&he_qat_runner, NULL, start_instances, (void*)he_qat_config);
     HE_QAT_PRINT_DBG("Created processing threads.\n");
 
-    // Dispatch the qat instances to run independently in the background
-    pthread_detach(he_qat_runner);
-    HE_QAT_PRINT_DBG("Detached processing threads.\n");
-
     // Set context state to active
     context_state = HE_QAT_STATUS_ACTIVE;
 
     // Launch buffer manager thread to schedule incoming requests
-    if (0 != pthread_create(&buffer_manager, NULL, schedule_requests,
-                            (void*)&context_state)) {
+    buffer_manager_started = (0 == pthread_create(&buffer_manager, NULL,
+                                                  schedule_requests,
+                                                  (void*)&context_state));
+    if (!buffer_manager_started) {
         pthread_mutex_unlock(&context_lock);
         release_qat_devices();
         HE_QAT_PRINT_ERR(
@@ -250,15 +477,6 @@ HE_QAT_STATUS acquire_qat_devices() {
         return HE_QAT_STATUS_FAIL;
     }
 
-    if (0 != pthread_detach(buffer_manager)) {
-        pthread_mutex_unlock(&context_lock);
-        release_qat_devices();
-        HE_QAT_PRINT_ERR(
-            "Failed to complete QAT initialization while launching buffer "
-            "manager thread.\n");
-        return HE_QAT_STATUS_FAIL;
-    }
-
     pthread_mutex_unlock(&context_lock);
 
     return HE_QAT_STATUS_SUCCESS;
@@ -280,23 +498,118 @@ HE_QAT_STATUS release_qat_devices() {
     // Deactivate context (this will terminate buffer manager thread
     context_state = HE_QAT_STATUS_INACTIVE;
 
+    // Wake the buffer manager and processing threads up, they exit before
+    // the buffers they use are freed
+    pthread_mutex_lock(&outstanding.mutex);
+    pthread_cond_broadcast(&outstanding.any_ready_buffer);
+    pthread_mutex_unlock(&outstanding.mutex);
+    if (buffer_manager_started) pthread_join(buffer_manager, NULL);
+    buffer_manager_started = 0;
+    HE_QAT_ringTryPush(&he_qat_buffer, NULL);
+    pthread_join(he_qat_runner, NULL);
+    HE_QAT_PRINT_DBG("Joined buffer manager and processing threads.\n");
+
     // Stop QAT SSL service
     icp_sal_userStop();
     HE_QAT_PRINT_DBG("Stopped SAL user process.\n");
 
     // Release QAT allocated memory
+    for (unsigned int i = 0; i < qat_limits.num_instances; i++)
+        pthread_attr_destroy(&he_qat_inst_attr[i]);
+    free_context_buffers();
     qaeMemDestroy();
     HE_QAT_PRINT_DBG("Release QAT memory.\n");
 
-    numInstances = 0;
-    nextInstance = 0;
+    reset_qat_limits();
 
     pthread_mutex_unlock(&context_lock);
 
     return HE_QAT_STATUS_SUCCESS;
 }
 
+/// @brief Read the limits of the acquired devices, or the default limits if
+/// none are acquired.
+/// @param[out] limits Number of instances in use and capacity of the
+/// buffers.
+void get_qat_limits(HE_QAT_Limits* limits) {
+    if (NULL == limits) return;
+    *limits = qat_limits;
+}
+
 /// @brief  Retrieve and read context state.
 /// @return Possible return values are HE_QAT_STATUS_ACTIVE,
 ///         HE_QAT_STATUS_RUNNING, and HE_QAT_STATUS_INACTIVE.
 HE_QAT_STATUS get_qat_context_state() { return context_state; }
+
+/// @brief Select how instances poll for responses and throttle submissions.
+/// @details The policy applies to the devices acquired by the next call to
+/// acquire_qat_devices(), the latency target applies immediately.
+/// @param[in] config Polling policy and latency target.
+HE_QAT_STATUS set_qat_poll_config(const HE_QAT_PollConfig* config) {
+    if (NULL == config) return HE_QAT_STATUS_INVALID_PARAM;
+    if (HE_QAT_POLL_FIXED != config->policy &&
+        HE_QAT_POLL_ADAPTIVE != config->policy &&
+        HE_QAT_POLL_EVENT != config->policy)
+        return HE_QAT_STATUS_INVALID_PARAM;
+
+    pthread_mutex_lock(&context_lock);
+    poll_config = *config;
+    pthread_mutex_unlock(&context_lock);
+
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+/// @brief Read the polling configuration set with set_qat_poll_config().
+/// @param[out] config Polling policy and latency target.
+void get_qat_poll_config(HE_QAT_PollConfig* config) {
+    if (NULL == config) return;
+    *config = poll_config;
+}
+
+/// @brief Collect the polling counters since the devices were acquired or
+/// reset_qat_poll_stats() was last called.
+/// @param[out] stats Polling counters.
+void get_qat_poll_stats(HE_QAT_PollStats* stats) {
+    if (NULL == stats) return;
+
+    stats->polls = 0;
+    stats->empty_polls = 0;
+    stats->idle_waits = 0;
+    for (unsigned int i = 0; NULL != he_qat_inst_config &&
+                             i < qat_limits.num_instances;
+         i++) {
+        stats->polls += he_qat_inst_config[i].polls;
+        stats->empty_polls += he_qat_inst_config[i].empty_polls;
+        stats->idle_waits += he_qat_inst_config[i].idle_waits;
+    }
+    stats->throttle_waits = throttle_waits;
+
+    pthread_mutex_lock(&response_mutex);
+    stats->responses = response_count - stats_response_count;
+    unsigned long long latency_ns = response_latency_ns - stats_latency_ns;
+    pthread_mutex_unlock(&response_mutex);
+
+    stats->avg_latency_us =
+        stats->responses ? latency_ns / (1000.0 * stats->responses) : 0.0;
+    stats->inflight_limit = (HE_QAT_POLL_FIXED == poll_config.policy)
+                                ? 2 * NUM_PKE_SLICES *
+                                      qat_limits.num_instances
+                                : inflight_limit;
+}
+
+/// @brief Reset the counters reported by get_qat_poll_stats().
+void reset_qat_poll_stats() {
+    for (unsigned int i = 0; NULL != he_qat_inst_config &&
+                             i < qat_limits.num_instances;
+         i++) {
+        he_qat_inst_config[i].polls = 0;
+        he_qat_inst_config[i].empty_polls = 0;
+        he_qat_inst_config[i].idle_waits = 0;
+    }
+    throttle_waits = 0;
+
+    pthread_mutex_lock(&response_mutex);
+    stats_response_count = response_count;
+    stats_latency_ns = response_latency_ns;
+    pthread_mutex_unlock(&response_mutex);
+}
@@ -4,8 +4,11 @@
 
 // C support libraries
 #include <stdio.h>
+#include <stdlib.h>
 #include <pthread.h>
+#include <poll.h>
 #include <assert.h>
+#include <errno.h>
 #include <openssl/bn.h>
 
 // Global variables used to hold measured performance numbers.
@@ -25,6 +28,7 @@ double time_taken = 0.0;
 #include "heqat/common/utils.h"
 #include "heqat/common/consts.h"
 #include "heqat/common/types.h"
+#include "heqat/common/ring.h"
 
 // Warn user on selected execution mode
 #ifdef HE_QAT_SYNC_MODE
@@ -34,12 +38,21 @@ double time_taken = 0.0;
 #endif
 
 // Global buffer for the runtime environment
+HE_QAT_Limits qat_limits = {
+    HE_QAT_NUM_ACTIVE_INSTANCES, HE_QAT_BUFFER_SIZE,
+    HE_QAT_BUFFER_COUNT};  ///< Limits of the acquired devices, with the
+                           ///< number of instances in use and the buffer size
+                           ///< rounded up to a power of 2.
 HE_QAT_RequestBuffer
     he_qat_buffer;  ///< This the internal buffer that holds and serializes the
                     ///< requests to the accelerator.
 HE_QAT_OutstandingBuffer
     outstanding;  ///< This is the data structure that holds outstanding
                   ///< requests from separate active threads calling the API.
+HE_QAT_RequestSlab* request_slab =
+    NULL;  ///< Preallocated requests: one slab per outstanding buffer plus
+           ///< one for the single-threaded interface, at index
+           ///< qat_limits.buffer_count.
 volatile unsigned long response_count =
     0;  ///< Counter of processed requests and it is used to help control
         ///< throttling.
@@ -56,6 +69,56 @@ static unsigned long max_pending =
                                     ///< accelerator that are pending
                                     ///< completion.
 
+// Polling and throttling policy
+HE_QAT_PollConfig poll_config = {HE_QAT_POLL_EVENT,
+                                 0};  ///< Selected with set_qat_poll_config().
+volatile unsigned long inflight_limit =
+    2 * NUM_PKE_SLICES *
+    HE_QAT_NUM_ACTIVE_INSTANCES;  ///< In-flight limit of the adaptive
+                                  ///< policies, tuned towards
+                                  ///< poll_config.target_latency_us.
+volatile unsigned long throttle_waits =
+    0;  ///< Number of waits of the scheduler on the in-flight limit.
+pthread_mutex_t response_mutex =
+    PTHREAD_MUTEX_INITIALIZER;  ///< Protects response_count and
+                                ///< response_latency_ns against concurrent
+                                ///< callback events.
+pthread_cond_t response_ready =
+    PTHREAD_COND_INITIALIZER;  ///< Signaled on responses while the scheduler
+                               ///< waits on it (HE_QAT_POLL_EVENT).
+volatile int response_waiters = 0;  ///< Threads waiting on response_ready.
+volatile unsigned long long response_latency_ns =
+    0;  ///< Sum of the latencies of the responses counted in response_count.
+__thread unsigned long polled_responses =
+    0;  ///< Responses delivered to callbacks in the calling thread.
+
+// Completion of asynchronous requests, see cb.c
+extern void HE_QAT_completeAsyncRequest(HE_QAT_TaskRequest* request,
+                                        HE_QAT_STATUS status);
+
+/// @brief Allocate an empty list of requests.
+/// @param[out] _requests List to initialize.
+/// @param[in] capacity Maximum number of requests in the list.
+static HE_QAT_STATUS init_request_list(HE_QAT_TaskRequestList* _requests,
+                                       unsigned int capacity) {
+    _requests->request =
+        (HE_QAT_TaskRequest**)calloc(capacity, sizeof(HE_QAT_TaskRequest*));
+    _requests->count = 0;
+    _requests->capacity = (NULL == _requests->request) ? 0 : capacity;
+    if (NULL == _requests->request) {
+        HE_QAT_PRINT_ERR("Failed to allocate request list.\n");
+        return HE_QAT_STATUS_FAIL;
+    }
+    return HE_QAT_STATUS_SUCCESS;
+}
+
+static void free_request_list(HE_QAT_TaskRequestList* _requests) {
+    free(_requests->request);
+    _requests->request = NULL;
+    _requests->count = 0;
+    _requests->capacity = 0;
+}
+
 /// @brief Populate internal buffer with incoming requests from API calls.
 /// @details This function is called from the main APIs to submit requests to
 /// a shared internal buffer for processing on QAT. It is a thread-safe
@@ -66,28 +129,14 @@ static unsigned long max_pending =
 /// @param[out] _buffer Either `he_qat_buffer` or `outstanding` buffer.
 /// @param[in] args Work request packaged in a custom data structure.
 void submit_request(HE_QAT_RequestBuffer* _buffer, void* args) {
-    HE_QAT_PRINT_DBG("Lock write request\n");
-
-    pthread_mutex_lock(&_buffer->mutex);
-
-    HE_QAT_PRINT_DBG("Wait lock write request. [buffer size: %d]\n",
-                     _buffer->count);
-
-    while (_buffer->count >= HE_QAT_BUFFER_SIZE)
-        pthread_cond_wait(&_buffer->any_free_slot, &_buffer->mutex);
-
-    assert(_buffer->count < HE_QAT_BUFFER_SIZE);
-
-    _buffer->data[_buffer->next_free_slot++] = args;
-
-    _buffer->next_free_slot %= HE_QAT_BUFFER_SIZE;
-    _buffer->count++;
+    HE_QAT_PRINT_DBG("Write request. [buffer size: %u]\n",
+                     HE_QAT_ringSize(_buffer));
 
-    pthread_cond_signal(&_buffer->any_more_data);
-    pthread_mutex_unlock(&_buffer->mutex);
+    // Waits for a free slot while the buffer is full
+    HE_QAT_ringPush(_buffer, args);
 
-    HE_QAT_PRINT_DBG("Unlocked write request. [buffer size: %d]\n",
-                     _buffer->count);
+    HE_QAT_PRINT_DBG("Wrote request. [buffer size: %u]\n",
+                     HE_QAT_ringSize(_buffer));
 }
 
 /// @brief Populates internal buffer with a list of work request.
@@ -101,39 +150,23 @@ void submit_request(HE_QAT_RequestBuffer* _buffer, void* args) {
 /// (`outstanding`) holding outstanding requests.
 static void submit_request_list(HE_QAT_RequestBuffer* _buffer,
                                 HE_QAT_TaskRequestList* _requests) {
-    HE_QAT_PRINT_DBG("Lock submit request list\n");
-
     if (0 == _requests->count) return;
 
-    pthread_mutex_lock(&_buffer->mutex);
-
     HE_QAT_PRINT_DBG(
-        "Wait lock submit request list. [internal buffer size: %d] [num "
-        "requests: %u]\n",
-        _buffer->count, _requests->count);
-
-    // Wait until buffer can accomodate the number of input requests
-    while (_buffer->count >= HE_QAT_BUFFER_SIZE ||
-           (HE_QAT_BUFFER_SIZE - _buffer->count) < _requests->count)
-        pthread_cond_wait(&_buffer->any_free_slot, &_buffer->mutex);
-
-    assert(_buffer->count < HE_QAT_BUFFER_SIZE);
-    // assert(_requests->count <= (HE_QAT_BUFFER_SIZE - _buffer->count));
+        "Submit request list. [internal buffer size: %u] [num requests: "
+        "%u]\n",
+        HE_QAT_ringSize(_buffer), _requests->count);
 
+    // Requests are published one at a time, so the instance threads can
+    // start on the head of the list while the rest is being enqueued
     for (unsigned int i = 0; i < _requests->count; i++) {
-        _buffer->data[_buffer->next_free_slot++] = _requests->request[i];
-        _buffer->next_free_slot %= HE_QAT_BUFFER_SIZE;
+        HE_QAT_ringPush(_buffer, _requests->request[i]);
         _requests->request[i] = NULL;
     }
-    _buffer->count += _requests->count;
     _requests->count = 0;
 
-    pthread_cond_signal(&_buffer->any_more_data);
-    pthread_mutex_unlock(&_buffer->mutex);
-
-    HE_QAT_PRINT_DBG(
-        "Unlocked submit request list. [internal buffer size: %d]\n",
-        _buffer->count);
+    HE_QAT_PRINT_DBG("Submitted request list. [internal buffer size: %u]\n",
+                     HE_QAT_ringSize(_buffer));
 }
 
 /// @brief Retrieve multiple requests from the outstanding buffer.
@@ -152,28 +185,14 @@ static void read_request_list(HE_QAT_TaskRequestList* _requests,
                               HE_QAT_RequestBuffer* _buffer,
                               unsigned int max_requests) {
     if (NULL == _requests) return;
-
-    pthread_mutex_lock(&_buffer->mutex);
+    if (max_requests > _requests->capacity) max_requests = _requests->capacity;
 
     // Wait while buffer is empty
-    while (_buffer->count <= 0)
-        pthread_cond_wait(&_buffer->any_more_data, &_buffer->mutex);
+    _requests->count =
+        HE_QAT_ringPop(_buffer, (void**)_requests->request, max_requests);
 
-    assert(_buffer->count > 0);
-    assert(_buffer->count <= HE_QAT_BUFFER_SIZE);
-
-    unsigned int count =
-        (_buffer->count < max_requests) ? _buffer->count : max_requests;
-
-    for (unsigned int i = 0; i < count; i++) {
-        _requests->request[i] = _buffer->data[_buffer->next_data_slot++];
-        _buffer->next_data_slot %= HE_QAT_BUFFER_SIZE;
-    }
-    _requests->count = count;
-    _buffer->count -= count;
-
-    pthread_cond_signal(&_buffer->any_free_slot);
-    pthread_mutex_unlock(&_buffer->mutex);
+    assert(_requests->count > 0);
+    assert(_requests->count <= _requests->capacity);
 
     return;
 }
@@ -191,12 +210,16 @@ static void read_request_list(HE_QAT_TaskRequestList* _requests,
 /// ready-to-be-scheduled state.
 /// @param[in] max_num_requests maximum number of requests to retrieve from
 /// outstanding buffer if available.
+/// @param[in] active Context state, the wait for an occupied buffer ends when
+/// it becomes HE_QAT_STATUS_INACTIVE.
 static void pull_outstanding_requests(
     HE_QAT_TaskRequestList* _requests,
     HE_QAT_OutstandingBuffer* _outstanding_buffer,
-    unsigned int max_num_requests) {
+    unsigned int max_num_requests, HE_QAT_STATUS* active) {
     if (NULL == _requests) return;
     _requests->count = 0;
+    if (max_num_requests > _requests->capacity)
+        max_num_requests = _requests->capacity;
 
     // For now, only one thread can change next_ready_buffer
     // so no need for synchronization objects
@@ -205,21 +228,25 @@ static void pull_outstanding_requests(
     // processing queue (internal buffer)
     pthread_mutex_lock(&_outstanding_buffer->mutex);
     // Wait until next outstanding buffer becomes available for use
-    while (outstanding.busy_count <= 0)
+    while (outstanding.busy_count <= 0) {
+        if (HE_QAT_STATUS_INACTIVE == *active) {
+            pthread_mutex_unlock(&_outstanding_buffer->mutex);
+            return;
+        }
         pthread_cond_wait(&_outstanding_buffer->any_ready_buffer,
                           &_outstanding_buffer->mutex);
+    }
 
     int any_ready = 0;
     unsigned int index = _outstanding_buffer->next_ready_buffer;  // no fairness
-    for (unsigned int i = 0; i < HE_QAT_BUFFER_COUNT; i++) {
+    for (unsigned int i = 0; i < _outstanding_buffer->count; i++) {
         index = i;  // ensure fairness
         if (_outstanding_buffer->ready_buffer[index] &&
-            _outstanding_buffer->buffer[index]
-                .count) {  // sync with mutex at interface
+            HE_QAT_ringSize(&_outstanding_buffer->buffer[index])) {
             any_ready = 1;
             break;
         }
-        // index = (index + 1) % HE_QAT_BUFFER_COUNT;
+        // index = (index + 1) % _outstanding_buffer->count;
     }
     // Ensures it gets picked once only
     pthread_mutex_unlock(&_outstanding_buffer->mutex);
@@ -229,36 +256,14 @@ static void pull_outstanding_requests(
     // Extract outstanding requests from outstanding buffer
     // (this is the only function that reads from outstanding buffer,
     // from a single thread)
-    pthread_mutex_lock(&_outstanding_buffer->buffer[index].mutex);
+    unsigned int num_requests =
+        HE_QAT_ringTryPop(&_outstanding_buffer->buffer[index],
+                          (void**)_requests->request, max_num_requests);
 
-    // This conditional waiting may not be required
-    // Wait while buffer is empty
-    while (_outstanding_buffer->buffer[index].count <= 0) {
-        pthread_cond_wait(&_outstanding_buffer->buffer[index].any_more_data,
-                          &_outstanding_buffer->buffer[index].mutex);
-    }
-    assert(_outstanding_buffer->buffer[index].count > 0);
+    assert(num_requests <= _requests->capacity);
 
-    unsigned int num_requests =
-        (_outstanding_buffer->buffer[index].count < max_num_requests)
-            ? _outstanding_buffer->buffer[index].count
-            : max_num_requests;
-
-    assert(num_requests <= HE_QAT_BUFFER_SIZE);
-
-    for (unsigned int i = 0; i < num_requests; i++) {
-        _requests->request[i] =
-            _outstanding_buffer->buffer[index]
-                .data[_outstanding_buffer->buffer[index].next_data_slot];
-        _outstanding_buffer->buffer[index].count--;
-        _outstanding_buffer->buffer[index].next_data_slot++;
-        _outstanding_buffer->buffer[index].next_data_slot %= HE_QAT_BUFFER_SIZE;
-    }
     _requests->count = num_requests;
 
-    pthread_cond_signal(&_outstanding_buffer->buffer[index].any_free_slot);
-    pthread_mutex_unlock(&_outstanding_buffer->buffer[index].mutex);
-
     // ---------------------------------------------------------------------------
     // Notify there is an outstanding buffer in ready for the processing queue
     //    pthread_mutex_lock(&_outstanding_buffer->mutex);
@@ -288,25 +293,83 @@ void* schedule_requests(void* context_state) {
     HE_QAT_STATUS* active = (HE_QAT_STATUS*)context_state;
 
     HE_QAT_TaskRequestList outstanding_requests;
-    for (unsigned int i = 0; i < HE_QAT_BUFFER_SIZE; i++) {
-        outstanding_requests.request[i] = NULL;
-    }
-    outstanding_requests.count = 0;
+    if (HE_QAT_STATUS_SUCCESS !=
+        init_request_list(&outstanding_requests, he_qat_buffer.capacity))
+        pthread_exit(NULL);
 
-    // This thread should receive signal from context to exit
-    *active = HE_QAT_STATUS_RUNNING;
+    // This thread should receive signal from context to exit. The context
+    // may have been released before the thread started.
+    __sync_bool_compare_and_swap(active, HE_QAT_STATUS_ACTIVE,
+                                 HE_QAT_STATUS_RUNNING);
     while (HE_QAT_STATUS_INACTIVE != *active) {
         // Collect a set of requests from the outstanding buffer
         pull_outstanding_requests(&outstanding_requests, &outstanding,
-                                  HE_QAT_BUFFER_SIZE);
+                                  outstanding_requests.capacity, active);
         // Submit them to the HE QAT buffer for offloading
         submit_request_list(&he_qat_buffer, &outstanding_requests);
     }
 
+    free_request_list(&outstanding_requests);
     pthread_exit(NULL);
 }
 
+/// @brief Poll an instance once and account for the delivered responses.
+/// @return Number of responses delivered.
+static unsigned long poll_instance(HE_QAT_InstConfig* config) {
+    unsigned long before = polled_responses;
+    icp_sal_CyPollInstance(config->inst_handle, 0);
+    unsigned long delivered = polled_responses - before;
+
+    config->polls++;
+    if (0 == delivered)
+        config->empty_polls++;
+    else
+        __atomic_add_fetch(&config->completed, delivered, __ATOMIC_SEQ_CST);
+
+    return delivered;
+}
+
+/// @brief Number of requests submitted to an instance and not yet polled.
+static unsigned long get_inflight(HE_QAT_InstConfig* config) {
+    return __atomic_load_n(&config->submitted, __ATOMIC_SEQ_CST) -
+           __atomic_load_n(&config->completed, __ATOMIC_SEQ_CST);
+}
+
+/// @brief Block until a request is submitted to an idle instance.
+/// @details Pairs with notify_submission(). The timeout only bounds the delay
+/// of a teardown.
+static void wait_for_work(HE_QAT_InstConfig* config) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += HE_QAT_POLL_EVENT_TIMEOUT_MILLISEC * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / HE_QAT_NANOSEC;
+    deadline.tv_nsec %= HE_QAT_NANOSEC;
+
+    pthread_mutex_lock(&config->mutex);
+    __atomic_store_n(&config->idle, 1, __ATOMIC_SEQ_CST);
+    while (config->polling && 0 == get_inflight(config)) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&config->work, &config->mutex,
+                                                &deadline))
+            break;
+    }
+    __atomic_store_n(&config->idle, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&config->mutex);
+}
+
+/// @brief Account for a request submitted to an instance and wake its
+/// polling thread if it is blocked in wait_for_work().
+static void notify_submission(HE_QAT_InstConfig* config) {
+    __atomic_add_fetch(&config->submitted, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&config->idle, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&config->mutex);
+        pthread_cond_signal(&config->work);
+        pthread_mutex_unlock(&config->mutex);
+    }
+}
+
 /// @brief Poll responses from a specific QAT instance.
+/// @details The waiting strategy between polls follows poll_config.policy,
+/// read once when the thread starts.
 /// @param[in] _inst_config Instance configuration containing the parameter
 /// values to start and poll responses from the accelerator.
 static void* start_inst_polling(void* _inst_config) {
@@ -322,17 +385,183 @@ static void* start_inst_polling(void* _inst_config) {
 
     HE_QAT_PRINT_DBG("Instance ID %d Polling\n", config->inst_id);
 
-    // What is harmful for polling without performing any operation?
+    HE_QAT_POLL_POLICY policy = poll_config.policy;
+
+    // Responses can be waited for on a file descriptor if the instance
+    // supports it (epoll mode), otherwise they are busy-polled
+    int fd = -1;
+    if (HE_QAT_POLL_EVENT == policy &&
+        CPA_STATUS_SUCCESS !=
+            icp_sal_CyGetFileDescriptor(config->inst_handle, &fd))
+        fd = -1;
+
+    unsigned int backoff = HE_QAT_POLL_MIN_BACKOFF_MICROSEC;
     config->polling = 1;
     while (config->polling) {
-        icp_sal_CyPollInstance(config->inst_handle, 0);
-        // OS_SLEEP(50);
-        HE_QAT_SLEEP(50, HE_QAT_MICROSEC);
+        if (HE_QAT_POLL_FIXED == policy) {
+            poll_instance(config);
+            HE_QAT_SLEEP(HE_QAT_POLL_INTERVAL_MICROSEC, HE_QAT_MICROSEC);
+            continue;
+        }
+
+        if (poll_instance(config) > 0) {
+            backoff = HE_QAT_POLL_MIN_BACKOFF_MICROSEC;
+            continue;
+        }
+
+        // Requests in flight: wait on the descriptor, or back off no longer
+        // than the fixed polling interval
+        unsigned int max_backoff = HE_QAT_POLL_INTERVAL_MICROSEC;
+        if (get_inflight(config) > 0) {
+            if (fd >= 0) {
+                struct pollfd pfd = {fd, POLLIN, 0};
+                poll(&pfd, 1, HE_QAT_POLL_EVENT_TIMEOUT_MILLISEC);
+                continue;
+            }
+        } else if (HE_QAT_POLL_EVENT == policy) {
+            config->idle_waits++;
+            wait_for_work(config);
+            backoff = HE_QAT_POLL_MIN_BACKOFF_MICROSEC;
+            continue;
+        } else {
+            config->idle_waits++;
+            max_backoff = HE_QAT_POLL_MAX_BACKOFF_MICROSEC;
+        }
+
+        HE_QAT_SLEEP(backoff, HE_QAT_MICROSEC);
+        backoff = (2 * backoff < max_backoff) ? 2 * backoff : max_backoff;
     }
 
+    if (fd >= 0) icp_sal_CyPutFileDescriptor(config->inst_handle, fd);
+
     pthread_exit(NULL);
 }
 
+/// @brief Current in-flight limit of the scheduler.
+/// @details HE_QAT_POLL_FIXED uses max_pending. The other policies start from
+/// it and, if poll_config.target_latency_us is set, adjust it every
+/// HE_QAT_LATENCY_WINDOW responses: additive increase while the mean latency
+/// of the window meets the target, multiplicative decrease otherwise.
+/// @param[in] step Additive increase, e.g. the number of instances.
+static unsigned long get_inflight_limit(unsigned long step) {
+    static unsigned long last_count = 0;
+    static unsigned long long last_latency_ns = 0;
+
+    if (HE_QAT_POLL_FIXED == poll_config.policy) return max_pending;
+    unsigned long target_us = poll_config.target_latency_us;
+    if (0 == target_us) return inflight_limit;
+
+    pthread_mutex_lock(&response_mutex);
+    unsigned long count = response_count;
+    unsigned long long latency_ns = response_latency_ns;
+    pthread_mutex_unlock(&response_mutex);
+
+    if (count < last_count) last_count = count;  // restarted context
+    if (count - last_count < HE_QAT_LATENCY_WINDOW) return inflight_limit;
+
+    unsigned long long mean_ns =
+        (latency_ns - last_latency_ns) / (count - last_count);
+    last_count = count;
+    last_latency_ns = latency_ns;
+
+    unsigned long limit = inflight_limit;
+    if (mean_ns > 1000ULL * target_us)
+        limit -= limit / 4;
+    else
+        limit += step;
+    if (limit < qat_limits.num_instances) limit = qat_limits.num_instances;
+    if (limit > qat_limits.buffer_size) limit = qat_limits.buffer_size;
+    inflight_limit = limit;
+
+    return limit;
+}
+
+/// @brief Wait for responses while the scheduler is throttled.
+/// @param[in] seen_responses Value of response_count when the wait started.
+/// @param[in,out] backoff Current back-off of HE_QAT_POLL_ADAPTIVE, in
+/// microseconds.
+/// @param[in] max_sleep_us Sleep of HE_QAT_POLL_FIXED and upper bound of
+/// backoff.
+static void wait_for_responses(unsigned long seen_responses,
+                               unsigned int* backoff,
+                               unsigned int max_sleep_us) {
+    throttle_waits++;
+
+    if (HE_QAT_POLL_EVENT == poll_config.policy) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)max_sleep_us * 1000L;
+        deadline.tv_sec += deadline.tv_nsec / HE_QAT_NANOSEC;
+        deadline.tv_nsec %= HE_QAT_NANOSEC;
+
+        pthread_mutex_lock(&response_mutex);
+        response_waiters++;
+        if (response_count == seen_responses)
+            pthread_cond_timedwait(&response_ready, &response_mutex,
+                                   &deadline);
+        response_waiters--;
+        pthread_mutex_unlock(&response_mutex);
+    } else if (HE_QAT_POLL_ADAPTIVE == poll_config.policy) {
+        HE_QAT_SLEEP(*backoff, HE_QAT_MICROSEC);
+        *backoff = (2 * *backoff < max_sleep_us) ? 2 * *backoff : max_sleep_us;
+    } else {
+        HE_QAT_SLEEP(max_sleep_us, HE_QAT_MICROSEC);
+    }
+}
+
+/// @brief Wait until the scheduler may submit at least a restart threshold of
+/// requests.
+/// @param[in] step Additive increase of the in-flight limit.
+/// @param[in] max_sleep_us Longest sleep between checks.
+/// @return Number of requests that can be submitted.
+static unsigned long wait_for_capacity(unsigned long step,
+                                       unsigned int max_sleep_us) {
+    unsigned int backoff = HE_QAT_POLL_INTERVAL_MICROSEC;
+    while (1) {
+        unsigned long limit = get_inflight_limit(step);
+        unsigned long threshold = (HE_QAT_POLL_FIXED == poll_config.policy)
+                                      ? restart_threshold
+                                      : (limit + 1) / 2;
+        unsigned long seen_responses = response_count;
+        unsigned long pending = request_count - seen_responses;
+        unsigned long available =
+            limit - ((pending < limit) ? pending : limit);
+
+        HE_QAT_PRINT_DBG(
+            "[CHECK] request_count: %lu response_count: %lu pending: %lu "
+            "available: %lu\n",
+            request_count, seen_responses, pending, available);
+
+        if (available >= threshold) return available;
+
+        HE_QAT_PRINT_DBG("[WAIT]\n");
+        wait_for_responses(seen_responses, &backoff, max_sleep_us);
+    }
+}
+
+/// @brief Select the instance to offload a request to.
+/// @details Prefers the first instance, in round-robin order, that is on the
+/// NUMA node of the thread that submitted the request and has fewer than
+/// HE_QAT_LOCAL_INFLIGHT requests in flight. Requests spill over to the
+/// round-robin instance when every local instance is that busy, so the
+/// devices of other nodes still help with a single-node workload.
+/// @param[in] config Configuration of the instances.
+/// @param[in] request Request to offload.
+/// @param[in] next Next instance in round-robin order.
+/// @return Index of the selected instance.
+static unsigned int route_request(HE_QAT_Config* config,
+                                  HE_QAT_TaskRequest* request,
+                                  unsigned int next) {
+    for (unsigned int k = 0; k < config->count; k++) {
+        unsigned int i = (next + k) % config->count;
+        HE_QAT_InstConfig* inst = &config->inst_config[i];
+        if ((int)inst->node == request->node &&
+            get_inflight(inst) < HE_QAT_LOCAL_INFLIGHT)
+            return i;
+    }
+    return next;
+}
+
 /// @brief
 /// Initialize and start multiple instances, their polling thread,
 /// and a single processing thread.
@@ -367,6 +596,8 @@ void* start_instances(void* _config) {
 
     HE_QAT_Config* config = (HE_QAT_Config*)_config;
     instance_count = config->count;
+    restart_threshold = NUM_PKE_SLICES * instance_count;
+    max_pending = 2 * NUM_PKE_SLICES * instance_count;
 
     HE_QAT_PRINT_DBG("Instance Count: %d\n", instance_count);
     pthread_t* polling_thread =
@@ -433,43 +664,20 @@ void* start_instances(void* _config) {
     }  // for loop
 
     HE_QAT_TaskRequestList outstanding_requests;
-    for (unsigned int i = 0; i < HE_QAT_BUFFER_SIZE; i++) {
-        outstanding_requests.request[i] = NULL;
-    }
-    outstanding_requests.count = 0;
+    if (HE_QAT_STATUS_SUCCESS !=
+        init_request_list(&outstanding_requests, he_qat_buffer.capacity))
+        pthread_exit(NULL);
 
-    config->running = 1;
+    // config->running was set by acquire_qat_devices(), so a release that
+    // comes before this point is not overridden
     config->active = 1;
     while (config->running) {
         HE_QAT_PRINT_DBG("Try reading request from buffer. Inst #%d\n",
                          next_instance);
 
-        unsigned long pending = request_count - response_count;
         unsigned long available =
-            max_pending - ((pending < max_pending) ? pending : max_pending);
-
-        HE_QAT_PRINT_DBG(
-            "[CHECK] request_count: %lu response_count: %lu pending: %lu "
-            "available: %lu\n",
-            request_count, response_count, pending, available);
-
-        while (available < restart_threshold) {
-            HE_QAT_PRINT_DBG("[WAIT]\n");
-
-            // argument passed in microseconds
-            HE_QAT_SLEEP(RESTART_LATENCY_MICROSEC, HE_QAT_MICROSEC);
-            pending = request_count - response_count;
-            available =
-                max_pending - ((pending < max_pending) ? pending : max_pending);
-            HE_QAT_PRINT_DBG(
-                "[CHECK] request_count: %lu response_count: %lu pending: %lu "
-                "available: %lu\n",
-                request_count, response_count, pending, available);
-        }
-        HE_QAT_PRINT_DBG(
-            "[SUBMIT] request_count: %lu response_count: %lu pending: %lu "
-            "available: %lu\n",
-            request_count, response_count, pending, available);
+            wait_for_capacity(instance_count, RESTART_LATENCY_MICROSEC);
+        HE_QAT_PRINT_DBG("[SUBMIT] available: %lu\n", available);
 
         unsigned int max_requests = available;
 
@@ -482,10 +690,14 @@ void* start_instances(void* _config) {
 
         for (unsigned int i = 0; i < outstanding_requests.count; i++) {
             HE_QAT_TaskRequest* request = outstanding_requests.request[i];
+            // Wake-up from release_qat_devices()
+            if (NULL == request) continue;
 #ifdef HE_QAT_SYNC_MODE
             COMPLETION_INIT(&request->callback);
 #endif
 
+            next_instance = route_request(config, request, next_instance);
+
             unsigned retry = 0;
             do {
                 // Realize the type of operation from data
@@ -497,6 +709,7 @@ void* start_instances(void* _config) {
 #ifdef HE_QAT_PERF
                     gettimeofday(&request->start, NULL);
 #endif
+                    request->submit_ns = HE_QAT_getTimeNs();
                     status = cpaCyLnModExp(
                         config->inst_config[next_instance].inst_handle,
                         (CpaCyGenFlatBufCbFunc)
@@ -516,7 +729,17 @@ void* start_instances(void* _config) {
                 if (CPA_STATUS_RETRY == status) {
                     HE_QAT_PRINT_DBG("CPA requested RETRY\n");
                     HE_QAT_PRINT_DBG("RETRY count = %u\n", retry);
-                    pthread_exit(NULL);  // halt the whole system
+                    if (HE_QAT_POLL_FIXED == poll_config.policy)
+                        pthread_exit(NULL);  // halt the whole system
+                    // The ring of the instance is full: shrink the in-flight
+                    // limit and try the next instance once it has drained
+                    unsigned long limit = inflight_limit / 2;
+                    inflight_limit = (limit < instance_count) ? instance_count
+                                                              : limit;
+                    unsigned int backoff = HE_QAT_POLL_MIN_BACKOFF_MICROSEC;
+                    wait_for_responses(response_count, &backoff,
+                                       RESTART_LATENCY_MICROSEC);
+                    next_instance = (next_instance + 1) % instance_count;
                 }
             } while (CPA_STATUS_RETRY == status && retry < HE_QAT_MAX_RETRY);
 
@@ -526,6 +749,7 @@ void* start_instances(void* _config) {
                 // Global tracking of number of requests
                 request_count += 1;
                 request_count_per_instance[next_instance] += 1;
+                notify_submission(&config->inst_config[next_instance]);
                 next_instance = (next_instance + 1) % instance_count;
 
                 // Wake up any blocked call to stop_perform_op, signaling that
@@ -549,6 +773,9 @@ void* start_instances(void* _config) {
                 request->op_status = CPA_STATUS_FAIL;
                 request->request_status = HE_QAT_STATUS_FAIL;  // Review it
                 HE_QAT_PRINT_ERR("Request Submission FAILED\n");
+                // No callback will report it
+                if (NULL != request->completion_queue)
+                    HE_QAT_completeAsyncRequest(request, HE_QAT_STATUS_FAIL);
             }
 
             HE_QAT_PRINT_DBG("Offloading completed by instance #%d\n",
@@ -560,6 +787,10 @@ void* start_instances(void* _config) {
         }  // for loop over batch of requests
         outstanding_requests.count = 0;
     }
+
+    free_request_list(&outstanding_requests);
+    free(request_count_per_instance);
+    free(polling_thread);
     pthread_exit(NULL);
 }
 
@@ -622,10 +853,9 @@ void* start_perform_op(void* _inst_config) {
     }
 
     HE_QAT_TaskRequestList outstanding_requests;
-    for (unsigned int i = 0; i < HE_QAT_BUFFER_SIZE; i++) {
-        outstanding_requests.request[i] = NULL;
-    }
-    outstanding_requests.count = 0;
+    if (HE_QAT_STATUS_SUCCESS !=
+        init_request_list(&outstanding_requests, he_qat_buffer.capacity))
+        pthread_exit(NULL);
 
     config->running = 1;
     config->active = 1;
@@ -633,28 +863,8 @@ void* start_perform_op(void* _inst_config) {
         HE_QAT_PRINT_DBG("Try reading request from buffer. Inst #%d\n",
                          config->inst_id);
 
-        unsigned long pending = request_count - response_count;
-        unsigned long available =
-            max_pending - ((pending < max_pending) ? pending : max_pending);
-
-        HE_QAT_PRINT_DBG(
-            "[CHECK] request_count: %lu response_count: %lu pending: %lu "
-            "available: %lu\n",
-            request_count, response_count, pending, available);
-
-        while (available < restart_threshold) {
-            HE_QAT_PRINT_DBG("[WAIT]\n");
-
-            HE_QAT_SLEEP(650, HE_QAT_MICROSEC);
-
-            pending = request_count - response_count;
-            available =
-                max_pending - ((pending < max_pending) ? pending : max_pending);
-        }
-        HE_QAT_PRINT_DBG(
-            "[SUBMIT] request_count: %lu response_count: %lu pending: %lu "
-            "available: %lu\n",
-            request_count, response_count, pending, available);
+        unsigned long available = wait_for_capacity(1, 650);
+        HE_QAT_PRINT_DBG("[SUBMIT] available: %lu\n", available);
 
         unsigned int max_requests = available;
 
@@ -691,6 +901,7 @@ void* start_perform_op(void* _inst_config) {
 #ifdef HE_QAT_PERF
                     gettimeofday(&request->start, NULL);
 #endif
+                    request->submit_ns = HE_QAT_getTimeNs();
                     status = cpaCyLnModExp(
                         config->inst_handle,
                         (CpaCyGenFlatBufCbFunc)
@@ -719,6 +930,7 @@ void* start_perform_op(void* _inst_config) {
             if (CPA_STATUS_SUCCESS == status) {
                 // Global tracking of number of requests
                 request_count += 1;
+                notify_submission(config);
 
                 HE_QAT_PRINT_DBG("request_count = %lu\n", request_count);
 #ifdef HE_QAT_SYNC_MODE
@@ -752,6 +964,8 @@ void* start_perform_op(void* _inst_config) {
         HE_QAT_PRINT_DBG("Offloading completed by instance #%d\n",
                          config->inst_id);
     }
+
+    free_request_list(&outstanding_requests);
     pthread_exit(NULL);
 }
 
@@ -785,6 +999,7 @@ void stop_perform_op(HE_QAT_InstConfig* config, unsigned num_inst) {
 
             config[i].polling = 0;
             config[i].running = 0;
+            pthread_cond_broadcast(&config[i].work);
 
             HE_QAT_SLEEP(10, HE_QAT_MICROSEC);
 
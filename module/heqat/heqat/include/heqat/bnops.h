@@ -50,10 +50,10 @@ extern "C" {
 ///
 /// @details
 /// Perform big number modular exponentiation operation accelerated with QAT for
-/// input data using OpenSSL BIGNUM data structure. Create QAT contiguous memory
-/// space. Copy BIGNUM binary data and package it into a request (HE_QAT_Request
-/// data structure) and call producer function to submit request to the internal
-/// buffer.
+/// input data using OpenSSL BIGNUM data structure. Take a preallocated request
+/// (HE_QAT_Request data structure) with QAT contiguous memory, copy BIGNUM
+/// binary data into it and call producer function to submit request to the
+/// internal buffer.
 ///
 /// @param[out] r Remainder number of the modular exponentiation operation.
 /// @param[in] b Base number of the modular exponentiation operation.
@@ -68,8 +68,8 @@ HE_QAT_STATUS HE_QAT_BIGNUMModExp(BIGNUM* r, BIGNUM* b, BIGNUM* e, BIGNUM* m,
 ///
 /// @details
 /// Perform big number modular exponentiation operation accelerated with QAT for
-/// input data as an octet string of unsigned chars. Create QAT contiguous
-/// memory space. Upon call it copies input data and package it into a request,
+/// input data as an octet string of unsigned chars. Take a preallocated
+/// request with QAT contiguous memory. Upon call it copies input data into it,
 /// then calls producer function to submit request to internal buffer.
 ///
 /// @param[out] r Remainder number of the modular exponentiation operation.
@@ -107,8 +107,8 @@ void getBnModExpRequest(unsigned int num_requests);
 ///
 /// @details
 /// Perform big number modular exponentiation operation accelerated with QAT for
-/// input data as an octet string of unsigned chars. Create QAT contiguous
-/// memory space. Upon call it copies input data and package it into a request,
+/// input data as an octet string of unsigned chars. Take a preallocated
+/// request with QAT contiguous memory. Upon call it copies input data into it,
 /// then calls producer function to submit request to internal buffer.
 ///
 /// @param[in] _buffer_id Buffer ID of the reserved buffer for the caller's
@@ -122,6 +122,36 @@ HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
                                  unsigned char* b, unsigned char* e,
                                  unsigned char* m, int nbits);
 
+/// @brief Reserve a modular exponentiation request whose operands the caller
+/// writes directly into QAT contiguous memory.
+///
+/// @details
+/// Same as HE_QAT_bnModExp_MT(.) without the copy of the input data. Write
+/// base, exponent and modulus (nbits/8 bytes each, big-endian) to the memory
+/// returned in ops, then call HE_QAT_bnModExpSubmit_MT(.) with the same ops.
+///
+/// @param[in] _buffer_id Buffer ID of the reserved buffer for the caller's
+/// thread.
+/// @param[in] nbits Number of bits (bit precision) of input/output big numbers.
+/// @param[out] ops Operand memory of the reserved request.
+HE_QAT_STATUS HE_QAT_bnModExpReserve_MT(unsigned int _buffer_id, int nbits,
+                                        HE_QAT_BnModExpOperands* ops);
+
+/// @brief Submit a request reserved with HE_QAT_bnModExpReserve_MT(.).
+///
+/// @details If r is ops->result, the device writes the remainder in place
+/// and no copy is made. When ops->result is the request's own memory, read
+/// it after wait_bnModExp_buffer(.) and before release_bnModExp_buffer(.),
+/// which recycles the request.
+///
+/// @param[in] _buffer_id Buffer ID passed to HE_QAT_bnModExpReserve_MT(.).
+/// @param[out] r Remainder number of the modular exponentiation operation.
+/// @param[in,out] ops Operands filled by the caller; the request is handed
+/// over and ops must not be submitted again.
+HE_QAT_STATUS HE_QAT_bnModExpSubmit_MT(unsigned int _buffer_id,
+                                       unsigned char* r,
+                                       HE_QAT_BnModExpOperands* ops);
+
 /// @brief Reserve/acquire buffer for multithreading support.
 ///
 /// @details Try to acquire an available buffer to store outstanding work
@@ -134,6 +164,17 @@ HE_QAT_STATUS HE_QAT_bnModExp_MT(unsigned int _buffer_id, unsigned char* r,
 /// buffer ID of the buffer used to store caller's outstanding requests.
 HE_QAT_STATUS acquire_bnModExp_buffer(unsigned int* _buffer_id);
 
+/// @brief Wait for request processing to complete without releasing the
+/// buffer.
+///
+/// @details Results left in QAT memory (see HE_QAT_bnModExpSubmit_MT(.))
+/// can be read until release_bnModExp_buffer(.) is called with the same
+/// batch size.
+///
+/// @param[in] _buffer_id Buffer ID of the caller's buffer.
+/// @param[in] _batch_size Total number of requests to wait for completion.
+void wait_bnModExp_buffer(unsigned int _buffer_id, unsigned int _batch_size);
+
 /// @brief Wait for request processing to complete and release previously
 /// acquired buffer.
 ///
@@ -147,6 +188,118 @@ HE_QAT_STATUS acquire_bnModExp_buffer(unsigned int* _buffer_id);
 /// requests to wait for completion before releasing the buffer.
 void release_bnModExp_buffer(unsigned int _buffer_id, unsigned int _batch_size);
 
+/// @brief Create a completion queue for the asynchronous interface.
+///
+/// @details Requests submitted to a completion queue are not tied to a
+/// buffer or a batch: each submission returns a ticket and completed
+/// requests are harvested in completion order with poll_completion_queue(.)
+/// or wait_completion_queue(.). The queue holds as many requests as the
+/// buffer size of the acquired devices, see get_qat_limits(.). A queue must
+/// be used by one thread at a time and destroyed before
+/// release_qat_devices().
+///
+/// @param[out] _cq New completion queue.
+HE_QAT_STATUS create_completion_queue(HE_QAT_CompletionQueue** _cq);
+
+/// @brief Destroy a completion queue and recycle its last harvest.
+///
+/// @param[in] cq Completion queue with no requests outstanding.
+/// @retval HE_QAT_STATUS_FAIL Requests were reserved or submitted and not
+/// harvested; the queue is left untouched.
+HE_QAT_STATUS destroy_completion_queue(HE_QAT_CompletionQueue* cq);
+
+/// @brief Reserve an asynchronous modular exponentiation request whose
+/// operands the caller writes directly into QAT contiguous memory.
+///
+/// @details Same as HE_QAT_bnModExpReserve_MT(.) for a completion queue.
+/// A queue can have at most HE_QAT_Limits::buffer_size requests reserved
+/// and not yet harvested.
+///
+/// @param[in] cq Completion queue the request will complete to.
+/// @param[in] nbits Number of bits (bit precision) of input/output big numbers.
+/// @param[out] ops Operand memory of the reserved request.
+/// @retval HE_QAT_STATUS_BUSY The queue is full; harvest completions first.
+HE_QAT_STATUS HE_QAT_bnModExpReserve_Async(HE_QAT_CompletionQueue* cq,
+                                           int nbits,
+                                           HE_QAT_BnModExpOperands* ops);
+
+/// @brief Submit a request reserved with HE_QAT_bnModExpReserve_Async(.).
+///
+/// @details Returns as soon as the request is queued. If r is NULL the
+/// remainder is left in ops->result, see HE_QAT_Completion.
+///
+/// @param[in] cq Completion queue passed to HE_QAT_bnModExpReserve_Async(.).
+/// @param[out] r Remainder number of the modular exponentiation operation, or
+/// NULL.
+/// @param[in,out] ops Operands filled by the caller; the request is handed
+/// over and ops must not be submitted again.
+/// @param[in] user_data Caller data returned with the completion.
+/// @param[out] ticket Ticket of the request in cq, may be NULL.
+HE_QAT_STATUS HE_QAT_bnModExpSubmit_Async(HE_QAT_CompletionQueue* cq,
+                                          unsigned char* r,
+                                          HE_QAT_BnModExpOperands* ops,
+                                          void* user_data,
+                                          HE_QAT_Ticket* ticket);
+
+/// @brief Give back a request reserved with HE_QAT_bnModExpReserve_Async(.)
+/// without submitting it, e.g. when preparing its operands failed.
+///
+/// @param[in] cq Completion queue passed to HE_QAT_bnModExpReserve_Async(.).
+/// @param[in,out] ops Operands of the reserved request; the request is
+/// recycled and ops must not be submitted.
+HE_QAT_STATUS HE_QAT_bnModExpCancel_Async(HE_QAT_CompletionQueue* cq,
+                                          HE_QAT_BnModExpOperands* ops);
+
+/// @brief Submit an asynchronous modular exponentiation r = b^e mod m.
+///
+/// @details Copies the operands into a request reserved with
+/// HE_QAT_bnModExpReserve_Async(.) and submits it.
+///
+/// @param[in] cq Completion queue the request will complete to.
+/// @param[out] r Remainder number of the modular exponentiation operation, or
+/// NULL to read it from the completion.
+/// @param[in] b Base number of the modular exponentiation operation.
+/// @param[in] e Exponent number of the modular exponentiation operation.
+/// @param[in] m Modulus number of the modular exponentiation operation.
+/// @param[in] nbits Number of bits (bit precision) of input/output big numbers.
+/// @param[in] user_data Caller data returned with the completion.
+/// @param[out] ticket Ticket of the request in cq, may be NULL.
+HE_QAT_STATUS HE_QAT_bnModExp_Async(HE_QAT_CompletionQueue* cq,
+                                    unsigned char* r, unsigned char* b,
+                                    unsigned char* e, unsigned char* m,
+                                    int nbits, void* user_data,
+                                    HE_QAT_Ticket* ticket);
+
+/// @brief Harvest completed requests without blocking.
+///
+/// @details Completions come in completion order, not submission order.
+/// Each harvest recycles the requests of the previous one, so results left
+/// in QAT memory must be read before harvesting again.
+///
+/// @param[in] cq Completion queue.
+/// @param[out] completions Room for max_completions completions.
+/// @param[in] max_completions Maximum number of completions to return.
+/// @return Number of completions returned.
+unsigned int poll_completion_queue(HE_QAT_CompletionQueue* cq,
+                                   HE_QAT_Completion* completions,
+                                   unsigned int max_completions);
+
+/// @brief Harvest completed requests, waiting for at least min_completions.
+///
+/// @details Same as poll_completion_queue(.), but blocks until
+/// min_completions requests have completed (fewer if fewer are outstanding).
+/// Every reserved request must have been submitted.
+///
+/// @param[in] cq Completion queue.
+/// @param[out] completions Room for max_completions completions.
+/// @param[in] min_completions Number of completions to wait for.
+/// @param[in] max_completions Maximum number of completions to return.
+/// @return Number of completions returned.
+unsigned int wait_completion_queue(HE_QAT_CompletionQueue* cq,
+                                   HE_QAT_Completion* completions,
+                                   unsigned int min_completions,
+                                   unsigned int max_completions);
+
 #ifdef __cplusplus
 }  // extern "C" {
 #endif
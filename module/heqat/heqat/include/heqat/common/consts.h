@@ -7,12 +7,25 @@
 #ifndef _HE_QAT_CONST_H_
 #define _HE_QAT_CONST_H_
 
-// Local Constants
+// Default limits of acquire_qat_devices(), see HE_QAT_Limits
 #define HE_QAT_NUM_ACTIVE_INSTANCES 8
 #define HE_QAT_BUFFER_SIZE 1024
 #define HE_QAT_BUFFER_COUNT HE_QAT_NUM_ACTIVE_INSTANCES
+#define HE_QAT_MAX_BUFFER_SIZE (1 << 20)
+
+// Local Constants
 #define HE_QAT_MAX_RETRY 100
 #define RESTART_LATENCY_MICROSEC 600
 #define NUM_PKE_SLICES 6
+#define HE_QAT_CACHE_LINE_SIZE 64
+#define HE_QAT_MIN_SPIN_COUNT 16
+#define HE_QAT_MAX_SPIN_COUNT 4096
+#define HE_QAT_POLL_INTERVAL_MICROSEC 50
+#define HE_QAT_POLL_MIN_BACKOFF_MICROSEC 2
+#define HE_QAT_POLL_MAX_BACKOFF_MICROSEC 200
+#define HE_QAT_POLL_EVENT_TIMEOUT_MILLISEC 10
+#define HE_QAT_LATENCY_WINDOW 64
+#define HE_QAT_MAX_NUMA_NODES 8
+#define HE_QAT_LOCAL_INFLIGHT (2 * NUM_PKE_SLICES)
 
 #endif  // _HE_QAT_CONST_H_
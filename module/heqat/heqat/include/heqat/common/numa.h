@@ -0,0 +1,39 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/numa.h
+
+#pragma once
+
+#ifndef MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_NUMA_H_
+#define MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_NUMA_H_
+
+#ifdef _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief NUMA node of a CPU, read from sysfs on first use.
+/// @param[in] cpu CPU number.
+/// @return Node of the CPU, 0 if the topology is unknown.
+int HE_QAT_getCpuNode(int cpu);
+
+/// @brief NUMA node of the CPU the calling thread is running on.
+/// @return Node of the calling thread, 0 if the topology is unknown.
+int HE_QAT_getNumaNode();
+
+#ifdef _GNU_SOURCE
+/// @brief CPUs of a NUMA node.
+/// @param[in] node NUMA node, as in CpaInstanceInfo2::nodeAffinity.
+/// @param[out] cpus CPUs of the node.
+/// @return Number of CPUs of the node, 0 if the node is unknown.
+int HE_QAT_getNodeCpus(int node, cpu_set_t* cpus);
+#endif
+
+#ifdef __cplusplus
+}  // extern "C" {
+#endif
+
+#endif  // MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_NUMA_H_
@@ -0,0 +1,64 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/ring.h
+
+#pragma once
+
+#ifndef MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_RING_H_
+#define MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_RING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "heqat/common/types.h"
+
+/// @brief Allocate an empty ring.
+/// @param[out] _ring Buffer to initialize.
+/// @param[in] capacity Number of slots, rounded up to a power of 2 and at
+/// most HE_QAT_MAX_BUFFER_SIZE.
+HE_QAT_STATUS HE_QAT_ringInit(HE_QAT_RequestBuffer* _ring,
+                              unsigned int capacity);
+
+/// @brief Free a ring allocated with HE_QAT_ringInit(). No thread may be
+/// operating on or waiting for it.
+/// @param[in,out] _ring Buffer to destroy.
+void HE_QAT_ringDestroy(HE_QAT_RequestBuffer* _ring);
+
+/// @brief Enqueue a request without blocking.
+/// @param[in,out] _ring Buffer to add the request to.
+/// @param[in] item Request.
+/// @retval 1 The request was enqueued.
+/// @retval 0 The ring is full.
+int HE_QAT_ringTryPush(HE_QAT_RequestBuffer* _ring, void* item);
+
+/// @brief Enqueue a request, waiting for a free slot if the ring is full.
+/// @param[in,out] _ring Buffer to add the request to.
+/// @param[in] item Request.
+void HE_QAT_ringPush(HE_QAT_RequestBuffer* _ring, void* item);
+
+/// @brief Dequeue up to max_items requests without blocking.
+/// @param[in,out] _ring Buffer to take the requests from.
+/// @param[out] items Dequeued requests, in enqueue order.
+/// @param[in] max_items Maximum number of requests to dequeue.
+/// @return Number of requests dequeued.
+unsigned int HE_QAT_ringTryPop(HE_QAT_RequestBuffer* _ring, void** items,
+                               unsigned int max_items);
+
+/// @brief Dequeue up to max_items requests, waiting for at least one.
+/// @param[in,out] _ring Buffer to take the requests from.
+/// @param[out] items Dequeued requests, in enqueue order.
+/// @param[in] max_items Maximum number of requests to dequeue (at least 1).
+/// @return Number of requests dequeued.
+unsigned int HE_QAT_ringPop(HE_QAT_RequestBuffer* _ring, void** items,
+                            unsigned int max_items);
+
+/// @brief Number of requests waiting in the ring. The value is exact only
+/// while no other thread operates on the ring.
+unsigned int HE_QAT_ringSize(HE_QAT_RequestBuffer* _ring);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_RING_H_
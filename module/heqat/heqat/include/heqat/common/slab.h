@@ -0,0 +1,47 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+/// @file heqat/common/slab.h
+
+#pragma once
+
+#ifndef MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_SLAB_H_
+#define MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_SLAB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "heqat/common/types.h"
+
+/// @brief Allocate the request descriptors of a slab and put them all on its
+/// free list. Contiguous memory is attached to a request on its first use.
+/// @param[out] _slab Slab to initialize.
+/// @retval HE_QAT_STATUS_SUCCESS Slab is ready for use.
+/// @retval HE_QAT_STATUS_FAIL Failed to allocate the request descriptors.
+HE_QAT_STATUS HE_QAT_slabInit(HE_QAT_RequestSlab* _slab,
+                              unsigned int capacity);
+
+/// @brief Free the request descriptors of a slab and their contiguous memory.
+/// All requests must have been returned with HE_QAT_slabRelease().
+/// @param[in,out] _slab Slab to tear down.
+void HE_QAT_slabDestroy(HE_QAT_RequestSlab* _slab);
+
+/// @brief Take a modular exponentiation request from the slab.
+/// @details The request's op_data and op_result point to len bytes each in
+/// the request's contiguous memory. Falls back to a one-off allocation when
+/// the slab is exhausted or was not initialized. The request is tagged with
+/// the NUMA node of the calling thread, where its memory is first allocated.
+/// @param[in,out] _slab Slab to take the request from.
+/// @param[in] len Size in bytes of each operand and of the result.
+/// @return Request ready to be filled, or NULL if memory allocation failed.
+HE_QAT_TaskRequest* HE_QAT_slabAcquire(HE_QAT_RequestSlab* _slab, int len);
+
+/// @brief Return a request taken with HE_QAT_slabAcquire().
+/// @param[in] request Request whose processing has completed.
+void HE_QAT_slabRelease(HE_QAT_TaskRequest* request);
+
+#ifdef __cplusplus
+}  // close the extern "C" {
+#endif
+
+#endif  // MODULE_HEQAT_HEQAT_INCLUDE_HEQAT_COMMON_SLAB_H_
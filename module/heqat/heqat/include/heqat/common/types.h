@@ -39,7 +39,8 @@ typedef enum {
     HE_QAT_STATUS_READY = 1,
     HE_QAT_STATUS_SUCCESS = 0,
     HE_QAT_STATUS_FAIL = -1,
-    HE_QAT_STATUS_INACTIVE = -2
+    HE_QAT_STATUS_INACTIVE = -2,
+    HE_QAT_STATUS_BUSY = -3
 } HE_QAT_STATUS;
 
 typedef enum {
@@ -54,27 +55,93 @@ typedef enum {
     HE_QAT_SEC = 1
 } HE_QAT_TIME_UNIT;
 
+/// @brief How polling threads wait for responses and how the scheduler waits
+/// for the in-flight limit.
+typedef enum {
+    HE_QAT_POLL_FIXED = 0,  ///< Poll every HE_QAT_POLL_INTERVAL_MICROSEC and
+                            ///< sleep RESTART_LATENCY_MICROSEC when throttled.
+    HE_QAT_POLL_ADAPTIVE = 1,  ///< Poll with an exponential back-off, up to
+                               ///< HE_QAT_POLL_INTERVAL_MICROSEC while
+                               ///< requests are in flight and up to
+                               ///< HE_QAT_POLL_MAX_BACKOFF_MICROSEC when idle.
+    HE_QAT_POLL_EVENT = 2  ///< Default. Block while the instance is idle,
+                           ///< wait on its response file descriptor (or back
+                           ///< off as HE_QAT_POLL_ADAPTIVE if it has none)
+                           ///< while requests are in flight, and wake the
+                           ///< throttled scheduler on responses.
+} HE_QAT_POLL_POLICY;
+
+/// @brief Polling configuration, see set_qat_poll_config().
+typedef struct {
+    HE_QAT_POLL_POLICY policy;       ///< Polling and throttling policy.
+    unsigned int target_latency_us;  ///< Mean response latency the in-flight
+                                     ///< limit is tuned for; 0 keeps the
+                                     ///< limit fixed.
+} HE_QAT_PollConfig;
+
+/// @brief Polling and throttling counters, see get_qat_poll_stats().
+typedef struct {
+    unsigned long polls;        ///< Calls to icp_sal_CyPollInstance().
+    unsigned long empty_polls;  ///< Polls that delivered no response.
+    unsigned long idle_waits;  ///< Sleeps or blocking waits of polling threads
+                               ///< with no request in flight.
+    unsigned long throttle_waits;  ///< Waits of the scheduler on the
+                                   ///< in-flight limit.
+    unsigned long responses;       ///< Responses delivered to callbacks.
+    double avg_latency_us;  ///< Mean time from submission to callback.
+    unsigned long inflight_limit;  ///< Current in-flight limit.
+} HE_QAT_PollStats;
+
+/// @brief Capacity limits of the runtime environment, see
+/// acquire_qat_devices_with_limits(). Fields set to 0 select the defaults
+/// noted below.
+typedef struct {
+    unsigned int num_instances;  ///< QAT instances to use; 0 for every
+                                 ///< instance found.
+    unsigned int buffer_size;  ///< Capacity of each request buffer and
+                               ///< completion queue, rounded up to a power
+                               ///< of 2; 0 for HE_QAT_BUFFER_SIZE.
+    unsigned int buffer_count;  ///< Outstanding buffers, i.e. threads using
+                                ///< the multithreading interface at once; 0
+                                ///< for HE_QAT_BUFFER_COUNT.
+} HE_QAT_Limits;
+
 typedef pthread_t HE_QAT_Inst;
 
+#define HE_QAT_CACHE_ALIGNED __attribute__((aligned(HE_QAT_CACHE_LINE_SIZE)))
+
+/// @brief Bounded lock-free multi-producer/multi-consumer ring of requests.
+/// @details Slot i of data[] is published to consumers when seq[i] reaches
+/// its enqueue position plus one, and handed back to producers when seq[i]
+/// reaches that position plus the capacity. Consumed entries remain in
+/// data[] so that callers can wait on them in submission order. Threads that
+/// find the ring full or empty spin for up to spin_limit iterations and then
+/// park on the condition variables. See heqat/common/ring.h.
 typedef struct {
-    void* data[HE_QAT_BUFFER_SIZE];  ///< Stores work requests ready to be sent
-                                     ///< to the accelerator.
-    volatile unsigned int count;     ///< Tracks the number of occupied
-                                     ///< entries/slots in the data[] buffer.
-    // nextin index of the next free slot for a request
-    unsigned int next_free_slot;  ///< Index of the next slot available to store
-                                  ///< a new request.
-    // nextout index of next request to be processed
-    unsigned int next_data_slot;  ///< Index of the next slot containing request
-                                  ///< ready to be consumed for processing.
+    void** data;  ///< Stores work requests ready to be sent to the
+                  ///< accelerator.
+    unsigned long* seq;     ///< Sequence number of each slot.
+    unsigned long capacity;  ///< Number of slots, a power of 2.
+    // nextin position of the next free slot for a request
+    HE_QAT_CACHE_ALIGNED unsigned long
+        next_free_slot;  ///< Enqueue position, the slot index is the position
+                         ///< modulo the capacity.
+    // nextout position of next request to be processed
+    HE_QAT_CACHE_ALIGNED unsigned long
+        next_data_slot;  ///< Dequeue position, the slot index is the position
+                         ///< modulo the capacity.
     // index of next output data to be read by a thread waiting
     // for all the request to complete processing
-    unsigned int
+    HE_QAT_CACHE_ALIGNED unsigned int
         next_data_out;      ///< Index of the next slot containing request whose
                             ///< processing has been completed and its output is
                             ///< ready to be consumed by the caller.
-    pthread_mutex_t mutex;  ///< Synchronization object used to control access
-                            ///< to the buffer.
+    unsigned int spin_limit;  ///< Adaptive number of spin iterations before
+                              ///< a waiting thread parks.
+    int data_waiters;       ///< Threads parked on any_more_data.
+    int slot_waiters;       ///< Threads parked on any_free_slot.
+    pthread_mutex_t mutex;  ///< Synchronization object used to park threads
+                            ///< waiting on the buffer.
     pthread_cond_t
         any_more_data;  ///< Conditional variable used to synchronize the
                         ///< consumption of data in buffer (wait until more data
@@ -86,28 +153,26 @@ typedef struct {
 } HE_QAT_RequestBuffer;
 
 typedef struct {
-    HE_QAT_RequestBuffer
-        buffer[HE_QAT_BUFFER_COUNT];  ///< Buffers to support concurrent threads
-                                      ///< with less sync overhead. Stores
-                                      ///< incoming request from different
-                                      ///< threads.
+    HE_QAT_RequestBuffer* buffer;  ///< Buffers to support concurrent threads
+                                   ///< with less sync overhead. Stores
+                                   ///< incoming request from different
+                                   ///< threads.
+    unsigned int count;  ///< Number of buffers.
     unsigned int busy_count;  ///< Counts number of currently occupied buffers.
     unsigned int next_free_buffer;  ///< Next in: index of the next free slot
                                     ///< for a request.
-    int free_buffer
-        [HE_QAT_BUFFER_COUNT];  ///< Keeps track of buffers that are available
-                                ///< (any value > 0 means the buffer at index i
-                                ///< is available).  The next_free_buffer does
-                                ///< not necessarily mean that the buffer is
-                                ///< already released from usage.
+    int* free_buffer;  ///< Keeps track of buffers that are available
+                       ///< (any value > 0 means the buffer at index i
+                       ///< is available).  The next_free_buffer does
+                       ///< not necessarily mean that the buffer is
+                       ///< already released from usage.
     unsigned int next_ready_buffer;  ///< Next out: index of next request to be
                                      ///< processed.
-    int ready_buffer
-        [HE_QAT_BUFFER_COUNT];  ///< Keeps track of buffers that are ready (any
-                                ///< value > 0 means the buffer at index i is
-                                ///< ready). The next_ready_buffer does not
-                                ///< necessarily mean that the buffer is not
-                                ///< busy at any time instance.
+    int* ready_buffer;  ///< Keeps track of buffers that are ready (any
+                        ///< value > 0 means the buffer at index i is
+                        ///< ready). The next_ready_buffer does not
+                        ///< necessarily mean that the buffer is not
+                        ///< busy at any time instance.
     pthread_mutex_t mutex;  ///< Used for synchronization of concurrent access
                             ///< of an object of the type
     pthread_cond_t
@@ -124,6 +189,7 @@ typedef struct {
 typedef struct {
     int inst_id;                          ///< QAT instance ID.
     CpaInstanceHandle inst_handle;        ///< Handle of this QAT instance.
+    Cpa32U node;  ///< NUMA node the instance's device is attached to.
     pthread_attr_t* attr;                 ///< Unused member.
     HE_QAT_RequestBuffer* he_qat_buffer;  ///< Unused member.
     pthread_mutex_t mutex;
@@ -136,6 +202,14 @@ typedef struct {
         running;  ///< State of this QAT instance's processing thread (any value
                   ///< different from 0 indicates that it is running).
     CpaStatus status;  ///< Status of the latest activity by this QAT instance.
+    pthread_cond_t work;  ///< Signaled when a request is submitted to an idle
+                          ///< instance (HE_QAT_POLL_EVENT).
+    volatile int idle;    ///< Polling thread is blocked on work.
+    volatile unsigned long submitted;  ///< Requests submitted to the instance.
+    volatile unsigned long completed;  ///< Responses polled from the instance.
+    unsigned long polls;        ///< Calls to icp_sal_CyPollInstance().
+    unsigned long empty_polls;  ///< Polls that delivered no response.
+    unsigned long idle_waits;   ///< Waits with no request in flight.
 } HE_QAT_InstConfig;
 
 typedef struct {
@@ -164,6 +238,11 @@ typedef struct {
                       ///< for the caller.
     void* callback_func;  ///< Pointer to the callback function.
     volatile HE_QAT_STATUS request_status;
+    unsigned long long submit_ns;  ///< Time of submission to the accelerator.
+    int node;  ///< NUMA node of the thread that submitted the request.
+    void* completion_queue;  ///< HE_QAT_CompletionQueue of an asynchronous
+                             ///< request, NULL otherwise.
+    void* user_data;  ///< Caller data of an asynchronous request.
     pthread_mutex_t mutex;
     pthread_cond_t ready;
 #ifdef HE_QAT_PERF
@@ -175,10 +254,75 @@ typedef struct {
 } HE_QAT_TaskRequest;
 
 typedef struct {
-    HE_QAT_TaskRequest* request[HE_QAT_BUFFER_SIZE];
+    HE_QAT_TaskRequest** request;
     unsigned int count;
+    unsigned int capacity;  ///< Number of entries in request.
 } HE_QAT_TaskRequestList;
 
+/// @brief Work request recycled through a HE_QAT_RequestSlab.
+/// @details The operands and the result share one block of contiguous memory
+/// that is kept across uses and only reallocated when a larger operand size
+/// is requested.
+typedef struct {
+    HE_QAT_TaskRequest request;  ///< Must be first: the library passes
+                                 ///< &slot->request around.
+    CpaCyLnModExpOpData op_data;  ///< Input data pointed to by
+                                  ///< request.op_data.
+    Cpa8U* mem;  ///< Contiguous memory: base, exponent, modulus and result.
+    Cpa32U mem_len;  ///< Capacity of each of the four operands in mem.
+    void* slab;  ///< Owning HE_QAT_RequestSlab, NULL if the request was
+                 ///< allocated because the slab was exhausted.
+} HE_QAT_RequestSlot;
+
+/// @brief Preallocated work requests handed out through a free list.
+typedef struct {
+    HE_QAT_RequestSlot* slots;  ///< As many requests as free_list has slots.
+    HE_QAT_RequestBuffer free_list;  ///< Requests available for use.
+} HE_QAT_RequestSlab;
+
+/// @brief Operand memory of a modular exponentiation request reserved with
+/// HE_QAT_bnModExpReserve_MT(), to be filled by the caller in place.
+/// @details Each pointer initially refers to the request's own QAT memory.
+/// The caller may point any of them at other QAT contiguous memory that
+/// stays valid until the request completes, e.g. the modulus of the first
+/// request of a batch, shared by the rest of the batch.
+typedef struct {
+    unsigned char* base;      ///< Base, nbits/8 bytes big-endian.
+    unsigned char* exponent;  ///< Exponent, nbits/8 bytes big-endian.
+    unsigned char* modulus;   ///< Modulus, nbits/8 bytes big-endian.
+    unsigned char* result;    ///< Where the device writes the remainder.
+    void* request;            ///< Reserved request (opaque).
+} HE_QAT_BnModExpOperands;
+
+/// @brief Identifies an asynchronous request within its completion queue.
+typedef unsigned long long HE_QAT_Ticket;
+
+/// @brief Completion of an asynchronous request, see
+/// poll_completion_queue().
+typedef struct {
+    HE_QAT_Ticket ticket;  ///< Ticket returned on submission.
+    HE_QAT_STATUS status;  ///< HE_QAT_STATUS_SUCCESS or HE_QAT_STATUS_FAIL.
+    void* user_data;       ///< Caller data passed on submission.
+    unsigned char* result;  ///< Remainder, nbits/8 bytes big-endian. Valid
+                            ///< until the next harvest from the queue if it
+                            ///< was left in the request's QAT memory.
+} HE_QAT_Completion;
+
+/// @brief Completion queue of the asynchronous interface, owned by one
+/// caller thread at a time.
+/// @details Callbacks push completed requests to the done ring in completion
+/// order. Requests returned by a harvest are recycled by the next one, so
+/// their results can be read in place in between.
+typedef struct {
+    HE_QAT_RequestBuffer done;  ///< Completed requests not yet harvested.
+    HE_QAT_TaskRequest** harvested;  ///< Requests of the last harvest, room
+                                     ///< for the capacity of done.
+    unsigned int num_harvested;         ///< Entries in harvested.
+    volatile unsigned int outstanding;  ///< Reserved and not yet harvested,
+                                        ///< at most the capacity of done.
+    HE_QAT_Ticket next_ticket;          ///< Ticket of the next submission.
+} HE_QAT_CompletionQueue;
+
 #ifdef __cplusplus
 }  // close the extern "C" {
 #endif
@@ -19,6 +19,7 @@ extern "C" {
 
 #include <openssl/bn.h>
 #include <errno.h>
+#include <time.h>
 
 #include <qae_mem.h>
 
@@ -143,6 +144,13 @@ static __inline HE_QAT_STATUS HE_QAT_sleep(unsigned int time,
 }
 #define HE_QAT_SLEEP(time, timeUnit) HE_QAT_sleep((time), (timeUnit))
 
+/// @brief Monotonic time in nanoseconds.
+static __inline unsigned long long HE_QAT_getTimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * HE_QAT_NANOSEC + ts.tv_nsec;
+}
+
 /// @brief
 ///      This function returns the physical address
 ///      for a given virtual address. In case of error
@@ -14,17 +14,45 @@ extern "C" {
 #include "heqat/common/types.h"
 
 /// @brief
-/// Configure and initialize QAT runtime environment.
+/// Configure and initialize QAT runtime environment with the default limits
+/// (HE_QAT_NUM_ACTIVE_INSTANCES, HE_QAT_BUFFER_SIZE, HE_QAT_BUFFER_COUNT).
 HE_QAT_STATUS acquire_qat_devices();
 
+/// @brief
+/// Configure and initialize QAT runtime environment with the given number of
+/// instances and buffer capacities, e.g. to use every instance of a
+/// multi-device server.
+HE_QAT_STATUS acquire_qat_devices_with_limits(const HE_QAT_Limits* limits);
+
 /// @brief
 /// Release and free resources of the QAT runtime environment.
 HE_QAT_STATUS release_qat_devices();
 
+/// @brief
+/// Read the limits of the QAT runtime environment in use.
+void get_qat_limits(HE_QAT_Limits* limits);
+
 /// @brief
 /// Probe context status of the QAT runtime environment.
 HE_QAT_STATUS get_qat_context_state();
 
+/// @brief
+/// Select the polling policy of the instances and the latency target of the
+/// in-flight limit. The policy takes effect at the next acquire_qat_devices().
+HE_QAT_STATUS set_qat_poll_config(const HE_QAT_PollConfig* config);
+
+/// @brief
+/// Read the current polling configuration.
+void get_qat_poll_config(HE_QAT_PollConfig* config);
+
+/// @brief
+/// Collect polling and throttling counters of the QAT runtime environment.
+void get_qat_poll_stats(HE_QAT_PollStats* stats);
+
+/// @brief
+/// Reset the counters reported by get_qat_poll_stats().
+void reset_qat_poll_stats();
+
 #ifdef __cplusplus
 }  // extern "C" {
 #endif
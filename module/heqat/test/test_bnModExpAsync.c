@@ -0,0 +1,127 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Sample showing how to use the completion-queue (asynchronous) interface.
+// Requests are submitted in a sliding window: whenever the queue is full,
+// completions are harvested in completion order, checked against OpenSSL
+// and the window is refilled. Results are read in place from QAT memory.
+// Usage: test_bnModExpAsync [nbits] [requests]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <openssl/bn.h>
+
+#include "heqat/heqat.h"
+
+int main(int argc, const char** argv) {
+    int nbits = (argc > 1) ? atoi(argv[1]) : 2048;
+    unsigned int num_requests = (argc > 2) ? atoi(argv[2]) : 4096;
+
+    if (nbits < 64 || nbits % 64 || 0 == num_requests) {
+        printf("Invalid arguments.\n");
+        exit(1);
+    }
+    int len = nbits / 8;
+
+    BN_CTX* ctx = BN_CTX_new();
+    BIGNUM* bn_mod = BN_new();
+    BIGNUM* bn_exp = BN_new();
+    BN_rand(bn_mod, nbits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD);
+    BN_rand_range(bn_exp, bn_mod);
+
+    // Distinct bases and their expected remainders
+    unsigned char* bases = (unsigned char*)calloc(num_requests, len);
+    unsigned char* expected = (unsigned char*)calloc(num_requests, len);
+    unsigned char* exponent = (unsigned char*)calloc(len, 1);
+    unsigned char* modulus = (unsigned char*)calloc(len, 1);
+    BN_bn2binpad(bn_mod, modulus, len);
+    BN_bn2binpad(bn_exp, exponent, len);
+    BIGNUM* bn_base = BN_new();
+    BIGNUM* bn_res = BN_new();
+    for (unsigned int i = 0; i < num_requests; i++) {
+        BN_rand_range(bn_base, bn_mod);
+        BN_mod_exp(bn_res, bn_base, bn_exp, bn_mod, ctx);
+        BN_bn2binpad(bn_base, bases + i * len, len);
+        BN_bn2binpad(bn_res, expected + i * len, len);
+    }
+
+    acquire_qat_devices();
+
+    HE_QAT_CompletionQueue* cq = NULL;
+    if (HE_QAT_STATUS_SUCCESS != create_completion_queue(&cq)) {
+        release_qat_devices();
+        exit(1);
+    }
+
+    // A harvest returns at most the capacity of the queue
+    HE_QAT_Limits limits;
+    get_qat_limits(&limits);
+    HE_QAT_Completion* completions = (HE_QAT_Completion*)malloc(
+        limits.buffer_size * sizeof(HE_QAT_Completion));
+
+    struct timeval start_time, end_time;
+    gettimeofday(&start_time, NULL);
+
+    unsigned int submitted = 0;
+    unsigned int completed = 0;
+    unsigned int out_of_order = 0;
+    HE_QAT_Ticket last_ticket = 0;
+    int failed = 0;
+    while (completed < num_requests) {
+        // Fill the window
+        while (submitted < num_requests) {
+            HE_QAT_Ticket ticket;
+            HE_QAT_STATUS status = HE_QAT_bnModExp_Async(
+                cq, NULL, bases + submitted * len, exponent, modulus, nbits,
+                (void*)(size_t)submitted, &ticket);
+            if (HE_QAT_STATUS_BUSY == status) break;
+            if (HE_QAT_STATUS_SUCCESS != status) {
+                failed = 1;
+                break;
+            }
+            submitted++;
+        }
+        if (failed) break;
+
+        unsigned int count =
+            wait_completion_queue(cq, completions, 1, limits.buffer_size);
+        for (unsigned int i = 0; i < count; i++) {
+            size_t idx = (size_t)completions[i].user_data;
+            if (completions[i].ticket < last_ticket) out_of_order++;
+            last_ticket = completions[i].ticket;
+            if (HE_QAT_STATUS_SUCCESS != completions[i].status ||
+                memcmp(completions[i].result, expected + idx * len, len))
+                failed = 1;
+        }
+        completed += count;
+    }
+
+    gettimeofday(&end_time, NULL);
+    double elapsed = (end_time.tv_sec - start_time.tv_sec) * 1e6 +
+                     (end_time.tv_usec - start_time.tv_usec);
+
+    if (HE_QAT_STATUS_SUCCESS != destroy_completion_queue(cq)) failed = 1;
+
+    printf("Bits: %d  Requests: %u  Wall Time: %.1lfus  Out of Order: %u"
+           "\t\t%s\n",
+           nbits, completed, elapsed, out_of_order,
+           failed ? "** FAIL **" : "** PASS **");
+
+    release_qat_devices();
+
+    free(completions);
+    free(modulus);
+    free(exponent);
+    free(expected);
+    free(bases);
+    BN_free(bn_res);
+    BN_free(bn_base);
+    BN_free(bn_exp);
+    BN_free(bn_mod);
+    BN_CTX_free(ctx);
+
+    return failed;
+}
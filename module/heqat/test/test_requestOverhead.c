@@ -0,0 +1,169 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures the per-request overhead of the request path (outstanding
+// buffers, scheduler, internal buffer, submission, polling and release).
+// Threads submit batches of modular exponentiations with exponent 1, whose
+// cost on the device is negligible, so the time per request is dominated by
+// the library itself. Each thread gets an outstanding buffer of its own.
+// Usage: test_requestOverhead [threads] [nbits] [batch] [rounds]
+// [fixed|adaptive|event [target_latency_us]]. Best run against the software
+// QAT device model.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <openssl/bn.h>
+
+#include "heqat/heqat.h"
+
+typedef struct {
+    int nbits;
+    unsigned int batch;
+    unsigned int rounds;
+    unsigned char* base;
+    unsigned char* exponent;
+    unsigned char* modulus;
+    unsigned char* result;
+    int failed;
+} OverheadArgs;
+
+static void* submit_batches(void* _args) {
+    OverheadArgs* args = (OverheadArgs*)_args;
+    int len = args->nbits / 8;
+
+    for (unsigned int r = 0; r < args->rounds; r++) {
+        unsigned int buffer_id = 0;
+        acquire_bnModExp_buffer(&buffer_id);
+        for (unsigned int i = 0; i < args->batch; i++) {
+            HE_QAT_bnModExp_MT(buffer_id, args->result + i * len, args->base,
+                               args->exponent, args->modulus, args->nbits);
+        }
+        release_bnModExp_buffer(buffer_id, args->batch);
+
+        // base < modulus, so base ^ 1 mod modulus = base
+        for (unsigned int i = 0; i < args->batch; i++) {
+            if (memcmp(args->result + i * len, args->base, len)) {
+                args->failed = 1;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, const char** argv) {
+    unsigned int num_threads = (argc > 1) ? atoi(argv[1]) : 8;
+    int nbits = (argc > 2) ? atoi(argv[2]) : 2048;
+    unsigned int batch = (argc > 3) ? atoi(argv[3]) : 256;
+    unsigned int rounds = (argc > 4) ? atoi(argv[4]) : 20;
+
+    HE_QAT_PollConfig poll_config;
+    get_qat_poll_config(&poll_config);
+    if (argc > 5) {
+        if (0 == strcmp(argv[5], "fixed"))
+            poll_config.policy = HE_QAT_POLL_FIXED;
+        else if (0 == strcmp(argv[5], "adaptive"))
+            poll_config.policy = HE_QAT_POLL_ADAPTIVE;
+        else if (0 == strcmp(argv[5], "event"))
+            poll_config.policy = HE_QAT_POLL_EVENT;
+        else
+            num_threads = 0;
+    }
+    if (argc > 6) poll_config.target_latency_us = atoi(argv[6]);
+
+    if (0 == num_threads || nbits < 64 || nbits % 64 || 0 == batch ||
+        batch > HE_QAT_MAX_BUFFER_SIZE || 0 == rounds) {
+        printf("Invalid arguments.\n");
+        exit(1);
+    }
+    set_qat_poll_config(&poll_config);
+    int len = nbits / 8;
+
+    // Shared operands: odd modulus of nbits bits, base below the modulus
+    BIGNUM* bn_mod = BN_new();
+    BIGNUM* bn_base = BN_new();
+    BN_rand(bn_mod, nbits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD);
+    BN_rand_range(bn_base, bn_mod);
+
+    unsigned char* modulus = (unsigned char*)calloc(len, 1);
+    unsigned char* base = (unsigned char*)calloc(len, 1);
+    unsigned char* exponent = (unsigned char*)calloc(len, 1);
+    BN_bn2binpad(bn_mod, modulus, len);
+    BN_bn2binpad(bn_base, base, len);
+    exponent[len - 1] = 1;
+
+    HE_QAT_Limits limits = {HE_QAT_NUM_ACTIVE_INSTANCES,
+                            (batch > HE_QAT_BUFFER_SIZE) ? batch
+                                                         : HE_QAT_BUFFER_SIZE,
+                            num_threads};
+    if (HE_QAT_STATUS_SUCCESS != acquire_qat_devices_with_limits(&limits)) {
+        printf("Failed to acquire QAT devices.\n");
+        exit(1);
+    }
+
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    OverheadArgs* args =
+        (OverheadArgs*)calloc(num_threads, sizeof(OverheadArgs));
+    for (unsigned int t = 0; t < num_threads; t++) {
+        args[t].nbits = nbits;
+        args[t].batch = batch;
+        args[t].rounds = rounds;
+        args[t].base = base;
+        args[t].exponent = exponent;
+        args[t].modulus = modulus;
+        args[t].result = (unsigned char*)calloc(batch, len);
+    }
+
+    reset_qat_poll_stats();
+
+    struct timeval start_time, end_time;
+    gettimeofday(&start_time, NULL);
+    for (unsigned int t = 0; t < num_threads; t++)
+        pthread_create(&threads[t], NULL, submit_batches, &args[t]);
+    for (unsigned int t = 0; t < num_threads; t++)
+        pthread_join(threads[t], NULL);
+    gettimeofday(&end_time, NULL);
+
+    HE_QAT_PollStats stats;
+    get_qat_poll_stats(&stats);
+
+    double elapsed = (end_time.tv_sec - start_time.tv_sec) * 1e6 +
+                     (end_time.tv_usec - start_time.tv_usec);
+    double num_requests = (double)num_threads * batch * rounds;
+
+    int failed = 0;
+    for (unsigned int t = 0; t < num_threads; t++) {
+        failed |= args[t].failed;
+        free(args[t].result);
+    }
+
+    printf("Threads: %u  Bits: %d  Requests: %.0lf  Wall Time: %.1lfus\n",
+           num_threads, nbits, num_requests, elapsed);
+    printf("Per Request: %.2lfus  Throughput: %.0lf requests/s\t\t%s\n",
+           elapsed / num_requests, num_requests / (elapsed * 1e-6),
+           failed ? "** FAIL **" : "** PASS **");
+
+    const char* policy_names[] = {"fixed", "adaptive", "event"};
+    printf("Polling: %s  Polls: %lu (%lu empty)  Idle Waits: %lu  "
+           "Throttle Waits: %lu\n",
+           policy_names[poll_config.policy], stats.polls, stats.empty_polls,
+           stats.idle_waits, stats.throttle_waits);
+    printf("Responses: %lu  Mean Latency: %.1lfus  In-flight Limit: %lu\n",
+           stats.responses, stats.avg_latency_us, stats.inflight_limit);
+
+    release_qat_devices();
+
+    free(args);
+    free(threads);
+    free(exponent);
+    free(base);
+    free(modulus);
+    BN_free(bn_base);
+    BN_free(bn_mod);
+
+    return failed;
+}
@@ -0,0 +1,239 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ipcl/ipcl.hpp"
+
+static std::atomic<int> g_num_alloc{0};
+static std::atomic<int> g_num_free{0};
+
+static void* countingAllocate(std::size_t bytes) {
+  g_num_alloc++;
+  return ::operator new(bytes);
+}
+
+static void countingDeallocate(void* p, std::size_t bytes) {
+  g_num_free++;
+  ::operator delete(p);
+}
+
+static const Ipp32u* dataOf(const BigNumber& bn) {
+  Ipp32u* data;
+  ippsRef_BN(nullptr, nullptr, &data, bn);
+  return data;
+}
+
+TEST(BigNumberTest, StorageTest) {
+  const BigNumber big("0x123456789abcdef0123456789abcdef0123456789abcdef");
+  const BigNumber small(7u);
+
+  // assignment reuses storage that is large enough
+  BigNumber a = big;
+  const Ipp32u* storage = dataOf(a);
+  a = small;
+  EXPECT_EQ(a, small);
+  EXPECT_EQ(dataOf(a), storage);
+  a = big * big;
+  EXPECT_EQ(a, big * big);
+
+  // moves transfer the storage
+  BigNumber b(std::move(a));
+  EXPECT_EQ(b, big * big);
+  // a moved-from BigNumber reads as zero, and can be copied, printed and
+  // assigned again
+  EXPECT_EQ(a, BigNumber::Zero());
+  BigNumber copy(a);
+  EXPECT_EQ(copy, BigNumber::Zero());
+  copy = big;
+  copy = a;
+  EXPECT_EQ(copy, BigNumber::Zero());
+  std::ostringstream os, os_zero;
+  os << a;
+  os_zero << BigNumber::Zero();
+  EXPECT_EQ(os.str(), os_zero.str());
+  a = small;
+  EXPECT_EQ(a, small);
+  storage = dataOf(b);
+  a = std::move(b);
+  EXPECT_EQ(dataOf(a), storage);
+  EXPECT_EQ(b, BigNumber::Zero());
+
+  // buffers return to the allocator they came from
+  static const BigNumber::Allocator counting = {countingAllocate,
+                                                countingDeallocate};
+  BigNumber::SetAllocator(&counting);
+  EXPECT_EQ(BigNumber::GetAllocator(), &counting);
+  {
+    std::vector<BigNumber> v(8, big);
+    // moves do not allocate
+    int num_alloc = g_num_alloc.load();
+    BigNumber moved(std::move(v[0]));
+    v[1] = std::move(moved);
+    v[0] = v[1];
+    EXPECT_EQ(g_num_alloc.load(), num_alloc + 1);  // v[0] only
+    BigNumber::SetAllocator(nullptr);
+    for (auto& x : v) x = x * small + 1u;
+    EXPECT_EQ(v[0], big * small + 1u);
+  }
+  EXPECT_GT(g_num_alloc.load(), 0);
+  EXPECT_EQ(g_num_alloc.load(), g_num_free.load());
+}
+
+TEST(BigNumberTest, StringTest) {
+  EXPECT_EQ(BigNumber("1234567890123"), BigNumber("0x11f71fb04cb"));
+  EXPECT_EQ(BigNumber("-42"), BigNumber(-42));
+  EXPECT_EQ(BigNumber("0X2a"), BigNumber(42u));
+
+  // malformed strings are rejected rather than parsed partially
+  for (const char* s : {"", "-", "0x", "12a", "0x12g", "1 2", "--1"})
+    EXPECT_THROW(BigNumber{s}, std::runtime_error) << "\"" << s << "\"";
+}
+
+TEST(BigNumberTest, SharedModulusTest) {
+  const int num_values = 64;
+  ipcl::KeyPair keys = ipcl::generateKeypair(1024);
+  const BigNumber& nsq = *(keys.pub_key.getNSQ());
+  const BigNumber& n = *(keys.pub_key.getN());
+
+  std::vector<BigNumber> base(num_values);
+  for (int i = 0; i < num_values; i++)
+    base[i] = ipcl::getRandomBN(2048) % nsq;
+
+  // shared operands give the same results as replicated ones
+  std::vector<BigNumber> exp_v(num_values, n), mod_v(num_values, nsq);
+  std::vector<BigNumber> expected = ipcl::modExp(base, exp_v, mod_v);
+  EXPECT_EQ(ipcl::modExp(base, exp_v, nsq), expected);
+  EXPECT_EQ(ipcl::modExp(base, n, nsq), expected);
+
+  // concurrent use of shared operands leaves them untouched
+  const BigNumber nsq_before = nsq;
+  const BigNumber n_before = n;
+  std::vector<BigNumber> rem(num_values), quo(num_values);
+  std::vector<BigNumber> inv(num_values), gcd(num_values);
+  ipcl::parallelFor(num_values, [&](std::size_t i) {
+    rem[i] = base[i] * base[i] % nsq;
+    quo[i] = base[i] * base[i] / n;
+    inv[i] = n.InverseMul(base[i] % n);
+    gcd[i] = n.gcd(base[i]);
+  });
+  EXPECT_EQ(nsq, nsq_before);
+  EXPECT_EQ(n, n_before);
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(rem[i], (base[i] * base[i]) % BigNumber(nsq));
+    EXPECT_EQ(quo[i], (base[i] * base[i]) / BigNumber(n));
+    EXPECT_EQ(inv[i] * base[i] % n, BigNumber::One());
+    EXPECT_EQ(gcd[i], BigNumber::One());
+  }
+}
+
+TEST(BigNumberTest, FixedBigNumTest) {
+  using Num = ipcl::FixedBigNum<2048>;
+  const int num_values = 32;
+  ipcl::KeyPair keys = ipcl::generateKeypair(1024);
+  const BigNumber& nsq = *(keys.pub_key.getNSQ());
+  const BigNumber& n = *(keys.pub_key.getN());
+
+  std::vector<BigNumber> a(num_values), b(num_values), m(num_values);
+  for (int i = 0; i < num_values; i++) {
+    a[i] = ipcl::getRandomBN(2048) % nsq;
+    b[i] = ipcl::getRandomBN(2048) % nsq;
+    m[i] = ipcl::getRandomBN(1024) % n;
+  }
+  b[0] = BigNumber::Zero();
+  b[1] = nsq - 1u;
+
+  Num x, y, r;
+  ASSERT_TRUE(Num::fromBigNumber(a[2], x));
+  ASSERT_TRUE(Num::fromBigNumber(b[2], y));
+  EXPECT_EQ(x.toBigNumber(), a[2]);
+  EXPECT_FALSE(Num::fromBigNumber(nsq * nsq, x));
+  EXPECT_FALSE(Num::fromBigNumber(BigNumber(-1), x));
+
+  // add/sub/mul against BigNumber
+  ipcl::FixedBigNum<4096> wide;
+  Num::mul(wide, x, y);
+  EXPECT_EQ(wide.toBigNumber(), a[2] * b[2]);
+  Num::sub(r, x, y);
+  Num::add(r, r, y);
+  EXPECT_EQ(r.compare(x), 0);
+
+  ipcl::FixedMontgomery<2048> mont(nsq);
+  mont.toMont(r, x);
+  mont.fromMont(r, r);
+  EXPECT_EQ(r.toBigNumber(), a[2]);
+
+  // batched kernels give the BigNumber results
+  std::vector<BigNumber> prod = ipcl::modMul(a, b, nsq);
+  std::vector<BigNumber> enc = ipcl::mulPlusOneMod(n, m, nsq);
+  std::vector<BigNumber> enc_sq = ipcl::mulPlusOneMod(n, m, nsq, true);
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(prod[i], a[i] * b[i] % nsq);
+    EXPECT_EQ(enc[i], (n * m[i] + 1) % nsq);
+    EXPECT_EQ(enc_sq[i], enc[i]);
+  }
+
+  // even moduli use the BigNumber path
+  BigNumber even = nsq + 1u;
+  EXPECT_EQ(ipcl::modMul(a, b, even)[3], a[3] * b[3] % even);
+}
+
+TEST(BigNumberTest, BigEndianTest) {
+  const int num_values = 37;
+  const int len = 13;  // not a multiple of the vector width
+  std::vector<BigNumber> v(num_values);
+  for (int i = 0; i < num_values; i++) v[i] = ipcl::getRandomBN(100);
+  v[0] = BigNumber::Zero();
+
+  std::vector<std::vector<unsigned char>> bufs(
+      num_values, std::vector<unsigned char>(len, 0xff));
+  std::vector<unsigned char*> ptrs(num_values);
+  for (int i = 0; i < num_values; i++) ptrs[i] = bufs[i].data();
+
+  ipcl::exportBigEndian(v, len, ptrs.data());
+  for (int i = 0; i < num_values; i++) {
+    std::vector<unsigned char> ref(len);
+    ASSERT_TRUE(BigNumber::toBin(ref.data(), len, v[i]));
+    EXPECT_EQ(bufs[i], ref);
+  }
+
+  // import overwrites values of any size
+  std::vector<BigNumber> w(num_values, ipcl::getRandomBN(2048));
+  w[1] = BigNumber::Zero();
+  ipcl::importBigEndian(ptrs.data(), len, num_values, w.data());
+  EXPECT_EQ(w, v);
+
+  // a broadcast view fills every buffer
+  BigNumber mod = ipcl::getRandomBN(96);
+  ipcl::exportBigEndian(ipcl::BigNumberView::broadcast(mod, num_values), len,
+                        ptrs.data());
+  ipcl::importBigEndian(ptrs.data(), len, num_values, w.data());
+  for (int i = 0; i < num_values; i++) EXPECT_EQ(w[i], mod);
+
+  // 2^128 needs more than len bytes
+  const Ipp32u big[5] = {0, 0, 0, 0, 1};
+  v[num_values - 1] = BigNumber(big, 5);
+  EXPECT_THROW(ipcl::exportBigEndian(v, len, ptrs.data()), std::runtime_error);
+}
+
+TEST(BigNumberTest, RandomBNsTest) {
+  const int num_values = 257;
+  for (int bits : {1, 31, 64, 1025}) {
+    std::vector<BigNumber> r = ipcl::getRandomBNs(num_values, bits);
+    ASSERT_EQ(r.size(), num_values);
+    for (const auto& x : r) EXPECT_LE(x.BitSize(), bits);
+  }
+
+  // values drawn by different threads do not repeat
+  std::vector<BigNumber> r = ipcl::getRandomBNs(num_values, 256);
+  std::sort(r.begin(), r.end());
+  EXPECT_EQ(std::adjacent_find(r.begin(), r.end()), r.end());
+
+  EXPECT_THROW(ipcl::getRandomBNs(1, 0), std::runtime_error);
+}
@@ -2,9 +2,13 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <omp.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <climits>
+#include <cstdio>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -239,3 +243,360 @@ TEST(CryptoTest, ISO_IEC_18033_6_ComplianceTest) {
   m1m2.num2hex(str4);
   EXPECT_EQ(str4, dt_sum.getElementHex(0));
 }
+
+static std::string toHexString(const std::vector<unsigned char>& v) {
+  static const char* digits = "0123456789abcdef";
+  std::string s;
+  for (unsigned char c : v) {
+    s.push_back(digits[c >> 4]);
+    s.push_back(digits[c & 0xf]);
+  }
+  return s;
+}
+
+TEST(CryptoTest, AesCtrDrbgTest) {
+  if (!ipcl::AesCtrDrbg::isSupported()) GTEST_SKIP();
+
+  // CTR_DRBG AES-256 without derivation function, seeded with 0x00..0x2f
+  unsigned char seed[ipcl::AesCtrDrbg::kSeedLen];
+  for (int i = 0; i < ipcl::AesCtrDrbg::kSeedLen; i++) seed[i] = i;
+  ipcl::AesCtrDrbg drbg(seed);
+
+  // a partial last block, then a request long enough for the VAES path
+  std::vector<unsigned char> out(100);
+  drbg.generate(out.data(), out.size());
+  EXPECT_EQ(toHexString(out),
+            "061550234d158c5ec95595fe04ef7a25767f2e24cc2bc479d09d86dc9abcfd"
+            "e7056a8c266f9ef97ed08541dbd2e1ffa19810f5392d076276ef41277c3ab6"
+            "e94a4e3b7dcc104a05bb089d338bf55c72cab375389a94bb920bd5d6dc9e7f"
+            "2ec6fde028b6f5");
+  out.resize(300);
+  drbg.generate(out.data(), out.size());
+  EXPECT_EQ(toHexString(std::vector<unsigned char>(out.end() - 16, out.end())),
+            "39533c5b9c24f6435cdcad39895e6f7b");
+
+  for (int i = 0; i < ipcl::AesCtrDrbg::kSeedLen; i++) seed[i] = 48 + i;
+  drbg.reseed(seed);
+  out.resize(32);
+  drbg.generate(out.data(), out.size());
+  EXPECT_EQ(toHexString(out),
+            "c1db27fcd8f0ac1c79af4aa1fd567bfebdc863c704b61d63d995b9ede4748078");
+
+  // instances seeded from the entropy source differ
+  std::vector<unsigned char> a(64), b(64);
+  ipcl::getThreadDrbg().generate(a.data(), a.size());
+  ipcl::AesCtrDrbg().generate(b.data(), b.size());
+  EXPECT_NE(a, b);
+
+  // a forked child does not repeat the stream of its parent
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    drbg.generate(a.data(), a.size());
+    _exit(write(fds[1], a.data(), a.size()) == a.size() ? 0 : 1);
+  }
+  close(fds[1]);
+  std::vector<unsigned char> child(a.size());
+  EXPECT_EQ(read(fds[0], child.data(), child.size()), child.size());
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  drbg.generate(a.data(), a.size());
+  EXPECT_NE(a, child);
+}
+
+TEST(CryptoTest, RandomForkTest) {
+  const int bits = 1024;
+  const int len = bits / 32;
+  ipcl::getRandomBN(bits);
+
+  // a forked child does not draw the random values of its parent
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    std::vector<Ipp32u> v;
+    ipcl::getRandomBN(bits).num2vec(v);
+    v.resize(len);
+    std::size_t size = len * sizeof(Ipp32u);
+    _exit(write(fds[1], v.data(), size) == size ? 0 : 1);
+  }
+  close(fds[1]);
+  std::vector<Ipp32u> child(len);
+  EXPECT_EQ(read(fds[0], child.data(), len * sizeof(Ipp32u)),
+            len * sizeof(Ipp32u));
+  close(fds[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  std::vector<Ipp32u> parent;
+  ipcl::getRandomBN(bits).num2vec(parent);
+  parent.resize(len);
+  EXPECT_NE(parent, child);
+}
+
+TEST(CryptoTest, HybridAutoTuneTest) {
+  const uint32_t num_values = 512;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  ipcl::resetHybridTuning();
+  ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
+
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+  for (int round = 0; round < 3; round++) {
+    ipcl::CipherText ct = key.pub_key.encrypt(pt);
+    ipcl::PlainText dt = key.priv_key.decrypt(ct);
+    for (int i = 0; i < num_values; i++) {
+      std::vector<uint32_t> v = dt.getElementVec(i);
+      EXPECT_EQ(v[0], exp_value[i]);
+    }
+  }
+
+  // Only hybrid runs (QAT and CPU together) are measured
+  std::vector<ipcl::HybridTuningStats> stats = ipcl::getHybridTuningStats();
+#if defined(IPCL_USE_QAT) && defined(IPCL_USE_OMP)
+  EXPECT_FALSE(stats.empty());
+#endif
+  for (const auto& st : stats) {
+    EXPECT_GT(st.samples, 0);
+    EXPECT_GE(st.ratio, ipcl::IPCL_HYBRID_TUNER_MIN_RATIO);
+    EXPECT_LE(st.ratio, ipcl::IPCL_HYBRID_TUNER_MAX_RATIO);
+    EXPECT_EQ(st.mod_bits % 512, 0);
+  }
+
+  // learned ratios survive a save and load
+  std::string fn = testing::TempDir() + "ipcl_hybrid_tuning.txt";
+  ASSERT_TRUE(ipcl::saveHybridTuning(fn));
+  ipcl::resetHybridTuning();
+  EXPECT_TRUE(ipcl::getHybridTuningStats().empty());
+  ASSERT_TRUE(ipcl::loadHybridTuning(fn));
+  std::vector<ipcl::HybridTuningStats> loaded = ipcl::getHybridTuningStats();
+  ASSERT_EQ(loaded.size(), stats.size());
+  for (std::size_t i = 0; i < loaded.size(); i++) {
+    EXPECT_EQ(loaded[i].op, stats[i].op);
+    EXPECT_EQ(loaded[i].mod_bits, stats[i].mod_bits);
+    EXPECT_NEAR(loaded[i].ratio, stats[i].ratio, 1e-4);
+    EXPECT_EQ(loaded[i].samples, 0);
+  }
+  std::remove(fn.c_str());
+
+  EXPECT_FALSE(ipcl::loadHybridTuning(fn));
+  ipcl::resetHybridTuning();
+}
+
+#ifdef IPCL_USE_QAT
+TEST(CryptoTest, QATModExpErrorTest) {
+  const uint32_t num_values = 1000;
+  const uint32_t bad = 700;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+  BigNumber mod = *key.pub_key.getN();
+  BigNumber exp = ipcl::getRandomBN(1024) % mod;
+  std::vector<BigNumber> base(num_values);
+  for (auto& b : base) b = ipcl::getRandomBN(1024) % mod;
+  std::vector<BigNumber> ref = ipcl::ippModExp(
+      base, std::vector<BigNumber>(num_values, exp),
+      std::vector<BigNumber>(num_values, mod));
+
+  // A base too large for the request size throws once earlier requests are
+  // in flight; they are waited for and the completion queue is destroyed
+  std::vector<BigNumber> bad_base = base;
+  bad_base[bad] = mod * mod;
+  for (int round = 0; round < 3; round++)
+    EXPECT_THROW(ipcl::qatModExp(bad_base,
+                                 std::vector<BigNumber>(num_values, exp),
+                                 std::vector<BigNumber>(num_values, mod)),
+                 std::runtime_error);
+
+  // Nothing was left behind: QAT still computes and the context terminates
+  EXPECT_EQ(ipcl::qatModExp(base, std::vector<BigNumber>(num_values, exp),
+                            std::vector<BigNumber>(num_values, mod)),
+            ref);
+  ASSERT_TRUE(ipcl::terminateContext());
+  ASSERT_TRUE(ipcl::initializeContext("QAT"));
+}
+
+TEST(CryptoTest, HybridModExpTest) {
+  const uint32_t num_values = 2048;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+  BigNumber mod = *key.pub_key.getN();
+  std::vector<BigNumber> base(num_values), exp(num_values);
+  for (int i = 0; i < num_values; i++) {
+    base[i] = ipcl::getRandomBN(1024) % mod;
+    exp[i] = ipcl::getRandomBN(1024) % mod;
+  }
+  std::vector<BigNumber> mods(num_values, mod);
+  std::vector<BigNumber> ref = ipcl::ippModExp(base, exp, mods);
+
+  // QAT and the CPU workers pull chunks of the same call
+  ipcl::setHybridMode(ipcl::HybridMode::HALF);
+  EXPECT_EQ(ipcl::modExp(base, exp, mods), ref);
+
+  // The ratio caps the share of QAT, the CPU workers take the rest
+  for (float ratio : {0.05f, 0.95f}) {
+    ipcl::setHybridRatio(ratio);
+    EXPECT_EQ(ipcl::modExp(base, exp, mods), ref);
+  }
+
+  ipcl::resetHybridTuning();
+  ipcl::setHybridMode(ipcl::HybridMode::OPTIMAL);
+  for (int round = 0; round < 3; round++) {
+    ipcl::HybridOpScope scope(ipcl::HybridOp::MULTIPLY);
+    EXPECT_EQ(ipcl::modExp(base, exp, mods), ref);
+  }
+  std::vector<ipcl::HybridTuningStats> stats = ipcl::getHybridTuningStats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].samples, 3);
+  EXPECT_GT(stats[0].ratio, 0.0);
+  EXPECT_LT(stats[0].ratio, 1.0);
+
+  // A zero modulus every 8th value fails the CPU and QAT sides; the call
+  // throws only once the QAT requests in flight have completed
+  std::vector<BigNumber> bad_mods = mods;
+  for (int i = 7; i < num_values; i += 8) bad_mods[i] = BigNumber::Zero();
+  ipcl::setHybridMode(ipcl::HybridMode::HALF);
+  for (int round = 0; round < 3; round++)
+    EXPECT_THROW(ipcl::modExp(base, exp, bad_mods), std::runtime_error);
+
+  // An oversized base fails the conversion on the feeder thread
+  std::vector<BigNumber> bad_base = base;
+  for (int i = 0; i < num_values; i += 64) bad_base[i] = mod * mod;
+  EXPECT_THROW(ipcl::modExp(bad_base, exp, mods), std::runtime_error);
+
+  EXPECT_EQ(ipcl::modExp(base, exp, mods), ref);
+  ipcl::setHybridOff();
+  ipcl::resetHybridTuning();
+}
+#endif  // IPCL_USE_QAT
+
+TEST(CryptoTest, QATLimitsTest) {
+  const uint32_t num_values = 300;
+
+  ipcl::QATLimits limits;
+  limits.buffer_size = 200;  // rounded up to a power of 2
+  limits.batch_size = 64;
+#ifdef IPCL_USE_QAT
+  ASSERT_TRUE(ipcl::terminateContext());
+  ASSERT_TRUE(ipcl::initializeContext("QAT", limits));
+#else
+  ASSERT_TRUE(ipcl::initializeContext("default", limits));
+#endif
+
+  ipcl::QATLimits in_use = ipcl::getQATLimits();
+  EXPECT_EQ(in_use.batch_size, 64);
+#ifdef IPCL_USE_QAT
+  EXPECT_GT(in_use.num_instances, 0);
+  EXPECT_EQ(in_use.buffer_size, 256);
+  EXPECT_GT(in_use.buffer_count, 0);
+#endif
+
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  // The requests of a call span several small submission windows
+  ipcl::setHybridMode(ipcl::HybridMode::QAT);
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+  ipcl::PlainText dt = key.priv_key.decrypt(ct);
+  ipcl::setHybridOff();
+  for (int i = 0; i < num_values; i++) {
+    std::vector<uint32_t> v = dt.getElementVec(i);
+    EXPECT_EQ(v[0], exp_value[i]);
+  }
+
+#ifdef IPCL_USE_QAT
+  // Too small a queue for a submission window
+  limits.buffer_size = 2;
+  EXPECT_FALSE(ipcl::initializeContext("QAT", limits));
+
+  ASSERT_TRUE(ipcl::terminateContext());
+  ASSERT_TRUE(ipcl::initializeContext("QAT"));
+#else
+  ASSERT_TRUE(ipcl::initializeContext("default"));
+#endif
+  EXPECT_EQ(ipcl::getQATLimits().batch_size,
+            ipcl::IPCL_QAT_MODEXP_BATCH_SIZE);
+}
+
+TEST(CryptoTest, QATLimitsInitTest) {
+  const uint32_t num_values = 100;
+
+  ipcl::QATLimits limits;
+  limits.batch_size = 16;
+  limits.num_instances = 1;
+#ifdef IPCL_USE_QAT
+  ASSERT_TRUE(ipcl::terminateContext());
+  ASSERT_TRUE(ipcl::initializeContext("QAT", limits));
+#else
+  ASSERT_TRUE(ipcl::initializeContext("default", limits));
+#endif
+
+  ipcl::QATLimits in_use = ipcl::getQATLimits();
+  EXPECT_EQ(in_use.batch_size, 16);
+#ifdef IPCL_USE_QAT
+  EXPECT_EQ(in_use.num_instances, 1);
+
+  // Already initialized: other limits are refused, those in use are kept
+  ipcl::QATLimits other;
+  other.batch_size = 32;
+  other.num_instances = 2;
+  EXPECT_FALSE(ipcl::initializeContext("QAT", other));
+  EXPECT_FALSE(ipcl::initializeContext("QAT"));
+  in_use = ipcl::getQATLimits();
+  EXPECT_EQ(in_use.batch_size, 16);
+  EXPECT_EQ(in_use.num_instances, 1);
+#endif
+
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (int i = 0; i < num_values; i++) exp_value[i] = dist(rng);
+
+  ipcl::setHybridMode(ipcl::HybridMode::QAT);
+  ipcl::PlainText pt = ipcl::PlainText(exp_value);
+  ipcl::CipherText ct = key.pub_key.encrypt(pt);
+  ipcl::PlainText dt = key.priv_key.decrypt(ct);
+  ipcl::setHybridOff();
+  for (int i = 0; i < num_values; i++) {
+    std::vector<uint32_t> v = dt.getElementVec(i);
+    EXPECT_EQ(v[0], exp_value[i]);
+  }
+
+  // Too small a batch is refused and leaves the batch size unchanged
+  limits.batch_size = 2;
+#ifdef IPCL_USE_QAT
+  ASSERT_TRUE(ipcl::terminateContext());
+  EXPECT_FALSE(ipcl::initializeContext("QAT", limits));
+#else
+  EXPECT_FALSE(ipcl::initializeContext("default", limits));
+#endif
+  EXPECT_EQ(ipcl::getQATLimits().batch_size, 16);
+
+#ifdef IPCL_USE_QAT
+  ASSERT_TRUE(ipcl::initializeContext("QAT"));
+#else
+  ASSERT_TRUE(ipcl::initializeContext("default"));
+#endif
+  EXPECT_EQ(ipcl::getQATLimits().batch_size,
+            ipcl::IPCL_QAT_MODEXP_BATCH_SIZE);
+}
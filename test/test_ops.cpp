@@ -606,3 +606,100 @@ TEST(OperationTest, PtMultiplyCtArrayTest) {
     EXPECT_EQ(product, exp_product);
   }
 }
+
+TEST(OperationTest, CtViewOpsTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  const uint32_t half = num_values / 2;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048);
+
+  std::vector<uint32_t> exp_value1(num_values), exp_value2(num_values);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  for (int i = 0; i < num_values; i++) {
+    exp_value1[i] = dist(rng);
+    exp_value2[i] = dist(rng);
+  }
+  ipcl::PlainText pt1 = ipcl::PlainText(exp_value1);
+  ipcl::PlainText pt2 = ipcl::PlainText(exp_value2);
+
+  ipcl::CipherText ct1 = key.pub_key.encrypt(pt1);
+  // encrypt the second half of pt2 only
+  ipcl::CipherText ct2 =
+      key.pub_key.encrypt(ipcl::PlainTextView(pt2, half, num_values - half));
+  ASSERT_EQ(ct2.getSize(), num_values - half);
+
+  // even elements of ct1 + second half of pt2
+  ipcl::CipherTextView even(ct1, 0, half, 2);
+  ipcl::CipherText ct_sum = even + ipcl::CipherTextView(ct2);
+  ipcl::PlainText dt_sum = key.priv_key.decrypt(ct_sum);
+
+  // even elements of ct1 * odd elements of pt2
+  ipcl::CipherText ct_product = even * ipcl::PlainTextView(pt2, 1, half, 2);
+  ipcl::PlainText dt_product = key.priv_key.decrypt(ct_product);
+
+  for (int i = 0; i < half; i++) {
+    std::vector<uint32_t> v = dt_sum.getElementVec(i);
+    uint64_t sum = v[0];
+    if (v.size() > 1) sum = ((uint64_t)v[1] << 32) | v[0];
+    EXPECT_EQ(sum,
+              (uint64_t)exp_value1[2 * i] + (uint64_t)exp_value2[half + i]);
+
+    v = dt_product.getElementVec(i);
+    uint64_t product = v[0];
+    if (v.size() > 1) product = ((uint64_t)v[1] << 32) | v[0];
+    EXPECT_EQ(product,
+              (uint64_t)exp_value1[2 * i] * (uint64_t)exp_value2[2 * i + 1]);
+  }
+
+  // rotated views match CipherText::rotate, and decrypt without a copy
+  for (int shift : {1, -3}) {
+    ipcl::PlainText dt_rot = key.priv_key.decrypt(ct1.rotate(shift));
+    ipcl::PlainText dt_view =
+        key.priv_key.decrypt(ipcl::CipherTextView(ct1).rotate(shift));
+    for (int i = 0; i < num_values; i++) {
+      int src = ((i - shift) % static_cast<int>(num_values) + num_values) %
+                num_values;
+      EXPECT_EQ(dt_rot.getElementVec(i)[0], exp_value1[src]);
+      EXPECT_EQ(dt_view.getElementVec(i)[0], exp_value1[src]);
+    }
+  }
+
+  // rotated views are sliced into lanes by modexp, across the wraparound
+  for (int shift : {3, -5}) {
+    ipcl::CipherTextView ct_rot = ipcl::CipherTextView(ct1).rotate(shift);
+    ipcl::PlainText dt_rot_product =
+        key.priv_key.decrypt(ct_rot * ipcl::PlainTextView(pt2));
+
+    key.priv_key.enableCRT(false);
+    ipcl::PlainText dt_raw = key.priv_key.decrypt(ct_rot);
+    key.priv_key.enableCRT(true);
+
+    for (int i = 0; i < num_values; i++) {
+      int src = ((i - shift) % static_cast<int>(num_values) + num_values) %
+                num_values;
+      std::vector<uint32_t> v = dt_rot_product.getElementVec(i);
+      uint64_t product = v[0];
+      if (v.size() > 1) product = ((uint64_t)v[1] << 32) | v[0];
+      EXPECT_EQ(product,
+                (uint64_t)exp_value1[src] * (uint64_t)exp_value2[i]);
+      EXPECT_EQ(dt_raw.getElementVec(i)[0], exp_value1[src]);
+    }
+  }
+
+  // slices wrapping around a rotated view, and rotations of such slices
+  ipcl::CipherTextView ct_rot = ipcl::CipherTextView(ct1).rotate(4);
+  for (uint32_t stride : {1, 2, 3}) {
+    uint32_t size = (num_values - 1) / stride + 1;
+    ipcl::PlainText dt_slice =
+        key.priv_key.decrypt(ct_rot.slice(0, size, stride).rotate(1));
+    for (uint32_t i = 0; i < size; i++) {
+      uint32_t j = ((i + size - 1) % size) * stride;
+      EXPECT_EQ(dt_slice.getElementVec(i)[0],
+                exp_value1[(j + num_values - 4) % num_values]);
+    }
+  }
+}
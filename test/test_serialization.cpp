@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <climits>
+#include <cstdio>
 #include <random>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "ipcl/ipcl.hpp"
@@ -104,3 +106,268 @@ TEST(SerialTest, CipherText) {
     EXPECT_EQ(v[0], v_after[0]);
   }
 }
+
+TEST(SerialTest, BigNumberImportExportTest) {
+  const std::vector<std::string> dec = {
+      "0", "1", "4294967295", "4294967296", "-123456789012345678901234567890",
+      "340282366920938463463374607431768211455"};
+  std::vector<BigNumber> bns = ipcl::importDecimal(dec);
+  EXPECT_EQ(bns[1], BigNumber::One());
+  EXPECT_EQ(bns[2], BigNumber(0xffffffffu));
+  EXPECT_EQ(bns[3], BigNumber(0xffffffffu) + 1u);
+  EXPECT_EQ(bns[4], BigNumber("-0x18ee90ff6c373e0ee4e3f0ad2"));
+  EXPECT_EQ(bns[5], BigNumber("0xffffffffffffffffffffffffffffffff"));
+  EXPECT_EQ(ipcl::exportDecimal(bns), dec);
+
+  std::vector<std::string> hex = ipcl::exportHex(bns);
+  EXPECT_EQ(hex[0], "0x0");
+  EXPECT_EQ(hex[2], "0xffffffff");
+  EXPECT_EQ(ipcl::importHex(hex), bns);
+  EXPECT_EQ(ipcl::importHex({"FFffFFff"})[0], BigNumber(0xffffffffu));
+  EXPECT_THROW(ipcl::importDecimal({"12a"}), std::runtime_error);
+  EXPECT_THROW(ipcl::importHex({"0x"}), std::runtime_error);
+
+  // 5-byte values, in both byte orders
+  const std::vector<unsigned char> be = {0x01, 0x02, 0x03, 0x04, 0x05,
+                                         0x00, 0x00, 0x00, 0x00, 0xff};
+  std::vector<BigNumber> from_be =
+      ipcl::importBytes(be.data(), 5, 2, ipcl::ByteOrder::BIG);
+  EXPECT_EQ(from_be[0], BigNumber("0x0102030405"));
+  EXPECT_EQ(from_be[1], BigNumber(0xffu));
+
+  std::vector<unsigned char> le(be.size());
+  ipcl::exportBytes(from_be, 5, ipcl::ByteOrder::LITTLE, le.data());
+  EXPECT_EQ(le[0], 0x05);
+  EXPECT_EQ(le[4], 0x01);
+  EXPECT_EQ(ipcl::importBytes(le.data(), 5, 2, ipcl::ByteOrder::LITTLE),
+            from_be);
+
+  std::vector<unsigned char> be_after(be.size());
+  ipcl::exportBytes(from_be, 5, ipcl::ByteOrder::BIG, be_after.data());
+  EXPECT_EQ(be_after, be);
+  EXPECT_THROW(ipcl::exportBytes(from_be, 4, ipcl::ByteOrder::BIG,
+                                 be_after.data()),
+               std::runtime_error);
+
+  // bytes straight into the raw format
+  std::vector<Ipp32u> packed(2 * 3);
+  ipcl::importBytesRaw(be.data(), 5, 2, ipcl::ByteOrder::BIG, 3,
+                       packed.data());
+  EXPECT_EQ(ipcl::unpackRaw(packed.data(), 3, 2), from_be);
+}
+
+TEST(SerialTest, RawCipherText) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  ipcl::KeyPair keys = ipcl::generateKeypair(SELF_DEF_KEY_SIZE);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::for_each(exp_value.begin(), exp_value.end(),
+                [&](uint32_t& n) { n = dist(rng); });
+
+  ipcl::CipherText ct = keys.pub_key.encrypt(ipcl::PlainText(exp_value));
+  std::ostringstream os;
+  ipcl::serializer::serializeRaw(os, ct);
+  EXPECT_EQ(os.str().size(),
+            ipcl::IPCL_RAW_HEADER_SIZE +
+                num_values * ipcl::getRawWidth(keys.pub_key) * 4);
+
+  ipcl::CipherText ct_after;
+  std::istringstream is(os.str());
+  ipcl::serializer::deserializeRaw(is, keys.pub_key, ct_after);
+  ASSERT_EQ(ct_after.getSize(), num_values);
+
+  ipcl::PlainText dt = keys.priv_key.decrypt(ct_after);
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_EQ(ct.getElement(i), ct_after.getElement(i));
+    EXPECT_EQ(dt.getElementVec(i)[0], exp_value[i]);
+  }
+
+  // ciphertexts of another key are rejected
+  ipcl::KeyPair other = ipcl::generateKeypair(SELF_DEF_KEY_SIZE);
+  std::istringstream is_other(os.str());
+  EXPECT_THROW(
+      ipcl::serializer::deserializeRaw(is_other, other.pub_key, ct_after),
+      std::runtime_error);
+
+  // a forged count is caught as truncated data, before any large allocation
+  std::string forged = os.str();
+  forged[24 + 5] = 1;  // count += 2^40, little endian at offset 24
+  std::istringstream is_forged(forged);
+  EXPECT_THROW(
+      ipcl::serializer::deserializeRaw(is_forged, keys.pub_key, ct_after),
+      std::runtime_error);
+}
+
+TEST(SerialTest, ChunkedCipherTextTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  const std::size_t chunk_size = 4;
+  ipcl::KeyPair keys = ipcl::generateKeypair(SELF_DEF_KEY_SIZE);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  std::vector<uint32_t> exp_value(num_values);
+  std::for_each(exp_value.begin(), exp_value.end(),
+                [&](uint32_t& n) { n = dist(rng); });
+
+  ipcl::CipherText ct = keys.pub_key.encrypt(ipcl::PlainText(exp_value));
+  std::ostringstream os;
+  ipcl::serializer::serializeChunked(os, ct, chunk_size);
+  std::string bytes = os.str() + "trailer";
+
+  // feed the decoder in small pieces, as if received from a socket
+  ipcl::ChunkedDecoder decoder(keys.pub_key);
+  std::vector<ipcl::CipherText> chunks;
+  ipcl::CipherText chunk;
+  std::size_t pos = 0;
+  while (pos < bytes.size() && !decoder.isFinished()) {
+    std::size_t n = std::min<std::size_t>(7, bytes.size() - pos);
+    pos += decoder.feed(bytes.data() + pos, n);
+    while (decoder.next(chunk)) chunks.push_back(chunk);
+  }
+  EXPECT_TRUE(decoder.isFinished());
+  EXPECT_EQ(bytes.substr(pos), "trailer");
+  ASSERT_EQ(chunks.size(), (num_values + chunk_size - 1) / chunk_size);
+
+  std::size_t idx = 0;
+  for (const auto& c : chunks) {
+    EXPECT_LE(c.getSize(), chunk_size);
+    for (std::size_t i = 0; i < c.getSize(); i++, idx++)
+      EXPECT_EQ(c.getElement(i), ct.getElement(idx));
+  }
+  EXPECT_EQ(idx, num_values);
+
+  // chunks reach the sink in order, with their position
+  std::vector<uint32_t> dt_value(num_values);
+  std::istringstream is(bytes);
+  std::size_t total = ipcl::serializer::deserializeChunked(
+      is, keys.pub_key, [&](std::size_t offset, const ipcl::CipherText& c) {
+        ipcl::PlainText dt = keys.priv_key.decrypt(c);
+        for (std::size_t i = 0; i < dt.getSize(); i++)
+          dt_value[offset + i] = dt.getElementVec(i)[0];
+      });
+  EXPECT_EQ(total, num_values);
+  EXPECT_EQ(dt_value, exp_value);
+
+  // a truncated container is rejected
+  std::istringstream is_short(os.str().substr(0, os.str().size() - 1));
+  EXPECT_THROW(ipcl::serializer::deserializeChunked(
+                   is_short, keys.pub_key,
+                   [](std::size_t, const ipcl::CipherText&) {}),
+               std::runtime_error);
+
+  // a forged frame header does not make the decoder wait for, and allocate,
+  // the whole frame at once
+  std::string forged = os.str().substr(0, ipcl::IPCL_RAW_HEADER_SIZE);
+  forged += std::string("\x00\x00\x10\x00\x00\x00\x00\x00", 8);
+  ipcl::ChunkedDecoder forged_decoder(keys.pub_key);
+  EXPECT_EQ(forged_decoder.feed(forged.data(), forged.size()), forged.size());
+  EXPECT_LT(forged_decoder.getBytesNeeded(),
+            std::size_t(ipcl::IPCL_CHUNKED_MAX_FRAME_SIZE) * sizeof(Ipp32u));
+}
+
+TEST(SerialTest, CipherTextStoreTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+  ipcl::KeyPair keys = ipcl::generateKeypair(SELF_DEF_KEY_SIZE);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, 0xffff);
+
+  std::vector<uint32_t> exp_value1(num_values), exp_value2(num_values);
+  std::for_each(exp_value1.begin(), exp_value1.end(),
+                [&](uint32_t& n) { n = dist(rng); });
+  std::for_each(exp_value2.begin(), exp_value2.end(),
+                [&](uint32_t& n) { n = dist(rng); });
+
+  std::string fn1 = testing::TempDir() + "ipcl_store_1.bin";
+  std::string fn2 = testing::TempDir() + "ipcl_store_2.bin";
+  std::string fn_out = testing::TempDir() + "ipcl_store_out.bin";
+
+  ipcl::CipherText ct1 = keys.pub_key.encrypt(ipcl::PlainText(exp_value1));
+  ASSERT_TRUE(ipcl::serializer::serializeRawToFile(fn1, ct1));
+  {
+    auto st2 = ipcl::CipherTextStore::create(fn2, keys.pub_key, num_values);
+    st2.store(0, keys.pub_key.encrypt(ipcl::PlainText(exp_value2)));
+    st2.flush();
+  }
+
+  auto st1 = ipcl::CipherTextStore::open(fn1, keys.pub_key);
+  auto st2 = ipcl::CipherTextStore::open(fn2, keys.pub_key);
+  ASSERT_EQ(st1.getSize(), num_values);
+  EXPECT_THROW(st1.store(0, ct1), std::runtime_error);
+
+  // odd chunk size to exercise partial chunks
+  const std::size_t chunk = 5;
+  auto out = ipcl::CipherTextStore::create(fn_out, keys.pub_key, num_values);
+  st1.add(st2, out, chunk);
+  out.multiply(ipcl::PlainText(3), out, chunk);
+
+  std::vector<uint64_t> res;
+  out.decrypt(
+      keys.priv_key,
+      [&](std::size_t offset, const ipcl::PlainText& pt) {
+        EXPECT_EQ(offset, res.size());
+        for (std::size_t i = 0; i < pt.getSize(); i++)
+          res.push_back(pt.getElementVec(i)[0]);
+      },
+      chunk);
+
+  uint64_t exp_sum = 0;
+  ASSERT_EQ(res.size(), num_values);
+  for (int i = 0; i < num_values; i++) {
+    uint64_t exp = 3 * ((uint64_t)exp_value1[i] + exp_value2[i]);
+    EXPECT_EQ(res[i], exp);
+    exp_sum += exp;
+  }
+
+  ipcl::PlainText dt_sum = keys.priv_key.decrypt(out.sum(chunk));
+  std::vector<uint32_t> v = dt_sum.getElementVec(0);
+  uint64_t sum = v[0];
+  if (v.size() > 1) sum = ((uint64_t)v[1] << 32) | v[0];
+  EXPECT_EQ(sum, exp_sum);
+
+  std::remove(fn1.c_str());
+  std::remove(fn2.c_str());
+  std::remove(fn_out.c_str());
+}
+
+TEST(SerialTest, CipherTextKeyRefTest) {
+  ipcl::KeyPair keys = ipcl::generateKeypair(SELF_DEF_KEY_SIZE);
+  ipcl::CipherText ct = keys.pub_key.encrypt(ipcl::PlainText(12345));
+
+  std::ostringstream os_embed;
+  ipcl::serializer::serialize(os_embed, ct);
+
+  std::uint64_t fp = ipcl::registerPublicKey(keys.pub_key);
+  EXPECT_EQ(fp, keys.pub_key.getFingerprint());
+  ipcl::serializer::setKeyMode(ipcl::serializer::KeyMode::REFERENCE);
+  std::ostringstream os_ref;
+  ipcl::serializer::serialize(os_ref, ct);
+  ipcl::serializer::setKeyMode(ipcl::serializer::KeyMode::EMBED);
+  EXPECT_LT(os_ref.str().size(), os_embed.str().size());
+
+  // key references resolve to the registered key
+  ipcl::CipherText ct_ref;
+  std::istringstream is_ref(os_ref.str());
+  ipcl::serializer::deserialize(is_ref, ct_ref);
+  EXPECT_EQ(ct_ref.getPubKey(), ipcl::findPublicKey(fp));
+  EXPECT_EQ(keys.priv_key.decrypt(ct_ref).getElementVec(0)[0], 12345);
+
+  ipcl::CipherText ct_embed;
+  std::istringstream is_embed(os_embed.str());
+  ipcl::serializer::deserialize(is_embed, ct_embed);
+  EXPECT_EQ(keys.priv_key.decrypt(ct_embed).getElementVec(0)[0], 12345);
+
+  // unknown keys are rejected
+  EXPECT_TRUE(ipcl::unregisterPublicKey(fp));
+  EXPECT_EQ(ipcl::findPublicKey(fp), nullptr);
+  std::istringstream is_unknown(os_ref.str());
+  EXPECT_THROW(ipcl::serializer::deserialize(is_unknown, ct_ref),
+               std::runtime_error);
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <climits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ipcl/ipcl.hpp"
+
+constexpr int SELF_DEF_NUM_VALUES = 45;
+constexpr int SELF_DEF_CHUNK_SIZE = 10;
+
+TEST(StreamTest, EncryptDecryptTest) {
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+
+  std::vector<uint32_t> exp_value(SELF_DEF_NUM_VALUES);
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+  for (auto& v : exp_value) v = dist(rng);
+
+  ipcl::StreamOptions options;
+  options.chunk_size = SELF_DEF_CHUNK_SIZE;  // rounded up to 16
+  options.max_in_flight = 1;
+
+  std::vector<BigNumber> ct_bn;
+  auto reader = ipcl::makeBigNumberReader(exp_value.begin(), exp_value.end());
+  std::size_t enc_count = ipcl::encryptStream(
+      key.pub_key, reader,
+      [&](std::size_t offset, const ipcl::CipherText& ct) {
+        EXPECT_EQ(offset, ct_bn.size());
+        EXPECT_LE(ct.getSize(), 16);
+        auto texts = ct.getTexts();
+        ct_bn.insert(ct_bn.end(), texts.begin(), texts.end());
+      },
+      options);
+  EXPECT_EQ(enc_count, SELF_DEF_NUM_VALUES);
+  ASSERT_EQ(ct_bn.size(), SELF_DEF_NUM_VALUES);
+
+  std::vector<uint32_t> dt_value;
+  std::size_t dec_count = ipcl::decryptStream(
+      key.priv_key, key.pub_key,
+      ipcl::makeBigNumberReader(ct_bn.begin(), ct_bn.end()),
+      [&](std::size_t offset, const ipcl::PlainText& pt) {
+        EXPECT_EQ(offset, dt_value.size());
+        for (std::size_t i = 0; i < pt.getSize(); i++)
+          dt_value.push_back(pt.getElementVec(i)[0]);
+      },
+      options);
+  EXPECT_EQ(dec_count, SELF_DEF_NUM_VALUES);
+  EXPECT_EQ(dt_value, exp_value);
+}
+
+TEST(StreamTest, ErrorTest) {
+  ipcl::KeyPair key = ipcl::generateKeypair(1024, true);
+  std::vector<uint32_t> values(SELF_DEF_NUM_VALUES, 1);
+
+  ipcl::StreamOptions options;
+  options.chunk_size = 8;
+
+  // sink failure stops the pipeline and is rethrown
+  std::size_t calls = 0;
+  EXPECT_THROW(ipcl::encryptStream(
+                   key.pub_key,
+                   ipcl::makeBigNumberReader(values.begin(), values.end()),
+                   [&](std::size_t, const ipcl::CipherText&) {
+                     if (++calls == 2) throw std::runtime_error("sink");
+                   },
+                   options),
+               std::runtime_error);
+  EXPECT_EQ(calls, 2);
+
+  // reader failure
+  EXPECT_THROW(
+      ipcl::encryptStream(
+          key.pub_key,
+          [](std::vector<BigNumber>&, std::size_t) -> std::size_t {
+            throw std::runtime_error("reader");
+          },
+          [](std::size_t, const ipcl::CipherText&) {}, options),
+      std::runtime_error);
+}
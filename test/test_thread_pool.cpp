@@ -0,0 +1,156 @@
+// Copyright (C) 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <climits>
+#include <random>
+#include <stdexcept>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ipcl/ipcl.hpp"
+
+constexpr int SELF_DEF_NUM_VALUES = 14;
+constexpr int SELF_DEF_NUM_CALLERS = 4;
+
+TEST(ThreadPoolTest, ParallelForTest) {
+  const std::size_t size = 1000;
+  std::vector<int> hits(size, 0);
+
+  ipcl::ThreadPool pool(3);
+  EXPECT_EQ(pool.getNumWorkers(), 3);
+
+  for (std::size_t grain : {1, 7, 64, 2000}) {
+    std::fill(hits.begin(), hits.end(), 0);
+    pool.parallelFor(
+        size,
+        [&](std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; i++) hits[i]++;
+        },
+        grain);
+    for (std::size_t i = 0; i < size; i++) EXPECT_EQ(hits[i], 1);
+  }
+}
+
+TEST(ThreadPoolTest, ConcurrencyLimitTest) {
+  ipcl::ThreadPool pool(3);
+  std::atomic<int> active(0), peak(0);
+
+  pool.parallelFor(
+      64,
+      [&](std::size_t begin, std::size_t end) {
+        int now = ++active;
+        int prev = peak.load();
+        while (now > prev && !peak.compare_exchange_weak(prev, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        active--;
+      },
+      1, 2);
+  EXPECT_LE(peak.load(), 2);
+}
+
+TEST(ThreadPoolTest, NestedAndExceptionTest) {
+  ipcl::ThreadPool pool(2);
+  std::atomic<int> count(0);
+
+  pool.parallelFor(8, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      pool.parallelFor(8, [&](std::size_t b, std::size_t e) {
+        count += static_cast<int>(e - b);
+      });
+  });
+  EXPECT_EQ(count.load(), 64);
+
+  EXPECT_THROW(pool.parallelFor(16,
+                                [](std::size_t begin, std::size_t end) {
+                                  if (begin == 5)
+                                    throw std::runtime_error("chunk error");
+                                }),
+               std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NodeGroupsTest) {
+  const std::size_t size = 1000;
+  std::vector<int> hits(size, 0);
+
+  // two worker groups, unbound so the test runs on any machine
+  ipcl::ThreadPool pool(std::vector<std::size_t>{2, 2}, false);
+  EXPECT_EQ(pool.getNumWorkers(), 4);
+  EXPECT_EQ(pool.getNumGroups(), 2);
+
+  pool.parallelFor(
+      size,
+      [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) hits[i]++;
+      },
+      8);
+  for (std::size_t i = 0; i < size; i++) EXPECT_EQ(hits[i], 1);
+
+  auto slices = ipcl::partitionByNode(size, 3, 8);
+  EXPECT_EQ(slices.front().first, 0);
+  EXPECT_EQ(slices.back().second, size);
+  for (std::size_t i = 1; i < slices.size(); i++) {
+    EXPECT_EQ(slices[i].first, slices[i - 1].second);
+    EXPECT_EQ(slices[i].first % 8, 0);
+  }
+}
+
+TEST(ThreadPoolTest, TopologyTest) {
+  const auto& topo = ipcl::getCPUTopology();
+  ASSERT_GE(topo.nodes.size(), 1);
+  EXPECT_GE(topo.n_processors, topo.n_cores);
+  EXPECT_GE(topo.n_cores, 1);
+  for (const auto& node : topo.nodes) {
+    EXPECT_FALSE(node.cpus.empty());
+    EXPECT_FALSE(node.primary_cpus.empty());
+  }
+
+  int node = ipcl::getCurrentNode();
+  EXPECT_GE(node, 0);
+  EXPECT_LT(node, static_cast<int>(topo.nodes.size()));
+
+  std::vector<uint64_t, ipcl::NodeLocalAllocator<uint64_t>> buff(
+      8192, 1, ipcl::NodeLocalAllocator<uint64_t>(node));
+  EXPECT_EQ(buff[8191], 1);
+
+  // sysfs lists, malformed ones are rejected as a whole
+  EXPECT_EQ(ipcl::parseCPUList("0-3,8\n"), std::vector<int>({0, 1, 2, 3, 8}));
+  EXPECT_TRUE(ipcl::parseCPUList("").empty());
+  for (const char* list : {"x", "0-", "2-1", "0,a-3", "1 2", "0-99999999"})
+    EXPECT_TRUE(ipcl::parseCPUList(list).empty()) << list;
+}
+
+TEST(ThreadPoolTest, ExternalCallersTest) {
+  const uint32_t num_values = SELF_DEF_NUM_VALUES;
+
+  ipcl::KeyPair key = ipcl::generateKeypair(2048, true);
+
+  std::random_device dev;
+  std::mt19937 rng(dev());
+  std::uniform_int_distribution<std::mt19937::result_type> dist(0, UINT_MAX);
+
+  std::vector<std::vector<uint32_t>> exp_value(
+      SELF_DEF_NUM_CALLERS, std::vector<uint32_t>(num_values));
+  for (auto& v : exp_value)
+    for (auto& x : v) x = dist(rng);
+
+  std::vector<ipcl::PlainText> dt(SELF_DEF_NUM_CALLERS);
+  std::vector<std::thread> callers;
+  for (int t = 0; t < SELF_DEF_NUM_CALLERS; t++) {
+    callers.emplace_back([&, t] {
+      ipcl::PlainText pt(exp_value[t]);
+      ipcl::CipherText ct = key.pub_key.encrypt(pt);
+      dt[t] = key.priv_key.decrypt(ct + ct);
+    });
+  }
+  for (auto& caller : callers) caller.join();
+
+  for (int t = 0; t < SELF_DEF_NUM_CALLERS; t++) {
+    for (int i = 0; i < num_values; i++) {
+      BigNumber expected = BigNumber(exp_value[t][i]) + exp_value[t][i];
+      EXPECT_EQ(dt[t].getElement(i), expected);
+    }
+  }
+}